@@ -1,9 +1,30 @@
 PRJTYPE = Executable
 DEFINES = _SCL_SECURE_NO_WARNINGS
 LIBS = assetloader vorbis ogg freetype openal tiff png glfw glad assimp jpeg
+TESTDEPSRC = \
+	deps/Glad/src/glad.c \
+	src/Asset/Material/Material.cpp \
+	src/Core/JobSystem.cpp \
+	src/Core/Profiler.cpp \
+	src/Graphics/Renderer/GLStateCache.cpp \
+	src/Graphics/Renderer/RenderStats.cpp \
+	src/Graphics/Resource/GeometryArena.cpp \
+	src/Graphics/Resource/MaterialStore.cpp \
+	src/Graphics/Resource/ModelStore.cpp \
+	src/Graphics/Scene/AABB.cpp \
+	src/Graphics/Scene/AABBTransform.cpp \
+	src/Graphics/Scene/AABBTree.cpp \
+	src/Graphics/Scene/Frustum.cpp \
+	src/Graphics/Scene/RenderformCreator.cpp \
+	src/Graphics/Scene/Scene.cpp \
+	src/Graphics/Scene/SceneNode.cpp \
+	src/Graphics/Scene/TransformHierarchy.cpp \
+	src/Util/RangeAllocator.cpp \
+	src/Util/Timer.cpp
 ifeq ($(OS), Windows_NT)
 	LIBS += zlib rpcrt4 winmm opengl32 glu32 ole32 gdi32 advapi32 user32 shell32
 	DEFINES += _CRT_SECURE_NO_WARNINGS _CRT_SECURE_NO_DEPRECATE
 else
 	LIBS += z uuid GLU GL X11 Xcursor Xinerama Xrandr Xxf86vm Xi pthread dl
+	TESTLIBS = pthread dl
 endif
@@ -1,16 +1,26 @@
 #version 330
+#include gbuffer
+#include material_data
 
+#ifdef GBUFFER_COMPACT
+layout (location = 1) out vec2 gNormal;
+layout (location = 2) out vec4 gAlbedoSpec;
+layout (location = 3) out vec4 gMaterial;
+#else
 layout (location = 0) out vec3 gPosition;
 layout (location = 1) out vec3 gNormal;
 layout (location = 2) out vec4 gAlbedoSpec;
 layout (location = 3) out uint gMatIdx;
+#endif
 
 in VS_OUT
 {
     vec3 FragPos;
     vec3 Normal;
     vec2 UVCoords;
+#ifdef NORMAL_MAP
     mat3 TBN;
+#endif
 } fsIn;
 
 struct Material
@@ -21,26 +31,32 @@ struct Material
 
 uniform Material material;
 
+#ifdef NORMAL_MAP
 uniform sampler2D normalMap;
-uniform bool useNormalMaps;
+#endif
 uniform uint matIdx;
 
 void main(void)
 {
+    // Find the per-fragment normal
+#ifdef NORMAL_MAP
+    vec3 normal = texture(normalMap, fsIn.UVCoords).rgb;
+    normal = normalize(normal * 2.0 - 1.0);
+    normal = normalize(fsIn.TBN * normal);
+#else
+    vec3 normal = normalize(fsIn.Normal);
+#endif
+
+#ifdef GBUFFER_COMPACT
+    // The position is reconstructed from the depth buffer, and the normal is octahedral encoded
+    gNormal = EncodeNormal(normal);
+#else
     // Store the fragment position vector in the first gbuffer texture
     gPosition = fsIn.FragPos;
 
     // Also store the per-fragment normals into the gbuffer
-    if(useNormalMaps)
-    {
-        gNormal = texture(normalMap, fsIn.UVCoords).rgb;
-        gNormal = normalize(gNormal * 2.0 - 1.0);
-        gNormal = normalize(fsIn.TBN * gNormal);
-    }
-    else
-    {
-        gNormal = normalize(fsIn.Normal);
-    }
+    gNormal = normal;
+#endif
 
     // And the diffuse per-fragment color
     gAlbedoSpec.rgb = texture(material.diffuseTexture, fsIn.UVCoords).rgb;
@@ -48,7 +64,12 @@ void main(void)
     // Store specular intensity in gAlbedoSpec's alpha component
     gAlbedoSpec.a = texture(material.specularTexture, fsIn.UVCoords).r;
 
+#ifdef GBUFFER_COMPACT
+    // Store the material index with its roughness and metallic factors
+    gMaterial = PackMaterial(matIdx, materialProps[matIdx].roughness, materialProps[matIdx].metallic);
+#else
     // Store the material index
     gMatIdx = matIdx;
+#endif
 }
 
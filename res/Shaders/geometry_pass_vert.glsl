@@ -4,13 +4,16 @@ layout (location = 0) in vec3 position;
 layout (location = 1) in vec3 normal;
 layout (location = 2) in vec2 uvCoords;
 layout (location = 3) in vec3 tangent;
+layout (location = 4) in mat4 model;
 
 out VS_OUT
 {
     vec3 FragPos;
     vec3 Normal;
     vec2 UVCoords;
+#ifdef NORMAL_MAP
     mat3 TBN;
+#endif
 } vsOut;
 
 // On 420 version and later:
@@ -21,8 +24,6 @@ layout (std140) uniform Matrices
     mat4 view;
 };
 
-uniform mat4 model;
-
 void main(void)
 {
     vsOut.UVCoords = uvCoords;
@@ -30,6 +31,7 @@ void main(void)
     mat3 normalMatrix = mat3(transpose(inverse(model)));
     vsOut.Normal = normalMatrix * normal;
 
+#ifdef NORMAL_MAP
     // Calcullate TBN
     vec3 T = normalize(vec3(model * vec4(tangent,   0.0)));
     vec3 N = normalize(vec3(model * vec4(normal,    0.0)));
@@ -42,6 +44,7 @@ void main(void)
 
     // Generate TBN matrix
     vsOut.TBN = mat3(T, B, N);
+#endif
 
     vec4 worldPos = model * vec4(position, 1.0f);
     vsOut.FragPos = worldPos.xyz;
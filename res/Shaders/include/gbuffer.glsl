@@ -0,0 +1,44 @@
+#module gbuffer
+// --------------------------------------------------
+// Compact GBuffer packing
+// --------------------------------------------------
+// Octahedral normal encoding, maps the unit sphere to [0, 1]^2
+vec2 OctWrap(vec2 v)
+{
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec2 EncodeNormal(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    n.xy = n.z >= 0.0 ? n.xy : OctWrap(n.xy);
+    return n.xy * 0.5 + 0.5;
+}
+
+vec3 DecodeNormal(vec2 e)
+{
+    e = e * 2.0 - 1.0;
+    vec3 n = vec3(e.x, e.y, 1.0 - abs(e.x) - abs(e.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+// The material index takes 8 bits next to the roughness and metallic factors
+vec4 PackMaterial(uint idx, float roughness, float metallic)
+{
+    return vec4(float(idx) / 255.0, roughness, metallic, 0.0);
+}
+
+uint UnpackMaterialIndex(vec4 m)
+{
+    return uint(m.r * 255.0 + 0.5);
+}
+
+// World position of the fragment at the given screen coordinates and depth buffer value
+vec3 ReconstructPosition(vec2 uv, float depth, mat4 invViewProj)
+{
+    vec4 pos = invViewProj * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+    return pos.xyz / pos.w;
+}
@@ -0,0 +1,17 @@
+#module material_data
+struct MaterialProperties
+{
+    float roughness;
+    float fresnel;
+    float metallic;
+    float transparency;
+    vec3  diffCol;
+    vec3  specCol;
+    vec3  emissiveCol;
+};
+
+// UBO holding the material data
+layout (std140) uniform MaterialDataBlock
+{
+    MaterialProperties materialProps[64];
+};
@@ -1,45 +1,95 @@
 #version 330
 #include lighting
 #include shadowing
+#include gbuffer
+#include material_data
 out vec4 color;
 
 // GBuffer data
+#ifdef GBUFFER_COMPACT
+uniform sampler2D gDepth;
+uniform sampler2D gNormal;
+uniform sampler2D gAlbedoSpec;
+uniform sampler2D gMaterial;
+uniform mat4 invViewProj;
+#else
 uniform sampler2D gPosition;
 uniform sampler2D gNormal;
 uniform sampler2D gAlbedoSpec;
 uniform usampler2D gMatIdx;
+#endif
 uniform ivec2 gScreenSize;
 uniform vec3 viewPos;
 
-// Shadows
+uniform mat4 viewMat;
+
+#ifdef COMPOSITE
+// The light all the passes accumulated
+uniform sampler2D gFinal;
+#endif
+
+// The variant computes the light of its LIGHT_* define
+#ifdef SHADOWS
 uniform sampler2DArray uShadowMap;
 uniform float uCascadesNear[4];
 uniform float uCascadesFar[4];
 uniform vec2 uCascadesPlanes[4];
 uniform mat4 uCascadesMatrices[4];
-uniform mat4 viewMat;
+#endif
 
 // Lights
+#ifdef LIGHT_POINT
 uniform PointLight pLight;
+#endif
+#ifdef LIGHT_DIR
 uniform DirLight dirLight;
-uniform int lMode;
-
-struct MaterialProperties
-{
-    float roughness;
-    float fresnel;
-    float metallic;
-    float transparency;
-    vec3  diffCol;
-    vec3  specCol;
-    vec3  emissiveCol;
-};
-
-// UBO holding the material data
-layout (std140) uniform MaterialDataBlock
+#endif
+
+#ifdef LIGHT_CLUSTERED
+// Clustered point lights
+uniform usamplerBuffer uClusters;     // Light index list offset and count of each cluster
+uniform usamplerBuffer uLightIndices; // Light indices of all the clusters
+uniform samplerBuffer uLightData;     // Position and radius, color and constant, linear and quadratic terms
+uniform ivec3 uClusterGrid;
+uniform vec2 uClusterDepthParams;     // slice = log(depth) * x - y
+#endif
+
+#ifdef LIGHT_CLUSTERED
+// --------------------------------------------------
+// Clustered lighting
+// --------------------------------------------------
+// Accumulates the contribution of all the point lights in the fragment's cluster
+vec3 CalcClusteredPointLights(vec3 norm, vec3 fragPos, float viewDepth, vec3 viewDir, Material material)
 {
-    MaterialProperties materialProps[64];
-};
+    // Find the fragment's cluster
+    ivec2 tile = ivec2(gl_FragCoord.xy * vec2(uClusterGrid.xy) / vec2(gScreenSize));
+    int slice = int(max(log(viewDepth) * uClusterDepthParams.x - uClusterDepthParams.y, 0.0));
+    tile = min(tile, uClusterGrid.xy - 1);
+    slice = min(slice, uClusterGrid.z - 1);
+    int clusterIdx = tile.x + uClusterGrid.x * (tile.y + uClusterGrid.y * slice);
+    uvec2 cluster = texelFetch(uClusters, clusterIdx).rg;
+
+    vec3 result = vec3(0.0);
+    for (uint i = 0u; i < cluster.y; ++i)
+    {
+        int lightIdx = int(texelFetch(uLightIndices, int(cluster.x + i)).r);
+        vec4 posRadius = texelFetch(uLightData, 3 * lightIdx);
+        if (distance(posRadius.xyz, fragPos) > posRadius.w)
+            continue;
+        vec4 colorConstant = texelFetch(uLightData, 3 * lightIdx + 1);
+        vec4 linearQuadratic = texelFetch(uLightData, 3 * lightIdx + 2);
+
+        PointLight light;
+        light.position = posRadius.xyz;
+        light.color = colorConstant.rgb;
+        light.attProps.constant = colorConstant.a;
+        light.attProps.linear = linearQuadratic.x;
+        light.attProps.quadratic = linearQuadratic.y;
+        result += CalcPointLight(light, norm, fragPos, viewDir, material);
+    }
+    return result;
+}
+#endif
 
 // --------------------------------------------------
 // Main section
@@ -48,20 +98,36 @@ void main(void)
 {
     // Retrieve data from GBuffer
     vec2 UVCoords = gl_FragCoord.xy / gScreenSize;
+#ifdef COMPOSITE
+    // Apply gamma correction once, to the sum of the light passes
+    float gamma = 1.2;
+    color = vec4(pow(texture(gFinal, UVCoords).rgb, vec3(1.0 / gamma)), 1.0);
+    return;
+#endif
+#ifdef GBUFFER_COMPACT
+    vec3 FragPos = ReconstructPosition(UVCoords, texture(gDepth, UVCoords).r, invViewProj);
+    vec3 Normal = DecodeNormal(texture(gNormal, UVCoords).rg);
+    vec4 MatData = texture(gMaterial, UVCoords);
+    uint MatIdx = UnpackMaterialIndex(MatData);
+    float Roughness = MatData.g;
+    float Metallic = MatData.b;
+#else
     vec3 FragPos = texture(gPosition, UVCoords).rgb;
     vec3 Normal = texture(gNormal, UVCoords).rgb;
-    vec3 Diffuse = texture(gAlbedoSpec, UVCoords).rgb;
-    float Specular = texture(gAlbedoSpec, UVCoords).a;
     uint MatIdx = texture(gMatIdx, UVCoords).r;
+    float Roughness = materialProps[MatIdx].roughness;
+    float Metallic = materialProps[MatIdx].metallic;
+#endif
+    vec4 AlbedoSpec = texture(gAlbedoSpec, UVCoords);
 
     // Fill material struct
     Material material;
-    material.diffuse   = materialProps[MatIdx].diffCol + Diffuse;
-    material.specular  = materialProps[MatIdx].specCol + vec3(Specular);
+    material.diffuse   = materialProps[MatIdx].diffCol + AlbedoSpec.rgb;
+    material.specular  = materialProps[MatIdx].specCol + vec3(AlbedoSpec.a);
     material.emissive  = materialProps[MatIdx].emissiveCol;
-    material.roughness = materialProps[MatIdx].roughness;
+    material.roughness = Roughness;
     material.fresnel   = materialProps[MatIdx].fresnel;
-    material.metallic  = materialProps[MatIdx].metallic;
+    material.metallic  = Metallic;
     material.transparency = materialProps[MatIdx].transparency;
 
     // Properties
@@ -72,35 +138,40 @@ void main(void)
     vec4 vVsPos = viewMat * vec4(FragPos, 1.0);
 
     // Calculate fragment shadow coefficient
+#ifdef SHADOWS
     float shadow = CalcShadowCoef(uShadowMap, FragPos, vVsPos.xyz, uCascadesMatrices, uCascadesNear, uCascadesFar, uCascadesPlanes);
+#else
+    float shadow = 0.0;
+#endif
 
     // Empty result
     vec3 result = vec3(0.0);
 
-    if (lMode == 1)
-        result += CalcDirLight(dirLight, norm, viewDir, material, shadow);
-    else if (lMode == 2)
-        result += CalcPointLight(pLight, norm, FragPos, viewDir, material);
-    else if (lMode == 3)
-        result += CalcEnvLight(norm, FragPos, viewDir, material);
-        //result += vec3(0.0);
+#ifdef LIGHT_DIR
+    result += CalcDirLight(dirLight, norm, viewDir, material, shadow);
+#endif
+#ifdef LIGHT_POINT
+    result += CalcPointLight(pLight, norm, FragPos, viewDir, material);
+#endif
+#ifdef LIGHT_AMBIENT
+    result += CalcEnvLight(norm, FragPos, viewDir, material);
+#endif
+#ifdef LIGHT_CLUSTERED
+    result += CalcClusteredPointLights(norm, FragPos, -vVsPos.z, viewDir, material);
+#endif
 
     // result += CalcSpotLight(spotLight, norm, FragPos, viewDir, material);
 
+    // Light adds up linearly, the composite pass gamma corrects the sum
     color = vec4(result, 1.0);
 
-    // Apply gamma correction
-    float gamma = 1.2;
-    color.rgb = pow(color.rgb, vec3(1.0 / gamma));
-
     // Debug shadow splits
-    //if (lMode == 1)
-    //{
-    //    vec4 cascadeWeights = GetCascadeWeights(
-    //        -vVsPos.z,
-    //        vec4(uCascadesPlanes[0].x, uCascadesPlanes[1].x, uCascadesPlanes[2].x, uCascadesPlanes[3].x),
-    //        vec4(uCascadesPlanes[0].y, uCascadesPlanes[1].y, uCascadesPlanes[2].y, uCascadesPlanes[3].y)
-    //    );
-    //    color.rgb = color.rgb * GetCascadeColor(cascadeWeights);
-    //}
+    //#ifdef SHADOWS
+    //vec4 cascadeWeights = GetCascadeWeights(
+    //    -vVsPos.z,
+    //    vec4(uCascadesPlanes[0].x, uCascadesPlanes[1].x, uCascadesPlanes[2].x, uCascadesPlanes[3].x),
+    //    vec4(uCascadesPlanes[0].y, uCascadesPlanes[1].y, uCascadesPlanes[2].y, uCascadesPlanes[3].y)
+    //);
+    //color.rgb = color.rgb * GetCascadeColor(cascadeWeights);
+    //#endif
 }
@@ -1,6 +1,7 @@
 #include "Font.hpp"
 #include <ft2build.h>
 #include <freetype/freetype.h>
+#include "../../Graphics/Renderer/GLStateCache.hpp"
 
 Font::Font()
     : mPixelHeight(28)
@@ -39,7 +40,7 @@ auto Font::Load(const BufferType& fontData) -> void
 
         GLuint texture;
         glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
+        GLState().BindTexture(GL_TEXTURE_2D, texture);
         glTexImage2D(
             GL_TEXTURE_2D,
             0,
@@ -55,7 +56,7 @@ auto Font::Load(const BufferType& fontData) -> void
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        GLState().BindTexture(GL_TEXTURE_2D, 0);
 
         Glyph glyph = {
             texture,
@@ -90,7 +91,7 @@ int Font::GetPixelHeight() const
 void Font::Destroy()
 {
     for (const auto& g : mGlyphs)
-        glDeleteTextures(1, &g.second.texId);
+        GLState().DeleteTextures(1, &g.second.texId);
     mGlyphs.clear();
 }
 
@@ -5,6 +5,8 @@
 #include "../Graphics/Shader/ShaderPreprocessor.hpp"
 #include "../Util/Hash.hpp"
 #include "../Util/MsgBox.hpp"
+#include "../Graphics/Renderer/GLStateCache.hpp"
+#include "Profiler.hpp"
 
 WARN_GUARD_ON
 #include <glm/gtc/matrix_transform.hpp>
@@ -13,7 +15,7 @@ WARN_GUARD_OFF
 // BufferType for the files loaded
 using BufferType = std::vector<std::uint8_t>;
 
-static std::unordered_map<std::string, ShaderProgram> LoadShaders()
+static std::unique_ptr<Renderer::ShaderPrograms> LoadShaders(const std::vector<std::string>& defines)
 {
     // Load the shader files
     std::vector<std::string> shaderFiles =
@@ -29,6 +31,8 @@ static std::unordered_map<std::string, ShaderProgram> LoadShaders()
       , "res/Shaders/include/material.glsl"
       , "res/Shaders/include/brdf.glsl"
       , "res/Shaders/include/math.glsl"
+      , "res/Shaders/include/gbuffer.glsl"
+      , "res/Shaders/include/material_data.glsl"
     };
 
     std::unordered_map<std::string, std::string> loadedShaders;
@@ -54,67 +58,64 @@ static std::unordered_map<std::string, ShaderProgram> LoadShaders()
     for (auto& shs : loadedShaders)
         shs.second = shaderPreprocessor.Preprocess(shs.second, deps);
 
-    // The shader map
-    std::unordered_map<std::string, std::vector<std::pair<Shader::Type, std::string>>> shadersLoc =
-    {
+    // Build the variants of each program on demand, with the defines of their features
+    std::unique_ptr<Renderer::ShaderPrograms> shaderPrograms = std::make_unique<Renderer::ShaderPrograms>(
+        Renderer::ShaderPrograms
         {
-            "geometry_pass",
-            {
-                { Shader::Type::Vertex,   "res/Shaders/geometry_pass_vert.glsl" },
-                { Shader::Type::Fragment, "res/Shaders/geometry_pass_frag.glsl" },
-            }
-        },
-        {
-            "light_pass",
-            {
-                { Shader::Type::Vertex,   "res/Shaders/light_pass_vert.glsl" },
-                { Shader::Type::Fragment, "res/Shaders/light_pass_frag.glsl" },
-            }
+            ShaderVariants(
+                loadedShaders["res/Shaders/geometry_pass_vert.glsl"],
+                loadedShaders["res/Shaders/geometry_pass_frag.glsl"],
+                Renderer::GeometryPassDefines(),
+                defines
+            ),
+            ShaderVariants(
+                loadedShaders["res/Shaders/light_pass_vert.glsl"],
+                loadedShaders["res/Shaders/light_pass_frag.glsl"],
+                Renderer::LightPassDefines(),
+                defines
+            )
         }
-    };
-
-    // Load shaders
-    std::unordered_map<std::string, ShaderProgram> shaderPrograms;
-    for (const auto& p : shadersLoc)
-    {
-        // Will temporarily store the the compiled shaders
-        std::unordered_map<Shader::Type, Shader> shaders;
-        for (const auto& f : p.second)
-        {
-            // Get the source
-            std::string shaderSrc = loadedShaders[f.second];
+    );
+    return shaderPrograms;
+}
 
-            // Create shader from source
-            Shader shader(shaderSrc, f.first);
+Engine::Engine()
+    : mConsoleIsActive(false)
+    , mHeadless(false)
+    , mGBufferLayout(GBuffer::Layout::Full)
+{
+}
 
-            // Insert loaded shader id to temp map
-            shaders.emplace(f.first, std::move(shader));
-        }
+void Engine::SetHeadless(bool headless)
+{
+    mHeadless = headless;
+}
 
-        // Fetch vert and frag shader id's from temp map and link
-        ShaderProgram program(
-            shaders.at(Shader::Type::Vertex).Id(),
-            shaders.at(Shader::Type::Fragment).Id()
-        );
-        shaderPrograms.emplace(p.first, std::move(program));
-    }
-    return shaderPrograms;
+void Engine::SetGBufferLayout(GBuffer::Layout layout)
+{
+    mGBufferLayout = layout;
 }
 
 void Engine::Init()
 {
+    // Start a worker for every hardware thread besides this one
+    mJobSystem.Init(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+
     // Setup window
-    bool success = mWindow.Create(800, 600, "TheRoom", Window::Mode::Windowed);
+    bool success = mWindow.Create(800, 600, "TheRoom", mHeadless ? Window::Mode::Headless : Window::Mode::Windowed);
     if (!success)
         throw std::runtime_error(GetLastGlfwError().GetDescription());
 
+    // Without a visible window the frames are rendered to the window's offscreen target
+    GLState().SetDefaultFramebuffer(mWindow.GetFramebuffer());
+
     mWindow.SetShowStats(true);
     mWindow.SetFramebufferResizeHandler(
         [this](int w, int h)
         {
             if (w == 0 && h == 0)
                 return;
-            glViewport(0, 0, w, h);
+            GLState().Viewport(0, 0, w, h);
             mRenderer.Resize(w, h);
             mTextRenderer.Resize(w, h);
             mDbgRenderer.SetWindowDimensions(w, h);
@@ -161,27 +162,22 @@ void Engine::Init()
     );
     mWindow.SetCharEnterHandler([](char){});
 
-    // Load the needed shaders
-    std::unordered_map<std::string, ShaderProgram> shdrProgs = LoadShaders();
-
-    // Initialize the renderer
+    // Initialize the renderer with the needed shaders
+    mRenderer.SetGBufferLayout(mGBufferLayout);
     mRenderer.Init(
         mWindow.GetWidth(),
         mWindow.GetHeight(),
-        std::make_unique<Renderer::ShaderPrograms>(
-            Renderer::ShaderPrograms
-            {
-                std::move(shdrProgs.at("geometry_pass")),
-                std::move(shdrProgs.at("light_pass"))
-            }
-        )
+        LoadShaders(ShaderDefines())
     );
 
+    mTickProjection = mRenderer.GetProjection();
+
     // Pass the data store instances to renderer
     mRenderer.SetDataStores(&mMaterialStore);
+    mRenderer.SetJobSystem(&mJobSystem);
 
     // Initialize the AABBRenderer
-    mAABBRenderer.Init();
+    mAABBRenderer.Init(&mRenderer.GetPrimitives());
     mAABBRenderer.SetProjection(
         glm::perspective(
             45.0f,
@@ -199,12 +195,13 @@ void Engine::Init()
     // Initialize the DebugRenderer
     mDbgRenderer.Init(
         mWindow.GetWidth(),
-        mWindow.GetHeight()
+        mWindow.GetHeight(),
+        &mRenderer.GetPrimitives()
     );
     mDbgRenderer.SetDebugTextures(mRenderer.GetTextureTargets());
 
     // Initialize the ConsoleRenderer
-    mConsoleRenderer.Init(&mTextRenderer);
+    mConsoleRenderer.Init(&mTextRenderer, &mRenderer.GetPrimitives());
 
     // Initialize the SkyboxRenderer
     mSkyboxRenderer.Init();
@@ -214,16 +211,7 @@ void Engine::ReloadShaders()
 {
     try
     {
-        std::unordered_map<std::string, ShaderProgram> shdrProgs = LoadShaders();
-        mRenderer.SetShaderPrograms(
-            std::make_unique<Renderer::ShaderPrograms>(
-                Renderer::ShaderPrograms
-                {
-                    std::move(shdrProgs.at("geometry_pass")),
-                    std::move(shdrProgs.at("light_pass"))
-                }
-            )
-        );
+        mRenderer.SetShaderPrograms(LoadShaders(ShaderDefines()));
     }
     catch(const std::runtime_error& e)
     {
@@ -231,9 +219,28 @@ void Engine::ReloadShaders()
     }
 }
 
-void Engine::Update(float dt)
+std::vector<std::string> Engine::ShaderDefines() const
+{
+    std::vector<std::string> defines;
+    if (mGBufferLayout == GBuffer::Layout::Compact)
+        defines.push_back("GBUFFER_COMPACT");
+    return defines;
+}
+
+void Engine::PollEvents()
 {
     // Poll window events
+    mWindow.PollEvents();
+}
+
+void Engine::UpdateTickProjection()
+{
+    mTickProjection = mRenderer.GetProjection();
+}
+
+void Engine::Update(float dt)
+{
+    // Latch the input polled since the last update
     mWindow.Update();
 
     // Update the interpolation state of the world
@@ -248,6 +255,7 @@ void Engine::Render(float interpolation)
         mConsoleRenderer.Render(mConsole, mWindow.GetWidth(), mWindow.GetHeight());
 
     // Show rendered backbuffer
+    PROFILE_SCOPE("Present");
     mWindow.SwapBuffers();
 }
 
@@ -285,6 +293,9 @@ void Engine::Shutdown()
 
     // Window
     mWindow.Destroy();
+
+    // JobSystem
+    mJobSystem.Shutdown();
 }
 
 Window& Engine::GetWindow()
@@ -297,6 +308,11 @@ Console& Engine::GetConsole()
     return mConsole;
 }
 
+JobSystem& Engine::GetJobSystem()
+{
+    return mJobSystem;
+}
+
 ModelStore& Engine::GetModelStore()
 {
     return mModelStore;
@@ -322,6 +338,11 @@ Renderer& Engine::GetRenderer()
     return mRenderer;
 }
 
+const glm::mat4& Engine::GetTickProjection() const
+{
+    return mTickProjection;
+}
+
 AABBRenderer& Engine::GetAABBRenderer()
 {
     return mAABBRenderer;
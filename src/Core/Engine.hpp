@@ -32,6 +32,7 @@
 #define _ENGINE_HPP_
 
 #include "Console.hpp"
+#include "JobSystem.hpp"
 #include "../Window/Window.hpp"
 #include "../Graphics/Resource/CubemapStore.hpp"
 #include "../Graphics/Resource/TextureStore.hpp"
@@ -47,8 +48,22 @@
 class Engine
 {
     public:
+        /*! Constructor */
+        Engine();
+
+        /*! Makes Init create an invisible window that renders offscreen, must be set before Init */
+        void SetHeadless(bool headless);
+
+        /*! Sets the GBuffer layout the renderer and its shaders use, must be set before Init */
+        void SetGBufferLayout(GBuffer::Layout layout);
+
         /*! Initializes all the low level modules of the game */
         void Init();
+        /*! Polls the window events, must be called from the main thread */
+        void PollEvents();
+        /*! Copies the renderer's projection, which a resize may have changed, to the one the ticks cull with.
+            Must be called while no tick is running */
+        void UpdateTickProjection();
         /*! Called when updating the game state */
         void Update(float dt);
         /*! Called when rendering the current frame */
@@ -60,6 +75,8 @@ class Engine
         Window& GetWindow();
         // Retrieves the console instance
         Console& GetConsole();
+        // Retrieves the job system instance
+        JobSystem& GetJobSystem();
 
         // Retrieves the ModelStore instance
         ModelStore& GetModelStore();
@@ -72,6 +89,8 @@ class Engine
 
         // Retrieves the renderer instance
         Renderer& GetRenderer();
+        // Retrieves the projection the ticks cull with, the simulation must not read the renderer's
+        const glm::mat4& GetTickProjection() const;
         // Retrieves the AABB renderer instance
         AABBRenderer& GetAABBRenderer();
         // Retrieves the text renderer instance
@@ -85,12 +104,19 @@ class Engine
         void ReloadShaders();
 
     private:
+        // Retrieves the defines the shaders are compiled with
+        std::vector<std::string> ShaderDefines() const;
+
         // The interactive console instance
         Console mConsole;
         bool mConsoleIsActive;
 
         // The Game Window
         Window mWindow;
+        bool mHeadless;
+
+        // Runs the parallel parts of the scene update and the rendering
+        JobSystem mJobSystem;
 
         // Stores the geometry data loaded in the gpu
         ModelStore mModelStore;
@@ -103,6 +129,9 @@ class Engine
 
         // The Renderer
         Renderer mRenderer;
+        GBuffer::Layout mGBufferLayout;
+        // The renderer's projection as of the last UpdateTickProjection
+        glm::mat4 mTickProjection;
         // The AABB rendering utility
         AABBRenderer mAABBRenderer;
         // The Text Renderer
@@ -1,34 +1,167 @@
 #include "HeartBeat.hpp"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <thread>
+#include "../Util/Timer.hpp"
+#include "Profiler.hpp"
+
+namespace
+{
+// Most updates run back to back before the remaining ticks are dropped
+const int MAX_FRAMESKIP = 5;
+
+// Sleeps overshoot by up to a scheduler quantum, so the last stretch of a wait is spun
+const std::int64_t SPIN_NS = 2000000;
+}
+
+HeartBeat::HeartBeat()
+    : mRunning(false)
+    , mThreaded(false)
+    , mTickNs(1000000000 / 25)
+    , mFrameNs(0)
+    , mDroppedTicks(0)
+    , mTimer(MonotonicTimeNs)
+{
+}
 
 void HeartBeat::SetRunning(bool running){ mRunning = running; }
 void HeartBeat::SetUpdate(UpdateCb uFn){ mUpdate = uFn; }
 void HeartBeat::SetRender(RenderCb rFn){ mRender = rFn; }
 void HeartBeat::SetTimer(TimerFn tFn){ mTimer = tFn; }
+void HeartBeat::SetThreaded(bool threaded){ mThreaded = threaded; }
+void HeartBeat::SetTickRate(unsigned int ticksPerSecond){ mTickNs = 1000000000 / std::max(ticksPerSecond, 1u); }
+void HeartBeat::SetMaxFrameRate(unsigned int framesPerSecond){ mFrameNs = framesPerSecond ? 1000000000 / framesPerSecond : 0; }
+std::uint64_t HeartBeat::GetDroppedTicks() const { return mDroppedTicks; }
 
 void HeartBeat::Run()
 {
-    double nextUpdate = mTimer();
+    mRunning = true;
+    mDroppedTicks = 0;
+    if (mThreaded)
+        RunThreaded();
+    else
+        RunInterleaved();
+}
 
-    const int TICKS_PER_SECOND = 25;
-    const int MAX_FRAMESKIP = 5;
-    const float SKIP_TICKS = 1000 / TICKS_PER_SECOND;
+void HeartBeat::RunInterleaved()
+{
+    const float dt = static_cast<float>(mTickNs) / 1000000.0f;
 
-    int loops;
-    float interpolation;
+    // Time not yet simulated
+    std::int64_t accumulator = 0;
+    std::int64_t prevTime = mTimer();
+    std::int64_t nextFrame = prevTime;
 
-    mRunning = true;
     while (mRunning)
     {
-        loops = 0;
-        while (mTimer() > nextUpdate && loops < MAX_FRAMESKIP)
+        const std::int64_t now = mTimer();
+        accumulator += now - prevTime;
+        prevTime = now;
+
+        int loops = 0;
+        while (accumulator >= mTickNs && loops < MAX_FRAMESKIP)
         {
-            mUpdate(SKIP_TICKS);
-            nextUpdate += SKIP_TICKS;
+            mUpdate(dt);
+            accumulator -= mTickNs;
             ++loops;
         }
 
-        interpolation = static_cast<float>(mTimer() + SKIP_TICKS - nextUpdate) / SKIP_TICKS;
-        mRender(interpolation);
+        // Whatever could not be caught up with is dropped instead of stalling the following frames
+        if (accumulator >= mTickNs)
+        {
+            mDroppedTicks += static_cast<std::uint64_t>(accumulator / mTickNs);
+            accumulator %= mTickNs;
+        }
+
+        mRender(static_cast<float>(static_cast<double>(accumulator) / mTickNs));
+        PaceFrame(nextFrame);
     }
 }
 
+void HeartBeat::RunThreaded()
+{
+    const float dt = static_cast<float>(mTickNs) / 1000000.0f;
+
+    // Time of the latest finished tick, the render thread interpolates from it
+    std::atomic<std::int64_t> lastTick(mTimer());
+    std::exception_ptr simError;
+
+    std::thread simThread(
+        [this, dt, &lastTick, &simError]()
+        {
+            Profiler::SetThreadName("Simulation");
+            try
+            {
+                std::int64_t nextTick = lastTick.load() + mTickNs;
+                while (mRunning)
+                {
+                    WaitUntil(nextTick);
+
+                    // Drop the ticks that can no longer be caught up with
+                    const std::int64_t behind = mTimer() - nextTick;
+                    if (behind > MAX_FRAMESKIP * mTickNs)
+                    {
+                        mDroppedTicks += static_cast<std::uint64_t>(behind / mTickNs);
+                        nextTick += (behind / mTickNs) * mTickNs;
+                    }
+
+                    mUpdate(dt);
+                    lastTick = nextTick;
+                    nextTick += mTickNs;
+                }
+            }
+            catch (...)
+            {
+                simError = std::current_exception();
+                mRunning = false;
+            }
+        }
+    );
+
+    std::exception_ptr renderError;
+    try
+    {
+        std::int64_t nextFrame = mTimer();
+        while (mRunning)
+        {
+            const double interpolation = static_cast<double>(mTimer() - lastTick.load()) / mTickNs;
+            mRender(static_cast<float>(std::min(std::max(interpolation, 0.0), 1.0)));
+            PaceFrame(nextFrame);
+        }
+    }
+    catch (...)
+    {
+        renderError = std::current_exception();
+        mRunning = false;
+    }
+
+    simThread.join();
+    if (renderError)
+        std::rethrow_exception(renderError);
+    if (simError)
+        std::rethrow_exception(simError);
+}
+
+void HeartBeat::WaitUntil(std::int64_t time) const
+{
+    for (std::int64_t remaining = time - mTimer(); remaining > 0 && mRunning; remaining = time - mTimer())
+    {
+        if (remaining > SPIN_NS)
+            std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - SPIN_NS));
+        else
+            std::this_thread::yield();
+    }
+}
+
+void HeartBeat::PaceFrame(std::int64_t& nextFrame) const
+{
+    if (mFrameNs == 0)
+        return;
+
+    nextFrame += mFrameNs;
+    WaitUntil(nextFrame);
+
+    // Do not try to make up for frames that ran long
+    nextFrame = std::max(nextFrame, mTimer() - mFrameNs);
+}
@@ -31,6 +31,8 @@
 #ifndef _HEARTBEAT_HPP_
 #define _HEARTBEAT_HPP_
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 
 ///==============================================================
@@ -46,8 +48,11 @@ class HeartBeat
         /// Type of the callback function called on the render of the loop
         using RenderCb = std::function<void(float)>;
 
-        /// Type of the timer function
-        using TimerFn = std::function<double()>;
+        /// Type of the timer function, returns the time of a monotonic clock in nanoseconds
+        using TimerFn = std::function<std::int64_t()>;
+
+        /// Constructor, sets up a 25Hz tick with an uncapped render rate on the monotonic clock
+        HeartBeat();
 
         /// The master switch for the loop
         void SetRunning(bool running);
@@ -61,11 +66,40 @@ class HeartBeat
         /// Sets the timer source
         void SetTimer(TimerFn);
 
+        /// Sets the number of updates per second, each one advancing the game by 1000 / rate msec
+        void SetTickRate(unsigned int ticksPerSecond);
+
+        /// Caps the number of renders per second, zero leaves them uncapped
+        void SetMaxFrameRate(unsigned int framesPerSecond);
+
+        /// Number of ticks skipped because the updates fell too far behind the clock
+        std::uint64_t GetDroppedTicks() const;
+
+        /// When on, the updates run on a dedicated simulation thread at the fixed tick
+        /// while the calling thread renders as fast as it can. Must be set before Run
+        void SetThreaded(bool threaded);
+
         /// Runs the loop
         void Run();
 
     private:
-        bool mRunning;
+        /// Updates and renders on the calling thread
+        void RunInterleaved();
+
+        /// Updates on a simulation thread and renders on the calling thread
+        void RunThreaded();
+
+        /// Sleeps most of the way to the given time and spins the rest, as sleeps overshoot
+        void WaitUntil(std::int64_t time) const;
+
+        /// Waits for the next render slot when the render rate is capped
+        void PaceFrame(std::int64_t& nextFrame) const;
+
+        std::atomic<bool> mRunning;
+        bool mThreaded;
+        std::int64_t mTickNs;
+        std::int64_t mFrameNs;
+        std::atomic<std::uint64_t> mDroppedTicks;
         UpdateCb mUpdate;
         RenderCb mRender;
         TimerFn mTimer;
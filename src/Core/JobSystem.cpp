@@ -0,0 +1,249 @@
+#include "JobSystem.hpp"
+#include <string>
+#include "Profiler.hpp"
+
+namespace
+{
+// The job system owning the calling thread and the thread's queue in it
+thread_local const JobSystem* tOwner = nullptr;
+thread_local unsigned int tQueue = 0;
+
+// Rounds of fruitless searching before an idle worker goes to sleep
+const int IdleSpins = 64;
+}
+
+JobCounter::JobCounter()
+    : mPending(0)
+{
+}
+
+bool JobCounter::IsDone() const
+{
+    return mPending.load(std::memory_order_acquire) == 0;
+}
+
+JobSystem::JobSystem()
+    : mRunning(false)
+    , mQueued(0)
+    , mSteals(0)
+{
+}
+
+void JobSystem::Init(unsigned int workerCount)
+{
+    mRunning = true;
+    mSteals = 0;
+
+    mQueues.clear();
+    for (unsigned int i = 0; i < workerCount + 1; ++i)
+        mQueues.emplace_back(std::make_unique<WorkQueue>());
+
+    // The calling thread owns the first queue
+    tOwner = this;
+    tQueue = 0;
+
+    for (unsigned int i = 1; i < workerCount + 1; ++i)
+        mThreads.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+void JobSystem::Shutdown()
+{
+    // Drain what is left on the calling thread
+    while (TryRunOne(CurrentQueue()))
+        ;
+
+    {
+        std::lock_guard<std::mutex> lock(mSleepLock);
+        mRunning = false;
+    }
+    mWake.notify_all();
+
+    for (auto& t : mThreads)
+        t.join();
+    mThreads.clear();
+    mQueues.clear();
+
+    if (tOwner == this)
+        tOwner = nullptr;
+}
+
+void JobSystem::Run(std::function<void()> fn, JobCounter* counter)
+{
+    if (counter != nullptr)
+        counter->mPending.fetch_add(1, std::memory_order_relaxed);
+    Push(Job{std::move(fn), counter});
+}
+
+void JobSystem::RunAfter(JobCounter& dependency, std::function<void()> fn, JobCounter* counter)
+{
+    if (counter != nullptr)
+        counter->mPending.fetch_add(1, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(dependency.mLock);
+        if (!dependency.IsDone())
+        {
+            dependency.mContinuations.push_back(Job{std::move(fn), counter});
+            return;
+        }
+    }
+    Push(Job{std::move(fn), counter});
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+    const unsigned int self = CurrentQueue();
+    while (!counter.IsDone())
+    {
+        if (!TryRunOne(self))
+            std::this_thread::yield();
+    }
+
+    // The last job may still be releasing the continuations
+    std::lock_guard<std::mutex> lock(counter.mLock);
+}
+
+unsigned int JobSystem::GetThreadCount() const
+{
+    return static_cast<unsigned int>(mThreads.size() + 1);
+}
+
+std::uint64_t JobSystem::GetStealCount() const
+{
+    return mSteals.load(std::memory_order_relaxed);
+}
+
+//--------------------------------------------------
+// Private functions
+//--------------------------------------------------
+void JobSystem::WorkerLoop(unsigned int index)
+{
+    tOwner = this;
+    tQueue = index;
+    Profiler::SetThreadName(("Worker " + std::to_string(index)).c_str());
+
+    int idle = 0;
+    while (mRunning)
+    {
+        if (TryRunOne(index))
+        {
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < IdleSpins)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mSleepLock);
+        mWake.wait(lock, [this]() { return mQueued.load() > 0 || !mRunning; });
+        idle = 0;
+    }
+}
+
+unsigned int JobSystem::CurrentQueue() const
+{
+    // Threads outside the system share the queue of the thread that called Init
+    return tOwner == this ? tQueue : 0;
+}
+
+void JobSystem::Push(Job job)
+{
+    WorkQueue& queue = *mQueues[CurrentQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.lock);
+        queue.PushBack(std::move(job));
+    }
+    mQueued.fetch_add(1);
+
+    // Taking the lock orders the push against a worker about to sleep
+    {
+        std::lock_guard<std::mutex> lock(mSleepLock);
+    }
+    mWake.notify_one();
+}
+
+bool JobSystem::TryRunOne(unsigned int self)
+{
+    Job job;
+    bool found = false;
+
+    // Newest job of our own queue first, while its data is still in cache
+    {
+        WorkQueue& own = *mQueues[self];
+        std::lock_guard<std::mutex> lock(own.lock);
+        found = own.PopBack(job);
+    }
+
+    // Otherwise steal the oldest job of another queue
+    const std::size_t count = mQueues.size();
+    for (std::size_t i = 1; !found && i < count; ++i)
+    {
+        WorkQueue& victim = *mQueues[(self + i) % count];
+        std::lock_guard<std::mutex> lock(victim.lock);
+        found = victim.PopFront(job);
+        if (found)
+            mSteals.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (!found)
+        return false;
+
+    mQueued.fetch_sub(1);
+    job.fn();
+    Finish(job.counter);
+    return true;
+}
+
+void JobSystem::Finish(JobCounter* counter)
+{
+    if (counter == nullptr)
+        return;
+
+    // Completion happens under the lock, so a waiter can not destroy the counter while it is in use
+    std::vector<Job> ready;
+    {
+        std::lock_guard<std::mutex> lock(counter->mLock);
+        if (counter->mPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            ready.swap(counter->mContinuations);
+    }
+
+    for (auto& job : ready)
+        Push(std::move(job));
+}
+
+void JobSystem::WorkQueue::PushBack(Job&& job)
+{
+    if (size == ring.size())
+    {
+        // Unroll the ring into a buffer twice as large
+        std::vector<Job> grown(std::max<std::size_t>(ring.size() * 2, 64));
+        for (std::size_t i = 0; i < size; ++i)
+            grown[i] = std::move(ring[(head + i) % ring.size()]);
+        ring.swap(grown);
+        head = 0;
+    }
+    ring[(head + size) % ring.size()] = std::move(job);
+    ++size;
+}
+
+bool JobSystem::WorkQueue::PopBack(Job& job)
+{
+    if (size == 0)
+        return false;
+    --size;
+    job = std::move(ring[(head + size) % ring.size()]);
+    return true;
+}
+
+bool JobSystem::WorkQueue::PopFront(Job& job)
+{
+    if (size == 0)
+        return false;
+    job = std::move(ring[head]);
+    head = (head + 1) % ring.size();
+    --size;
+    return true;
+}
@@ -0,0 +1,207 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _JOBSYSTEM_HPP_
+#define _JOBSYSTEM_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobCounter;
+
+// A unit of work and the counter it reports its completion to
+struct Job
+{
+    std::function<void()> fn;
+    JobCounter* counter;
+};
+
+// Tracks a group of jobs. Jobs scheduled after it run once all of its jobs have finished.
+// Must be waited on through JobSystem::Wait before it is destroyed.
+class JobCounter
+{
+    public:
+        // Constructor
+        JobCounter();
+
+        // True when all the jobs of the counter have finished
+        bool IsDone() const;
+
+    private:
+        friend class JobSystem;
+
+        // Jobs yet to finish
+        std::atomic<int> mPending;
+
+        // Guards the completion and the continuations
+        std::mutex mLock;
+
+        // Jobs waiting for the counter to reach zero
+        std::vector<Job> mContinuations;
+};
+
+class JobSystem
+{
+    public:
+        // Constructor
+        JobSystem();
+
+        // Starts the given number of worker threads, the thread calling Init works as one more worker
+        void Init(unsigned int workerCount);
+
+        // Finishes the queued jobs and joins the worker threads
+        void Shutdown();
+
+        // Schedules a job, optionally tracked by the given counter
+        void Run(std::function<void()> fn, JobCounter* counter = nullptr);
+
+        // Schedules a job that starts once all the jobs of the dependency have finished
+        void RunAfter(JobCounter& dependency, std::function<void()> fn, JobCounter* counter = nullptr);
+
+        // Blocks until the jobs of the counter have finished, executing queued jobs meanwhile
+        void Wait(JobCounter& counter);
+
+        // Calls fn(begin, end) over [0, count) split in ranges of grain elements and waits for all of them
+        template <typename Fn>
+        void ParallelFor(std::size_t count, std::size_t grain, Fn&& fn);
+
+        // Number of threads executing jobs, including the one that called Init
+        unsigned int GetThreadCount() const;
+
+        // Number of jobs taken from the queue of another thread since Init
+        std::uint64_t GetStealCount() const;
+
+    private:
+        // Per thread job queue, the owner works from the back while the others steal from the front.
+        // A ring buffer that only grows, so queueing does not allocate once it has warmed up
+        struct WorkQueue
+        {
+            std::mutex lock;
+            std::vector<Job> ring;
+            std::size_t head = 0;
+            std::size_t size = 0;
+
+            void PushBack(Job&& job);
+            bool PopBack(Job& job);
+            bool PopFront(Job& job);
+        };
+
+        //--------------------------------------------------
+        // Private functions
+        //--------------------------------------------------
+        // The main loop of every worker thread
+        void WorkerLoop(unsigned int index);
+
+        // The queue index of the calling thread
+        unsigned int CurrentQueue() const;
+
+        // Pushes a job to the queue of the calling thread and wakes a sleeping worker
+        void Push(Job job);
+
+        // Pops or steals a job and executes it, returns false if none was found
+        bool TryRunOne(unsigned int self);
+
+        // Reports a finished job to its counter and schedules the counter's continuations
+        void Finish(JobCounter* counter);
+
+        // The queues, with the one of the thread that called Init first
+        std::vector<std::unique_ptr<WorkQueue>> mQueues;
+
+        // The worker threads
+        std::vector<std::thread> mThreads;
+
+        // Keeps the workers alive
+        std::atomic<bool> mRunning;
+
+        // Jobs sitting in the queues
+        std::atomic<int> mQueued;
+
+        // Jobs stolen from another queue
+        std::atomic<std::uint64_t> mSteals;
+
+        // Idle workers sleep here until jobs are queued
+        std::mutex mSleepLock;
+        std::condition_variable mWake;
+};
+
+template <typename Fn>
+void JobSystem::ParallelFor(std::size_t count, std::size_t grain, Fn&& fn)
+{
+    if (count == 0)
+        return;
+    grain = std::max<std::size_t>(grain, 1);
+
+    if (count <= grain || mThreads.empty())
+    {
+        fn(std::size_t(0), count);
+        return;
+    }
+
+    // Queue all the ranges but the first one, which the calling thread takes itself.
+    // The jobs capture two words only, which std::function stores without allocating
+    struct Range
+    {
+        Fn& fn;
+        std::size_t count, grain;
+    } range{fn, count, grain};
+
+    JobCounter counter;
+    for (std::size_t begin = grain; begin < count; begin += grain)
+    {
+        Run(
+            [&range, begin]()
+            {
+                range.fn(begin, std::min(begin + range.grain, range.count));
+            },
+            &counter
+        );
+    }
+    fn(std::size_t(0), grain);
+    Wait(counter);
+}
+
+// Runs a ParallelFor on the given job system, or serially on the calling thread when there is none
+template <typename Fn>
+void ParallelFor(JobSystem* jobs, std::size_t count, std::size_t grain, Fn&& fn)
+{
+    if (jobs != nullptr)
+        jobs->ParallelFor(count, grain, std::forward<Fn>(fn));
+    else if (count != 0)
+        fn(std::size_t(0), count);
+}
+
+#endif // ! _JOBSYSTEM_HPP_
@@ -0,0 +1,233 @@
+#include "Profiler.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "../Util/Timer.hpp"
+
+struct Profiler::Track
+{
+    // Zones kept per track, older ones are overwritten
+    static const std::size_t Capacity = 1 << 14;
+
+    // Deepest nesting recorded, deeper zones are counted but not kept
+    static const std::uint32_t MaxDepth = 64;
+
+    std::string name;
+    std::uint32_t id;
+
+    // Written by a single thread, the exporter only reads the zones below the published head
+    std::vector<Zone> zones;
+    std::atomic<std::uint64_t> head;
+
+    // Head at the previous drain, guarded by the tracks lock
+    std::uint64_t drained;
+
+    // Zones opened and not yet closed by the owning thread
+    std::array<const char*, MaxDepth> openNames;
+    std::array<std::int64_t, MaxDepth> openStarts;
+    std::uint32_t depth;
+};
+
+namespace
+{
+std::atomic<bool> sEnabled(true);
+
+// Owns the tracks, which outlive their threads so that they can still be exported
+std::mutex sTracksLock;
+std::vector<std::unique_ptr<Profiler::Track>> sTracks;
+
+thread_local Profiler::Track* tTrack = nullptr;
+
+Profiler::Track* NewTrack(std::string name)
+{
+    std::unique_ptr<Profiler::Track> track = std::make_unique<Profiler::Track>();
+    track->zones.resize(Profiler::Track::Capacity);
+    track->head = 0;
+    track->drained = 0;
+    track->depth = 0;
+
+    std::lock_guard<std::mutex> lock(sTracksLock);
+    track->id = static_cast<std::uint32_t>(sTracks.size());
+    track->name = name.empty() ? "Thread " + std::to_string(track->id) : std::move(name);
+    sTracks.push_back(std::move(track));
+    return sTracks.back().get();
+}
+
+Profiler::Track* ThreadTrack()
+{
+    if (tTrack == nullptr)
+        tTrack = NewTrack(std::string());
+    return tTrack;
+}
+
+void Push(Profiler::Track* track, const Profiler::Zone& zone)
+{
+    const std::uint64_t head = track->head.load(std::memory_order_relaxed);
+    track->zones[head % Profiler::Track::Capacity] = zone;
+    track->head.store(head + 1, std::memory_order_release);
+}
+
+// Copies the kept zones from the given position on, returns the head they were copied up to
+std::uint64_t CopyZones(const Profiler::Track& track, std::uint64_t from, std::vector<Profiler::Zone>& out)
+{
+    const std::uint64_t capacity = Profiler::Track::Capacity;
+
+    // Copy the kept zones, then drop the ones the owner may have overwritten meanwhile
+    const std::uint64_t before = track.head.load(std::memory_order_acquire);
+    const std::uint64_t first = std::max(from, before > capacity ? before - capacity : 0);
+    const std::size_t copied = out.size();
+    for (std::uint64_t i = first; i < before; ++i)
+        out.push_back(track.zones[i % capacity]);
+    const std::uint64_t after = track.head.load(std::memory_order_acquire);
+    if (after > capacity && after - capacity > first)
+    {
+        const std::uint64_t overwritten = std::min(after - capacity - first, before - first);
+        out.erase(out.begin() + static_cast<std::ptrdiff_t>(copied),
+                  out.begin() + static_cast<std::ptrdiff_t>(copied + overwritten));
+    }
+    return before;
+}
+
+// Zone names are code literals, but keep the output valid JSON regardless
+void WriteEscaped(FILE* f, const char* s)
+{
+    for (; *s; ++s)
+    {
+        if (*s == '"' || *s == '\\')
+            fputc('\\', f);
+        if (static_cast<unsigned char>(*s) >= 0x20)
+            fputc(*s, f);
+    }
+}
+}
+
+void Profiler::SetEnabled(bool enabled)
+{
+    sEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::IsEnabled()
+{
+    return sEnabled.load(std::memory_order_relaxed);
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+    Track* track = ThreadTrack();
+    std::lock_guard<std::mutex> lock(sTracksLock);
+    track->name = name;
+}
+
+void Profiler::BeginZone(const char* name)
+{
+    Track* track = ThreadTrack();
+    if (track->depth < Track::MaxDepth)
+    {
+        track->openNames[track->depth] = name;
+        track->openStarts[track->depth] = MonotonicTimeNs();
+    }
+    ++track->depth;
+}
+
+void Profiler::EndZone()
+{
+    Track* track = tTrack;
+    --track->depth;
+    if (track->depth < Track::MaxDepth)
+    {
+        const std::uint32_t d = track->depth;
+        Push(track, Zone{track->openNames[d], track->openStarts[d], MonotonicTimeNs(), d});
+    }
+}
+
+Profiler::Track* Profiler::CreateTrack(const char* name)
+{
+    return NewTrack(name);
+}
+
+void Profiler::RecordZone(Track* track, const Zone& zone)
+{
+    Push(track, zone);
+}
+
+bool Profiler::ExportTrace(const std::string& path)
+{
+    // Snapshot the zones of every track
+    struct TrackZones
+    {
+        std::string name;
+        std::uint32_t id;
+        std::vector<Zone> zones;
+    };
+    std::vector<TrackZones> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(sTracksLock);
+        for (const auto& track : sTracks)
+        {
+            TrackZones tz;
+            tz.name = track->name;
+            tz.id = track->id;
+            CopyZones(*track, 0, tz.zones);
+            snapshot.push_back(std::move(tz));
+        }
+    }
+
+    // Times are written in usec relative to the earliest zone
+    std::int64_t origin = INT64_MAX;
+    for (const auto& tz : snapshot)
+        for (const Zone& z : tz.zones)
+            origin = std::min(origin, z.start);
+
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f)
+        return false;
+
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", f);
+    bool first = true;
+    for (const auto& tz : snapshot)
+    {
+        fprintf(f, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"", first ? "" : ",", tz.id);
+        WriteEscaped(f, tz.name.c_str());
+        fputs("\"}}", f);
+        first = false;
+
+        for (const Zone& z : tz.zones)
+        {
+            fputs(",\n{\"name\":\"", f);
+            WriteEscaped(f, z.name);
+            fprintf(f, "\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    tz.id,
+                    static_cast<double>(z.start - origin) / 1000.0,
+                    static_cast<double>(z.end - z.start) / 1000.0);
+        }
+    }
+    fputs("\n]}\n", f);
+
+    const bool ok = ferror(f) == 0;
+    fclose(f);
+    return ok;
+}
+
+void Profiler::DrainZones(const std::function<void(const std::string& track, const Zone& zone)>& fn)
+{
+    // Copy the new zones under the lock, so that the function may record zones of its own
+    std::vector<std::pair<std::string, std::vector<Zone>>> drained;
+    {
+        std::lock_guard<std::mutex> lock(sTracksLock);
+        for (const auto& track : sTracks)
+        {
+            std::vector<Zone> zones;
+            track->drained = CopyZones(*track, track->drained, zones);
+            if (!zones.empty())
+                drained.emplace_back(track->name, std::move(zones));
+        }
+    }
+
+    for (const auto& tz : drained)
+        for (const Zone& z : tz.second)
+            fn(tz.first, z);
+}
@@ -0,0 +1,114 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _PROFILER_HPP_
+#define _PROFILER_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Collects the timed zones of every thread into per thread ring buffers, holding the latest zones of each.
+// Recording is lock free and does not allocate once a thread has recorded its first zone.
+class Profiler
+{
+    public:
+        // A finished zone, with times of the monotonic clock in nsec
+        struct Zone
+        {
+            const char*   name;
+            std::int64_t  start;
+            std::int64_t  end;
+            std::uint32_t depth;
+        };
+
+        // The ring buffer of a thread, or of a timeline that is not a thread like the GPU
+        struct Track;
+
+        // Turns the recording on or off, zones open while switching are still closed
+        static void SetEnabled(bool enabled);
+
+        // True while recording
+        static bool IsEnabled();
+
+        // Names the track of the calling thread in the exported traces
+        static void SetThreadName(const char* name);
+
+        // Opens a zone on the calling thread, the name must outlive the profiler
+        static void BeginZone(const char* name);
+
+        // Closes the latest zone opened on the calling thread
+        static void EndZone();
+
+        // Creates a track that is written through RecordZone, by one thread at a time
+        static Track* CreateTrack(const char* name);
+
+        // Appends a finished zone to the given track
+        static void RecordZone(Track* track, const Zone& zone);
+
+        // Writes the recorded zones of all the tracks as a Chrome trace_event JSON file
+        static bool ExportTrace(const std::string& path);
+
+        // Passes the zones recorded on each track since the previous drain to the given function, oldest first.
+        // Zones overwritten in between are skipped
+        static void DrainZones(const std::function<void(const std::string& track, const Zone& zone)>& fn);
+};
+
+// Times the enclosing scope
+class ProfileScope
+{
+    public:
+        explicit ProfileScope(const char* name)
+            : mActive(Profiler::IsEnabled())
+        {
+            if (mActive)
+                Profiler::BeginZone(name);
+        }
+
+        ~ProfileScope()
+        {
+            if (mActive)
+                Profiler::EndZone();
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        bool mActive;
+};
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+// Times the enclosing scope as a zone with the given name
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+
+#endif // ! _PROFILER_HPP_
@@ -0,0 +1,296 @@
+#include "Benchmark.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "../Core/Profiler.hpp"
+#include "../Graphics/Renderer/GLStateCache.hpp"
+#include "../Graphics/Renderer/RenderStats.hpp"
+#include "../Util/AllocCounter.hpp"
+#include "../Util/Timer.hpp"
+
+namespace
+{
+// Random walk segments last between one and four seconds of 25 ticks
+const std::uint32_t MinSegmentTicks = 25;
+const std::uint32_t MaxSegmentTicks = 100;
+
+// Largest cursor offset of the random walk per tick, in pixels
+const float MaxLookOffset = 8.0f;
+
+// Maps the generator output to [0, 1] directly, as the standard distributions differ between library vendors
+float Unit(std::mt19937& rng)
+{
+    return static_cast<float>(static_cast<double>(rng()) / static_cast<double>(std::mt19937::max()));
+}
+
+// Nearest rank percentile of sorted samples
+double Percentile(const std::vector<double>& sorted, double p)
+{
+    const std::size_t rank = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::max<std::size_t>(rank, 1) - 1];
+}
+
+void WriteSummary(FILE* f, std::vector<double> samples)
+{
+    if (samples.empty())
+    {
+        fputs("{\"count\":0}", f);
+        return;
+    }
+
+    std::sort(std::begin(samples), std::end(samples));
+    double sum = 0.0;
+    for (double s : samples)
+        sum += s;
+    fprintf(f, "{\"count\":%u,\"mean\":%.4f,\"p50\":%.4f,\"p95\":%.4f,\"p99\":%.4f}",
+            static_cast<unsigned int>(samples.size()),
+            sum / static_cast<double>(samples.size()),
+            Percentile(samples, 50.0),
+            Percentile(samples, 95.0),
+            Percentile(samples, 99.0));
+}
+
+void WriteEscaped(FILE* f, const std::string& s)
+{
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+            fputc('\\', f);
+        if (static_cast<unsigned char>(c) >= 0x20)
+            fputc(c, f);
+    }
+}
+}
+
+Benchmark::Benchmark(Game& game, Config config)
+    : mGame(game)
+    , mConfig(std::move(config))
+    , mStopped(false)
+    , mNextTick(0)
+    , mRng(mConfig.seed)
+    , mSegmentTicks(0)
+    , mMeasuredFrames(0)
+{
+    if (!mConfig.cameraPath.empty())
+        LoadCameraPath(mConfig.cameraPath);
+}
+
+bool Benchmark::Run()
+{
+    Window& window = mGame.GetEngine().GetWindow();
+    Renderer& renderer = mGame.GetEngine().GetRenderer();
+    window.SetInputScripted(true);
+
+    // Wait for the screen to load, holding no input
+    while (mGame.IsLoading() && !mStopped)
+    {
+        Step(InputTick());
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    // Let the caches settle, then drop everything recorded so far
+    for (unsigned int i = 0; i < mConfig.warmupFrames && !mStopped; ++i)
+        Step(NextInput());
+    renderer.FlushGpuTimings();
+    Profiler::DrainZones([](const std::string&, const Profiler::Zone&) {});
+    const std::uint64_t droppedGpuTimings = renderer.GetDroppedGpuTimings();
+
+    for (unsigned int i = 0; i < mConfig.frames && !mStopped; ++i)
+    {
+        const InputTick input = NextInput();
+        // Step renders on this thread, so its counter covers the frame submission
+        const std::uint64_t allocationsBefore = GetThreadAllocationCount();
+        const long long start = MonotonicTimeNs();
+        Step(input);
+        const long long end = MonotonicTimeNs();
+
+        // The counters of the frame just rendered are still the current ones
+        const PassStats total = RenderStats().GetFrameStats().Total();
+        mCpuFrameMs.push_back(static_cast<double>(end - start) / 1e6);
+        mAllocations.push_back(static_cast<double>(GetThreadAllocationCount() - allocationsBefore));
+        mDrawCalls.push_back(static_cast<double>(total.drawCalls));
+        mTriangles.push_back(static_cast<double>(total.triangles));
+        mStateChanges.push_back(static_cast<double>(GLState().GetFrameStats().issued));
+        ++mMeasuredFrames;
+
+        CollectZones();
+    }
+
+    // Wait for the GPU timings of the last frames
+    renderer.FlushGpuTimings();
+    CollectZones();
+
+    window.SetInputScripted(false);
+    return WriteReport(renderer.GetDroppedGpuTimings() - droppedGpuTimings);
+}
+
+void Benchmark::Stop()
+{
+    mStopped = true;
+}
+
+//--------------------------------------------------
+// Private functions
+//--------------------------------------------------
+void Benchmark::LoadCameraPath(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("Couldn't load camera path (" + path + ")");
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream ss(line);
+        std::string keys;
+        InputTick tick;
+        if (!(ss >> keys >> tick.dx >> tick.dy))
+            throw std::runtime_error("Malformed camera path line (" + line + ")");
+
+        // Letter and digit keys are named by their character
+        for (char c : keys)
+        {
+            const char k = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            if ((k >= 'A' && k <= 'Z') || (k >= '0' && k <= '9'))
+                tick.keys.push_back(static_cast<Key>(k));
+        }
+        mCameraPath.push_back(std::move(tick));
+    }
+
+    if (mCameraPath.empty())
+        throw std::runtime_error("Empty camera path (" + path + ")");
+}
+
+Benchmark::InputTick Benchmark::NextInput()
+{
+    if (!mCameraPath.empty())
+    {
+        const InputTick& tick = mCameraPath[mNextTick];
+        mNextTick = (mNextTick + 1) % mCameraPath.size();
+        return tick;
+    }
+
+    // Hold a random movement and look direction for a while, then pick new ones
+    if (mSegmentTicks == 0)
+    {
+        mSegmentTicks = MinSegmentTicks + mRng() % (MaxSegmentTicks - MinSegmentTicks + 1);
+        mSegment.keys.clear();
+        switch (mRng() % 3)
+        {
+            case 1: mSegment.keys.push_back(Key::W); break;
+            case 2: mSegment.keys.push_back(Key::S); break;
+        }
+        switch (mRng() % 3)
+        {
+            case 1: mSegment.keys.push_back(Key::A); break;
+            case 2: mSegment.keys.push_back(Key::D); break;
+        }
+        mSegment.dx = (Unit(mRng) * 2.0f - 1.0f) * MaxLookOffset;
+        mSegment.dy = (Unit(mRng) * 2.0f - 1.0f) * MaxLookOffset * 0.25f;
+    }
+    --mSegmentTicks;
+    return mSegment;
+}
+
+void Benchmark::Step(const InputTick& input)
+{
+    mGame.GetEngine().GetWindow().SetScriptedInput(input.keys, input.dx, input.dy);
+    mGame.Update(mConfig.dt);
+    mGame.Render(1.0f);
+}
+
+void Benchmark::CollectZones()
+{
+    Profiler::DrainZones(
+        [this](const std::string& track, const Profiler::Zone& zone)
+        {
+            mZoneMs[track][zone.name].push_back(static_cast<double>(zone.end - zone.start) / 1e6);
+        }
+    );
+}
+
+bool Benchmark::WriteReport(std::uint64_t droppedGpuTimings) const
+{
+    FILE* f = fopen(mConfig.output.c_str(), "w");
+    if (!f)
+        return false;
+
+    const GLubyte* glRenderer = glGetString(GL_RENDERER);
+    fputs("{\n  \"screen\": \"", f);
+    WriteEscaped(f, mConfig.screen);
+    fputs("\",\n  \"renderer\": \"", f);
+    WriteEscaped(f, glRenderer ? reinterpret_cast<const char*>(glRenderer) : "");
+    fputs("\",\n  \"cameraPath\": \"", f);
+    WriteEscaped(f, mConfig.cameraPath.empty() ? "random walk" : mConfig.cameraPath);
+    fprintf(f, "\",\n  \"seed\": %u,\n  \"dt\": %.6f,\n  \"warmupFrames\": %u,\n  \"frames\": %u,\n",
+            static_cast<unsigned int>(mConfig.seed), mConfig.dt, mConfig.warmupFrames, mMeasuredFrames);
+    fprintf(f, "  \"droppedGpuTimings\": %llu,\n", static_cast<unsigned long long>(droppedGpuTimings));
+
+    // The GBuffer footprint the light pass reads each frame, to compare against the pass timings below
+    const GBuffer::Layout layout = mGame.GetEngine().GetRenderer().GetGBufferLayout();
+    const Window& window = mGame.GetEngine().GetWindow();
+    const unsigned int bytesPerPixel = GBuffer::BytesPerPixel(layout);
+    const unsigned long long pixels = static_cast<unsigned long long>(window.GetWidth()) * window.GetHeight();
+    fprintf(f, "  \"gbuffer\": {\"layout\":\"%s\",\"bytesPerPixel\":%u,\"bytesPerFrame\":%llu},\n",
+            layout == GBuffer::Layout::Compact ? "compact" : "full", bytesPerPixel, pixels * bytesPerPixel);
+
+    // The GPU frame is the outermost zone of the renderer
+    Samples gpuFrameMs;
+    auto gpuTrack = mZoneMs.find("GPU");
+    if (gpuTrack != std::end(mZoneMs))
+    {
+        auto render = gpuTrack->second.find("Render");
+        if (render != std::end(gpuTrack->second))
+            gpuFrameMs = render->second;
+    }
+
+    const std::pair<const char*, const Samples*> series[] = {
+        { "cpuFrameMs",   &mCpuFrameMs   },
+        { "gpuFrameMs",   &gpuFrameMs    },
+        { "drawCalls",    &mDrawCalls    },
+        { "triangles",    &mTriangles    },
+        { "stateChanges", &mStateChanges },
+        { "allocations",  &mAllocations  }
+    };
+    for (const auto& s : series)
+    {
+        fprintf(f, "  \"%s\": ", s.first);
+        WriteSummary(f, *s.second);
+        fputs(",\n", f);
+    }
+
+    // Per pass timings, as the durations of the profiled zones of each track
+    fputs("  \"zonesMs\": {", f);
+    bool firstTrack = true;
+    for (const auto& track : mZoneMs)
+    {
+        fputs(firstTrack ? "\n    \"" : ",\n    \"", f);
+        WriteEscaped(f, track.first);
+        fputs("\": {", f);
+        bool firstZone = true;
+        for (const auto& zone : track.second)
+        {
+            fputs(firstZone ? "\n      \"" : ",\n      \"", f);
+            WriteEscaped(f, zone.first);
+            fputs("\": ", f);
+            WriteSummary(f, zone.second);
+            firstZone = false;
+        }
+        fputs("\n    }", f);
+        firstTrack = false;
+    }
+    fputs("\n  }\n}\n", f);
+
+    const bool ok = ferror(f) == 0;
+    fclose(f);
+    return ok;
+}
@@ -0,0 +1,127 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _BENCHMARK_HPP_
+#define _BENCHMARK_HPP_
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "Game.hpp"
+
+// Renders a fixed number of frames with fixed ticks and scripted input, so that runs are comparable,
+// and writes the frame timings and render counters of the measured frames as a JSON report
+class Benchmark
+{
+    public:
+        struct Config
+        {
+            // The name of the measured screen, as passed to Game::SetStartScreen
+            std::string screen = "main";
+            // Recorded input to play back, a seeded random walk is played when empty
+            std::string cameraPath;
+            // The report written
+            std::string output = "bench.json";
+            // Frames rendered before measuring, and measured
+            unsigned int warmupFrames = 60;
+            unsigned int frames = 1000;
+            // Seed of the random walk
+            std::uint32_t seed = 1;
+            // Fixed tick length in msec, one tick per frame. Game::Update takes msec, as HeartBeat passes them
+            float dt = 1000.0f / 25.0f;
+        };
+
+        // Constructor, loads the camera path if any
+        Benchmark(Game& game, Config config);
+
+        // Runs the benchmark on the initialized game, returns false if the report could not be written
+        bool Run();
+
+        // Ends the run early, the frames measured so far are still reported
+        void Stop();
+
+    private:
+        // The input held during a tick
+        struct InputTick
+        {
+            std::vector<Key> keys;
+            float dx = 0.0f,
+                  dy = 0.0f;
+        };
+
+        // Per frame samples in msec or in counts
+        using Samples = std::vector<double>;
+
+        //--------------------------------------------------
+        // Private functions
+        //--------------------------------------------------
+        // Reads a camera path, one tick per line made of the held keys ('-' for none) and the cursor offset
+        void LoadCameraPath(const std::string& path);
+
+        // Retrieves the input of the next tick from the camera path or the random walk
+        InputTick NextInput();
+
+        // Updates and renders a single frame with the given input
+        void Step(const InputTick& input);
+
+        // Moves the profiled zones recorded since the last call to the zone samples
+        void CollectZones();
+
+        // Writes the report, false on failure
+        bool WriteReport(std::uint64_t droppedGpuTimings) const;
+
+        Game& mGame;
+        Config mConfig;
+        bool mStopped;
+
+        // The recorded camera path, looped over, and the next tick in it
+        std::vector<InputTick> mCameraPath;
+        std::size_t mNextTick;
+
+        // Random walk state, the current segment is held for the remaining ticks
+        std::mt19937 mRng;
+        InputTick mSegment;
+        std::uint32_t mSegmentTicks;
+
+        // Samples of the measured frames
+        std::uint32_t mMeasuredFrames;
+        Samples mCpuFrameMs,
+                mDrawCalls,
+                mTriangles,
+                mStateChanges,
+                mAllocations;
+
+        // Zone durations in msec by track and zone name
+        std::map<std::string, std::map<std::string, Samples>> mZoneMs;
+};
+
+#endif // ! _BENCHMARK_HPP_
@@ -12,11 +12,7 @@ void Character::Init(Window* const window, Scene* const scene)
     mWindow = window;
     mScene  = scene;
 
-    for(auto& p : mScene->GetNodes())
-    {
-        if(p.first == "character")
-            mCharacter = p.second.get();
-    }
+    mCharacter = mScene->FindNodeByUuid("character");
 }
 
 void Character::Update()
@@ -41,5 +37,5 @@ void Character::Update()
 
 SceneNode* Character::GetCharacterNode() const
 {
-    return mCharacter;
+    return mScene->GetNode(mCharacter);
 }
@@ -55,7 +55,7 @@ class Character
     private:
        Window* mWindow;       // Pointer to window
        Scene*  mScene;        // Pointer to scene
-       SceneNode* mCharacter; // Pointer to SceneNode that represents the character 
+       NodeHandle mCharacter; // Handle to SceneNode that represents the character
 
        Stats mStats;          // Character's stats
        float mRotation;       // Character's rotation
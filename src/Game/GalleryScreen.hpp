@@ -35,6 +35,8 @@
 #include "../Graphics/Util/Camera.hpp"
 #include "../Graphics/Scene/Scene.hpp"
 #include "../Graphics/Scene/RenderformCreator.hpp"
+#include "../Graphics/Scene/RenderSnapshot.hpp"
+#include "../Util/TripleBuffer.hpp"
 
 class GalleryScreen : public Screen
 {
@@ -62,6 +64,15 @@ class GalleryScreen : public Screen
 
         // Scene graphical handler converter
         std::unique_ptr<RenderformCreator> mRenderformCreator;
+
+        // The scene lights
+        Lights mLights;
+
+        // Snapshots handed from the updates to the rendering
+        TripleBuffer<RenderSnapshot> mSnapshots;
+
+        // Updates the render lists and publishes the snapshot of the tick to the render path
+        void PublishSnapshot();
 };
 
 #endif // ! _GALLERY_SCREEN_HPP_
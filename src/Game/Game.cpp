@@ -1,11 +1,17 @@
 #include "Game.hpp"
 #include <algorithm>
 #include "ScreenRouting.hpp"
+#include "LoadingScreen.hpp"
+#include "../Graphics/Renderer/GLStateCache.hpp"
+#include "../Graphics/Renderer/RenderStats.hpp"
+#include "../Core/Profiler.hpp"
 
 ///==============================================================
 ///= Game
 ///==============================================================
 Game::Game()
+    : mThreaded(false)
+    , mStartScreen("main")
 {
 }
 
@@ -20,7 +26,10 @@ void Game::Init()
     // Setup screen transition table
     ScreenContext sc(&mEngine, &mFileDataCache);
     mScreenRouter = std::make_unique<ScreenRouter>(sc);
-    mScreenRouter->SetupScreenRouting(&mScreenManager);
+    mScreenRouter->SetupScreenRouting(&mScreenManager, mStartScreen);
+
+    // Bring up the first screen before any tick runs
+    mScreenManager.PerfomQueuedActions();
 }
 
 void Game::SetupWindow()
@@ -51,16 +60,35 @@ void Game::SetupWindow()
             // Reload shaders
             if(k == Key::F5 && ka == KeyAction::Release)
                 mEngine.ReloadShaders();
+            // Dump the profiled zones
+            if(k == Key::F9 && ka == KeyAction::Release)
+                Profiler::ExportTrace("trace.json");
             // Fw to Active screen onKey
             mScreenManager.GetActiveScreen()->onKey(k, ka);
         }
     );
 }
 
-void Game::Update(float dt)
+void Game::PumpEvents()
 {
-    // Perform deferred screen state actions
+    // Poll input, dispatching it to the active screen
+    mEngine.PollEvents();
+
+    // No tick runs while the events are pumped, so hand over the projection a resize may have changed
+    mEngine.UpdateTickProjection();
+
+    // Perform deferred screen state actions, screens load their GPU resources here
     mScreenManager.PerfomQueuedActions();
+}
+
+void Game::Update(float dt)
+{
+    PROFILE_SCOPE("Tick");
+    std::lock_guard<std::mutex> lock(mSimLock);
+
+    // Without a simulation thread the events are pumped before each tick
+    if (!mThreaded)
+        PumpEvents();
 
     // Check if last screen was poped out
     if (mScreenManager.GetActiveScreen() == nullptr)
@@ -71,6 +99,19 @@ void Game::Update(float dt)
 
 void Game::Render(float interpolation)
 {
+    PROFILE_SCOPE("Frame");
+
+    // With a simulation thread the events are pumped once per frame, in between ticks
+    if (mThreaded)
+    {
+        std::lock_guard<std::mutex> lock(mSimLock);
+        PumpEvents();
+    }
+
+    // The GL state carries over from the last frame, as nothing changes it outside of the cache
+    GLState().NewFrame();
+    RenderStats().NewFrame();
+
     // Render current screen
     Screen* s = mScreenManager.GetActiveScreen();
     if (s)
@@ -90,3 +131,33 @@ void Game::SetExitHandler(std::function<void()> f)
 {
     mExitHandler = f;
 }
+
+void Game::SetThreaded(bool threaded)
+{
+    mThreaded = threaded;
+}
+
+void Game::SetHeadless(bool headless)
+{
+    mEngine.SetHeadless(headless);
+}
+
+void Game::SetGBufferLayout(GBuffer::Layout layout)
+{
+    mEngine.SetGBufferLayout(layout);
+}
+
+void Game::SetStartScreen(const std::string& name)
+{
+    mStartScreen = name;
+}
+
+bool Game::IsLoading()
+{
+    return dynamic_cast<LoadingScreen*>(mScreenManager.GetActiveScreen()) != nullptr;
+}
+
+Engine& Game::GetEngine()
+{
+    return mEngine;
+}
@@ -32,6 +32,8 @@
 #define _GAME_HPP_
 
 #include <functional>
+#include <mutex>
+#include <string>
 #include <vector>
 #include "../Core/Engine.hpp"
 #include "ScreenManager.hpp"
@@ -62,10 +64,31 @@ class Game
         /*! Sets the master exit callback that when called should stop the main loop */
         void SetExitHandler(std::function<void()> f);
 
+        /*! Tells the game that Update and Render are called from different threads */
+        void SetThreaded(bool threaded);
+
+        /*! Renders offscreen to an invisible window, must be set before Init */
+        void SetHeadless(bool headless);
+
+        /*! Sets the GBuffer layout of the renderer, must be set before Init */
+        void SetGBufferLayout(GBuffer::Layout layout);
+
+        /*! Sets the screen loaded by Init (main, gallery, material or lights), must be set before Init */
+        void SetStartScreen(const std::string& name);
+
+        /*! True while the active screen is loading the files of the next one */
+        bool IsLoading();
+
+        /*! Retrieves the engine instance */
+        Engine& GetEngine();
+
     private:
         // Called during initialization to setup window and input
         void SetupWindow();
 
+        // Polls the input and performs the queued screen actions, on the main thread
+        void PumpEvents();
+
         // The engine instance
         Engine mEngine;
 
@@ -80,6 +103,16 @@ class Game
 
         // Master switch, called when game is exiting
         std::function<void()> mExitHandler;
+
+        // True when updating on a simulation thread
+        bool mThreaded;
+
+        // The screen loaded by Init
+        std::string mStartScreen;
+
+        // Held by the simulation for a whole tick. The main thread takes it to dispatch input
+        // and to switch screens, so screens never see these while they are updating
+        std::mutex mSimLock;
 };
 
 #endif // ! _GAME_HPP_
@@ -0,0 +1,268 @@
+#include "LightsScreen.hpp"
+#include <cmath>
+#include "../Util/WarnGuard.hpp"
+WARN_GUARD_ON
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+WARN_GUARD_OFF
+#include "../Util/FileLoad.hpp"
+#include "../Asset/Image/ImageLoader.hpp"
+#include "../Asset/Properties/Properties.hpp"
+#include "../Asset/Properties/PropertiesManager.hpp"
+#include "../Graphics/Scene/SceneFactory.hpp"
+
+// Skybox, Irrmap and Radmap names for cubemap store
+const std::string skybox = "lights_skybox";
+const std::string irrmap = "lights_irr";
+const std::string radmap = "lights_rad";
+
+// Point lights are laid out on a LightsPerAxis^3 grid
+const int LightsPerAxis = 10;
+
+void LightsScreen::onInit(ScreenContext& sc)
+{
+    // Store engine ref
+    mEngine = sc.GetEngine();
+
+    // Store file data cache ref
+    mFileDataCache = sc.GetFileDataCache();
+
+    PropertiesManager propMgr;
+    Properties::SceneFile scene = propMgr.Load
+        // Scenes
+        ( {{ "galleryscene",  "ext/Assets/Properties/Scenes/gallery.scn" }}
+        // Materials
+        , {{ "bronze",        "ext/Assets/Properties/Materials/bronze.mat"        }
+          ,{ "brown_plastic", "ext/Assets/Properties/Materials/brown_plastic.mat" }
+          ,{ "concrete",      "ext/Assets/Properties/Materials/concrete.mat"      }
+          ,{ "mahogany",      "ext/Assets/Properties/Materials/mahogany.mat"      }
+          ,{ "mirror",        "ext/Assets/Properties/Materials/mirror.mat"        }
+          ,{ "stone",         "ext/Assets/Properties/Materials/stone.mat"         }
+          ,{ "white",         "ext/Assets/Properties/Materials/white.mat"         }}
+        // Models
+        , {{ "cube",       "ext/Assets/Properties/Models/cube.mod"       }
+          ,{ "teapot",     "ext/Assets/Properties/Models/teapot.mod"     }
+          ,{ "shaderball", "ext/Assets/Properties/Models/shaderball.mod" }}
+        );
+
+    SceneFactory factory(
+        &mEngine->GetTextureStore(),
+        &mEngine->GetModelStore(),
+        &mEngine->GetMaterialStore(),
+        mFileDataCache);
+    mScene = factory.CreateFromSceneFile(scene);
+
+    // Setup scene lights
+    Lights& lights = mLights;
+
+    // Add a dim directional light
+    DirLight dirLight;
+    dirLight.direction = glm::vec3(-0.3f, -0.5f, -0.5f);
+    dirLight.color = glm::vec3(0.1f);
+    lights.dirLights.push_back(dirLight);
+
+    // Add a grid of small colored point lights
+    const float spacing = 2.4f;
+    const float offset = (LightsPerAxis - 1) * spacing * 0.5f;
+    for (int z = 0; z < LightsPerAxis; ++z)
+    {
+        for (int y = 0; y < LightsPerAxis; ++y)
+        {
+            for (int x = 0; x < LightsPerAxis; ++x)
+            {
+                PointLight pointLight;
+                pointLight.color = glm::vec3(
+                    0.2f + 0.8f * x / (LightsPerAxis - 1),
+                    0.2f + 0.8f * y / (LightsPerAxis - 1),
+                    0.2f + 0.8f * z / (LightsPerAxis - 1));
+                pointLight.attProps.constant   = 1.0f;
+                pointLight.attProps.linear     = 0.7f;
+                pointLight.attProps.quadratic  = 1.8f;
+                pointLight.position = glm::vec3(x * spacing - offset, y * spacing * 0.5f - 1.0f, z * spacing - offset);
+                lights.pointLights.push_back(pointLight);
+                mLightOrigins.push_back(pointLight.position);
+            }
+        }
+    }
+    mLightPhase = 0.0f;
+
+    // Camera initial position
+    mCamera.SetPos(glm::vec3(-6, 8, 12));
+    mCamera.Look(std::make_tuple(450.0f, 450.0f));
+
+    // Load the skybox
+    ImageLoader imLoader;
+    auto& cubemapStore = mEngine->GetCubemapStore();
+    cubemapStore.Load(skybox, imLoader.Load(*(*mFileDataCache)["ext/Assets/Textures/Skybox/Bluesky/bluesky.tga"], "tga"));
+    mEngine->GetSkyboxRenderer().SetCubemapId(cubemapStore[skybox]->id);
+
+    // Load the irr map
+    mEngine->GetCubemapStore().Load(irrmap, imLoader.Load(*(*mFileDataCache)["ext/Assets/Textures/Skybox/Bluesky/bluesky_irr.tga"], "tga"));
+
+    // Load the rad map
+    for (unsigned int i = 0; i < 9; ++i) {
+        mEngine->GetCubemapStore().Load(
+            radmap,
+            imLoader.Load(*(*mFileDataCache)[
+                "ext/Assets/Textures/Skybox/Bluesky/bluesky_rad_" + std::to_string(i) + ".tga"], "tga"), i);
+    }
+
+    // Init renderform creator
+    mRenderformCreator = std::make_unique<RenderformCreator>(&(mEngine->GetModelStore()), &(mEngine->GetMaterialStore()));
+
+    // Publish the initial state, frames may be rendered before the first update
+    mScene->Update(&mEngine->GetJobSystem());
+    PublishSnapshot();
+}
+
+std::vector<Camera::MoveDirection> LightsScreen::CameraMoveDirections()
+{
+    auto& window = mEngine->GetWindow();
+    std::vector<Camera::MoveDirection> mds;
+    if(window.IsKeyPressed(Key::W))
+        mds.push_back(Camera::MoveDirection::Forward);
+    if(window.IsKeyPressed(Key::A))
+        mds.push_back(Camera::MoveDirection::Left);
+    if(window.IsKeyPressed(Key::S))
+        mds.push_back(Camera::MoveDirection::BackWard);
+    if(window.IsKeyPressed(Key::D))
+        mds.push_back(Camera::MoveDirection::Right);
+    return mds;
+}
+
+std::tuple<float, float> LightsScreen::CameraLookOffset()
+{
+    auto& window = mEngine->GetWindow();
+    std::tuple<double, double> curDiff = window.GetCursorDiff();
+    return std::make_tuple(
+        static_cast<float>(std::get<0>(curDiff)),
+        static_cast<float>(std::get<1>(curDiff))
+    );
+}
+
+void LightsScreen::onKey(Key k, KeyAction ka)
+{
+    // Switch between the clustered and the stencil volume light culling
+    if(k == Key::C && ka == KeyAction::Release)
+    {
+        Renderer& renderer = mEngine->GetRenderer();
+        renderer.SetLightCulling(
+            renderer.GetLightCulling() == Renderer::LightCulling::Clustered
+                ? Renderer::LightCulling::StencilVolumes
+                : Renderer::LightCulling::Clustered);
+    }
+}
+
+void LightsScreen::onUpdate(float dt)
+{
+    // Aliases
+    auto& window = mEngine->GetWindow();
+
+    // Update the core
+    mEngine->Update(dt);
+
+    // Update camera euler angles
+    if (window.MouseGrabEnabled())
+        mCamera.Look(CameraLookOffset());
+
+    // Update camera position
+    mCamera.Move(CameraMoveDirections());
+
+    // Update world transforms, AABBs and the spatial index
+    mScene->Update(&mEngine->GetJobSystem());
+
+    // Bob the lights around their rest positions, so that the clusters change every frame
+    mLightPhase += 0.05f;
+    auto& pointLights = mLights.pointLights;
+    for (std::size_t i = 0; i < pointLights.size(); ++i)
+        pointLights[i].position = mLightOrigins[i] + glm::vec3(0.0f, std::sin(mLightPhase + i * 0.37f), 0.0f);
+
+    // Update the camera matrix
+    mCamera.Update();
+
+    // Hand the tick over to the render path
+    PublishSnapshot();
+}
+
+void LightsScreen::PublishSnapshot()
+{
+    // The renderer's projection belongs to the render thread
+    const glm::mat4& projection = mEngine->GetTickProjection();
+
+    // Update render form
+    mRenderformCreator->Update(*mScene, mScene->PullUpdates());
+
+    // Cull nodes outside of the camera frustum, anywhere between the previous and the current view
+    mRenderformCreator->Cull(
+        *mScene,
+        projection * mCamera.View(),
+        projection * mCamera.InterpolatedView(0.0f),
+        &mEngine->GetJobSystem());
+
+    // Capture the tick
+    RenderSnapshot& snapshot = mSnapshots.Write();
+    CaptureSnapshot(snapshot, *mRenderformCreator, *mScene);
+    snapshot.camera = mCamera;
+    snapshot.lights = mLights;
+    mSnapshots.Publish();
+}
+
+void LightsScreen::onRender(float interpolation)
+{
+    auto& renderer       = mEngine->GetRenderer();
+    auto& skyboxRenderer = mEngine->GetSkyboxRenderer();
+    auto& cubemapStore   = mEngine->GetCubemapStore();
+    auto& textRenderer   = mEngine->GetTextRenderer();
+
+    // Pick up the latest tick
+    mSnapshots.Acquire();
+    const RenderSnapshot& snapshot = mSnapshots.Read();
+
+    // Get the view matrix and pass it to the renderer
+    glm::mat4 view = snapshot.camera.InterpolatedView(interpolation);
+
+    // Convert the snapshot to int form
+    auto intForm = bakeIntForm(snapshot);
+
+    // Add skybox and irrMap id to intform
+    intForm.skyboxId = cubemapStore[skybox]->id;
+    intForm.irrMapId = cubemapStore[irrmap]->id;
+    intForm.radMapId = cubemapStore[radmap]->id;
+
+    // Render
+    renderer.GetLights() = snapshot.lights;
+    renderer.SetView(view);
+    renderer.Render(interpolation, intForm);
+
+    // Render the skybox
+    skyboxRenderer.Render(mEngine->GetRenderer().GetProjection(), view);
+
+    // Render the light culling info
+    const bool clustered = renderer.GetLightCulling() == Renderer::LightCulling::Clustered;
+    textRenderer.RenderText(
+        "Point lights: " + std::to_string(renderer.GetLights().pointLights.size()),
+        10, 50, 20, glm::vec3(1.0f, 0.5f, 0.3f), "visitor");
+    textRenderer.RenderText(
+        std::string("Culling (C): ") + (clustered ? "clustered" : "stencil volumes"),
+        10, 75, 20, glm::vec3(1.0f, 0.5f, 0.3f), "visitor");
+    if (clustered)
+        textRenderer.RenderText(
+            "Cluster assignments: " + std::to_string(renderer.GetClusterAssignmentCount()),
+            10, 100, 20, glm::vec3(1.0f, 0.5f, 0.3f), "visitor");
+
+    // Render sample text
+    textRenderer.RenderText("ScaryBox Studios", 10, 10, 32, glm::vec3(1.0f, 0.5f, 0.3f), "visitor");
+}
+
+void LightsScreen::onShutdown()
+{
+    // Remove lights
+    mEngine->GetRenderer().GetLights().pointLights.clear();
+    mEngine->GetRenderer().GetLights().dirLights.clear();
+
+    // Clear previous stores
+    mEngine->GetModelStore().Clear();
+    mEngine->GetMaterialStore().Clear();
+    mEngine->GetTextureStore().Clear();
+    mEngine->GetCubemapStore().Clear();
+}
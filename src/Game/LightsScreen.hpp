@@ -0,0 +1,83 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _LIGHTS_SCREEN_HPP_
+#define _LIGHTS_SCREEN_HPP_
+
+#include "Screen.hpp"
+#include "../Graphics/Util/Camera.hpp"
+#include "../Graphics/Scene/Scene.hpp"
+#include "../Graphics/Scene/RenderformCreator.hpp"
+#include "../Graphics/Scene/RenderSnapshot.hpp"
+#include "../Util/TripleBuffer.hpp"
+
+// Benchmark scene lit by a large number of moving point lights
+class LightsScreen : public Screen
+{
+    public:
+        // Screen interface
+        void onInit(ScreenContext& sc);
+        void onUpdate(float dt);
+        void onKey(Key k, KeyAction ka);
+        void onRender(float interpolation);
+        void onShutdown();
+    private:
+        // Engine ref
+        Engine* mEngine;
+
+        // File Data Cache ref
+        ScreenContext::FileDataCache* mFileDataCache;
+
+        // The camera view
+        std::vector<Camera::MoveDirection> CameraMoveDirections();
+        std::tuple<float, float> CameraLookOffset();
+        Camera mCamera;
+
+        // Scene
+        std::unique_ptr<Scene> mScene;
+
+        // Scene graphical handler converter
+        std::unique_ptr<RenderformCreator> mRenderformCreator;
+
+        // The scene lights
+        Lights mLights;
+
+        // Snapshots handed from the updates to the rendering
+        TripleBuffer<RenderSnapshot> mSnapshots;
+
+        // Updates the render lists and publishes the snapshot of the tick to the render path
+        void PublishSnapshot();
+
+        // Rest positions of the point lights, which bob around them
+        std::vector<glm::vec3> mLightOrigins;
+        float mLightPhase;
+};
+
+#endif // ! _LIGHTS_SCREEN_HPP_
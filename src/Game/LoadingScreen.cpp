@@ -5,6 +5,7 @@ WARN_GUARD_ON
 #include "../Asset/Geometry/ModelLoader.hpp"
 WARN_GUARD_OFF
 #include "../Util/FileLoad.hpp"
+#include "../Core/Profiler.hpp"
 
 void LoadingScreen::onInit(ScreenContext& sc)
 {
@@ -22,6 +23,7 @@ void LoadingScreen::onInit(ScreenContext& sc)
     std::thread loaderThread(
         [this]()
         {
+            Profiler::SetThreadName("Loader");
             LoadFileData();
             mFileCacheIsReady = true;
         }
@@ -33,6 +35,7 @@ void LoadingScreen::LoadFileData()
 {
     for (const auto& file : mFileList)
     {
+        PROFILE_SCOPE("LoadFile");
         mCurrentlyLoading = file;
         mFileDataCache->emplace(file, FileLoad<BufferType>(file));
         if(!(*mFileDataCache)[file])
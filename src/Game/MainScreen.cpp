@@ -9,6 +9,7 @@ WARN_GUARD_OFF
 #include "../Graphics/Scene/SceneFactory.hpp"
 #include "../Asset/Properties/Properties.hpp"
 #include "../Asset/Properties/PropertiesManager.hpp"
+#include "../Graphics/Renderer/GLStateCache.hpp"
 
 // Skybox, irrmap and Radmap names for cubemap store
 const std::string skybox = "main_skybox";
@@ -77,6 +78,10 @@ void MainScreen::onInit(ScreenContext& sc)
 
     // Init renderform creator
     mRenderformCreator = std::make_unique<RenderformCreator>(&(mEngine->GetModelStore()), &(mEngine->GetMaterialStore()));
+
+    // Publish the initial state, frames may be rendered before the first update
+    mScene->Update(&mEngine->GetJobSystem());
+    PublishSnapshot();
 }
 
 void MainScreen::SetupWorld()
@@ -108,7 +113,7 @@ void MainScreen::SetupWorld()
     mScene = factory.CreateFromSceneFile(scene);
 
     // Set positions for cubes
-    SceneNode* node;
+    NodeHandle node;
     std::vector<glm::vec3> cubePositions = {
         glm::vec3( 0.0f,  0.0f,    0.0f),
         glm::vec3( 4.0f, 10.0f,  -20.0f),
@@ -135,29 +140,29 @@ void MainScreen::SetupWorld()
     }
 }
 
-void UpdateLight(Renderer& renderer, Scene* const scene, int index, const glm::vec3& move)
+void UpdateLight(Lights& sceneLights, Scene* const scene, int index, const glm::vec3& move)
 {
     auto& lights = scene->GetLights();
 
     // Get light
-    SceneNode* curLight = lights[index];
+    SceneNode* curLight = scene->GetNode(lights[index]);
 
     // Move light in scene
     scene->Move(curLight, move);
 
-    // Move light in renderer
-    auto trans = curLight->GetTransformation().GetInterpolated(1.0f);
-    renderer.GetLights().pointLights[index].position = glm::vec3(trans[3].x, trans[3].y, trans[3].z);
+    // Move the rendered light
+    auto trans = scene->ComputeWorldTransform(curLight);
+    sceneLights.pointLights[index].position = glm::vec3(trans[3].x, trans[3].y, trans[3].z);
 };
 
-void UpdateDirectionalLight(Renderer& renderer, const glm::vec3& move) {
-    renderer.GetLights().dirLights[0].direction += move;
+void UpdateDirectionalLight(Lights& sceneLights, const glm::vec3& move) {
+    sceneLights.dirLights[0].direction += move;
 }
 
 void MainScreen::SetupLights()
 {
     // Setup scene lights
-    Lights& lights = mEngine->GetRenderer().GetLights();
+    Lights& lights = mLights;
 
     // Add directional light
     DirLight dirLight;
@@ -178,7 +183,7 @@ void MainScreen::SetupLights()
 
     // Update lights once to take their initial position
     for (int i = 0; i < 2; i++)
-        UpdateLight(mEngine->GetRenderer(), mScene.get(), i, glm::vec3(0));
+        UpdateLight(mLights, mScene.get(), i, glm::vec3(0));
 }
 
 std::vector<Camera::MoveDirection> MainScreen::CameraMoveDirections()
@@ -233,17 +238,6 @@ void MainScreen::onUpdate(float dt)
 
     auto& scene = mScene;
     auto& window = mEngine->GetWindow();
-    auto& renderer = mEngine->GetRenderer();
-
-    // Update interpolation variables
-    for (auto& obj : mScene->GetNodes())
-    {
-        Transform& trans = obj.second->GetTransformation();
-        trans.Update();
-
-        AABB& aabb = obj.second->GetAABB();
-        aabb.Update(trans.GetPosition(), trans.GetScale(), trans.GetRotation());
-    }
 
     // Update camera euler angles
     if (window.MouseGrabEnabled())
@@ -255,7 +249,7 @@ void MainScreen::onUpdate(float dt)
         mCharacter.Update();
 
         // Move Camera following character
-        auto trans = mCharacter.GetCharacterNode()->GetTransformation().GetInterpolated(1.0f);
+        auto trans = scene->ComputeWorldTransform(mCharacter.GetCharacterNode());
         mCamera.SetPos(glm::vec3(trans[3].x, trans[3].y + 4, trans[3].z + 4));
     }
     else
@@ -269,9 +263,9 @@ void MainScreen::onUpdate(float dt)
 
     // Update light position
     //auto updLight = std::bind(updateLight, renderer, mScene.get(), std::placeholders::_1);
-    auto updLight = [this, &renderer, &scene](const glm::vec3& move)
+    auto updLight = [this, &scene](const glm::vec3& move)
     {
-        UpdateLight(renderer, scene.get(), mMovingLightIndex, move);
+        UpdateLight(mLights, scene.get(), mMovingLightIndex, move);
     };
 
     float increase = 0.3f;
@@ -291,10 +285,10 @@ void MainScreen::onUpdate(float dt)
     // Update cubes' rotations
     if (mRotationData.rotating)
     {
-        for(auto& p : scene->GetNodes())
+        for(const SceneNode& node : scene->GetNodes())
         {
-            if (p.first.substr(0, 4) == "cube")
-                scene->Rotate(p.first, RotationAxis::Y, mRotationData.degreesInc);
+            if (node.GetUUID().substr(0, 4) == "cube")
+                scene->Rotate(node.GetHandle(), RotationAxis::Y, mRotationData.degreesInc);
         }
     }
 
@@ -303,24 +297,30 @@ void MainScreen::onUpdate(float dt)
     if (window.IsKeyPressed(Key::Right))
     {
         if (window.IsKeyPressed(Key::LeftShift))
-            UpdateDirectionalLight(renderer, glm::vec3(0.0f, 0.0f, increase));
+            UpdateDirectionalLight(mLights, glm::vec3(0.0f, 0.0f, increase));
         else
-            UpdateDirectionalLight(renderer, glm::vec3(increase, 0.0f, 0.0f));
+            UpdateDirectionalLight(mLights, glm::vec3(increase, 0.0f, 0.0f));
     }
     if (window.IsKeyPressed(Key::Left))
     {
         if (window.IsKeyPressed(Key::LeftShift))
-            UpdateDirectionalLight(renderer, glm::vec3(0.0f, 0.0f, -increase));
+            UpdateDirectionalLight(mLights, glm::vec3(0.0f, 0.0f, -increase));
         else
-            UpdateDirectionalLight(renderer, glm::vec3(-increase, 0.0f, 0.0f));
+            UpdateDirectionalLight(mLights, glm::vec3(-increase, 0.0f, 0.0f));
     }
     if (window.IsKeyPressed(Key::Up))
-        UpdateDirectionalLight(renderer, glm::vec3(0.0f, increase, 0.0f));
+        UpdateDirectionalLight(mLights, glm::vec3(0.0f, increase, 0.0f));
     if (window.IsKeyPressed(Key::Down))
-        UpdateDirectionalLight(renderer, glm::vec3(0.0f, -increase, 0.0f));
+        UpdateDirectionalLight(mLights, glm::vec3(0.0f, -increase, 0.0f));
+
+    // Update world transforms, AABBs and the spatial index with this tick's changes
+    mScene->Update(&mEngine->GetJobSystem());
 
     // Update physics
     UpdatePhysics(dt);
+
+    // Hand the tick over to the render path
+    PublishSnapshot();
 }
 
 void MainScreen::UpdatePhysics(float dt)
@@ -328,16 +328,47 @@ void MainScreen::UpdatePhysics(float dt)
     (void) dt;
 
     auto& scene = mScene;
-    SceneNode* teapot = mScene->FindNodeByUuid("teapot_1");
-    for(auto& p : scene->GetNodes())
-    {
-        SceneNode* cur = p.second.get();
-        if(cur->GetUUID() == teapot->GetUUID())
-            continue;
+    SceneNode* teapot = scene->GetNode(scene->FindNodeByUuid("teapot_1"));
 
-        if(Intersects(teapot->GetAABB(), cur->GetAABB()))
-            scene->Move(teapot, CalcCollisionResponce(teapot->GetAABB(), cur->GetAABB()));
-    }
+    // Gather the colliders first, as moving the teapot while querying would disturb the tree
+    std::vector<SceneNode*> colliders;
+    scene->QueryOverlaps(teapot->GetAABB(),
+        [teapot, &colliders](SceneNode* cur)
+        {
+            if(cur != teapot)
+                colliders.push_back(cur);
+        }
+    );
+
+    for(SceneNode* cur : colliders)
+        scene->Move(teapot, CalcCollisionResponce(teapot->GetAABB(), cur->GetAABB()));
+}
+
+void MainScreen::PublishSnapshot()
+{
+    // The renderer's projection belongs to the render thread
+    const glm::mat4& projection = mEngine->GetTickProjection();
+
+    // Update render form
+    mRenderformCreator->Update(*mScene, mScene->PullUpdates());
+
+    // Cull nodes outside of the camera frustum, anywhere between the previous and the current view
+    mRenderformCreator->Cull(
+        *mScene,
+        projection * mCamera.View(),
+        projection * mCamera.InterpolatedView(0.0f),
+        &mEngine->GetJobSystem());
+
+    // Capture the tick
+    RenderSnapshot& snapshot = mSnapshots.Write();
+    CaptureSnapshot(snapshot, *mRenderformCreator, *mScene);
+    snapshot.camera = mCamera;
+    snapshot.lights = mLights;
+    if (mShowAABBs)
+        CaptureNodeBounds(snapshot, *mScene);
+    else
+        snapshot.nodeBounds.clear();
+    mSnapshots.Publish();
 }
 
 void MainScreen::onRender(float interpolation)
@@ -346,14 +377,18 @@ void MainScreen::onRender(float interpolation)
     auto& skyboxRenderer = mEngine->GetSkyboxRenderer();
     auto& cubemapStore   = mEngine->GetCubemapStore();
 
-    // Get the view matrix and pass it to the renderer
-    glm::mat4 view = mCamera.InterpolatedView(interpolation);
+    // Track the uniform location queries made during this frame
+    const std::uint64_t uniformQueriesBefore = ShaderProgram::GetUniformQueryCount();
 
-    // Update render form
-    mRenderformCreator->Update(mScene->PullUpdates());
+    // Pick up the latest tick
+    mSnapshots.Acquire();
+    const RenderSnapshot& snapshot = mSnapshots.Read();
+
+    // Get the view matrix and pass it to the renderer
+    glm::mat4 view = snapshot.camera.InterpolatedView(interpolation);
 
-    // Convert render form to int form
-    auto intForm = bakeIntForm(*mRenderformCreator);
+    // Convert the snapshot to int form
+    auto intForm = bakeIntForm(snapshot);
 
     // Add skybox and irrMap id to intform
     intForm.skyboxId = cubemapStore[skybox]->id;
@@ -361,15 +396,16 @@ void MainScreen::onRender(float interpolation)
     intForm.radMapId = cubemapStore[radmap]->id;
 
     // Render
+    renderer.GetLights() = snapshot.lights;
     renderer.SetView(view);
     renderer.Render(interpolation, intForm);
 
-    // Render the AABBs if enabled
-    if (mShowAABBs)
+    // Render the AABBs if they were captured
+    if (!snapshot.nodeBounds.empty())
     {
         AABBRenderer& aabbRenderer = mEngine->GetAABBRenderer();
         aabbRenderer.SetView(view);
-        aabbRenderer.SetScene(mScene.get());
+        aabbRenderer.SetBounds(&snapshot.nodeBounds);
         aabbRenderer.Render(interpolation);
     }
 
@@ -381,6 +417,42 @@ void MainScreen::onRender(float interpolation)
     {
         DebugRenderer& dbgRenderer = mEngine->GetDebugRenderer();
         dbgRenderer.Render(interpolation);
+
+        // Render the work submitted by each pass in the last frame
+        dbgRenderer.RenderFrameStats(mEngine->GetTextRenderer(), renderer.GetFrameStats(), "visitor");
+
+        // Render the culling stats
+        const auto& cullStats = snapshot.cullStats;
+        mEngine->GetTextRenderer().RenderText(
+            "Visible: " + std::to_string(cullStats.visible) + " / " + std::to_string(cullStats.total),
+            10, 50, 20, glm::vec3(1.0f, 0.5f, 0.3f), "visitor");
+
+        // Render the shadow caster counts per cascade
+        std::string casters = "Casters:";
+        for (unsigned int count : mEngine->GetRenderer().GetShadowCasterCounts())
+            casters += " " + std::to_string(count);
+        mEngine->GetTextRenderer().RenderText(casters, 10, 75, 20, glm::vec3(1.0f, 0.5f, 0.3f), "visitor");
+
+        // Render the allocations made while submitting the last frame
+        mEngine->GetTextRenderer().RenderText(
+            "Submit allocations: " + std::to_string(mEngine->GetRenderer().GetSubmitAllocations()),
+            10, 100, 20, glm::vec3(1.0f, 0.5f, 0.3f), "visitor");
+
+        // Render the uniform location queries made during this frame
+        mEngine->GetTextRenderer().RenderText(
+            "Uniform queries: " + std::to_string(ShaderProgram::GetUniformQueryCount() - uniformQueriesBefore),
+            10, 125, 20, glm::vec3(1.0f, 0.5f, 0.3f), "visitor");
+
+        // Render the GL state changes issued and elided by the state cache during the last frame
+        const GLStateCache::Stats& glStats = GLState().GetLastFrameStats();
+        mEngine->GetTextRenderer().RenderText(
+            "GL state calls: " + std::to_string(glStats.issued) + " issued / " + std::to_string(glStats.skipped) + " skipped",
+            10, 150, 20, glm::vec3(1.0f, 0.5f, 0.3f), "visitor");
+
+        // Render the nodes whose transformation changed in the last tick
+        mEngine->GetTextRenderer().RenderText(
+            "Updated nodes: " + std::to_string(snapshot.updatedNodes) + " / " + std::to_string(snapshot.totalNodes),
+            10, 175, 20, glm::vec3(1.0f, 0.5f, 0.3f), "visitor");
     }
 
     // Render sample text
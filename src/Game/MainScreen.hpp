@@ -36,6 +36,8 @@
 #include "../Graphics/Util/Camera.hpp"
 #include "../Graphics/Scene/Scene.hpp"
 #include "../Graphics/Scene/RenderformCreator.hpp"
+#include "../Graphics/Scene/RenderSnapshot.hpp"
+#include "../Util/TripleBuffer.hpp"
 
 class MainScreen : public Screen
 {
@@ -55,6 +57,9 @@ class MainScreen : public Screen
         //
         void UpdatePhysics(float dt);
 
+        // Updates the render lists and publishes the snapshot of the tick to the render path
+        void PublishSnapshot();
+
         // Engine ref
         Engine* mEngine;
 
@@ -69,6 +74,12 @@ class MainScreen : public Screen
         Character mCharacter;
         std::unique_ptr<RenderformCreator> mRenderformCreator;
 
+        // The scene lights
+        Lights mLights;
+
+        // Snapshots handed from the updates to the rendering
+        TripleBuffer<RenderSnapshot> mSnapshots;
+
         // The camera view
         std::vector<Camera::MoveDirection> CameraMoveDirections();
         std::tuple<float, float> CameraLookOffset();
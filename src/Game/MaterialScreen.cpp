@@ -52,21 +52,21 @@ void MaterialScreen::onInit(ScreenContext& sc)
                 mEngine->GetMaterialStore().Load(materialName, m);
 
                 // Create and store the object that will be made of the material previously defined
-                SceneNode* node = mScene->CreateNode(
+                NodeHandle node = mScene->CreateNode(
                     "sphere",
                     {materialName},
                     std::to_string(id),
                     Category::Normal,
                     sphereModel.boundingBox
                 );
-                node->Move(glm::vec3(roughness * 20.0f -10.0f + 22.0f * metallic, reflectivity * 20.0f - 10.0f, 0.0f));
+                mScene->Move(node, glm::vec3(roughness * 20.0f -10.0f + 22.0f * metallic, reflectivity * 20.0f - 10.0f, 0.0f));
                 ++id;
             }
         }
     }
 
     // Setup scene lights
-    Lights& lights = mEngine->GetRenderer().GetLights();
+    Lights& lights = mLights;
 
     // Add directional light
     DirLight dirLight;
@@ -97,6 +97,10 @@ void MaterialScreen::onInit(ScreenContext& sc)
 
     // Init renderform creator
     mRenderformCreator = std::make_unique<RenderformCreator>(&(mEngine->GetModelStore()), &(mEngine->GetMaterialStore()));
+
+    // Publish the initial state, frames may be rendered before the first update
+    mScene->Update(&mEngine->GetJobSystem());
+    PublishSnapshot();
 }
 
 std::vector<Camera::MoveDirection> MaterialScreen::CameraMoveDirections()
@@ -145,18 +149,37 @@ void MaterialScreen::onUpdate(float dt)
     // Update camera position
     mCamera.Move(CameraMoveDirections());
 
-    // Update interpolation variables
-    for (auto& obj : mScene->GetNodes())
-    {
-        Transform& trans = obj.second->GetTransformation();
-        trans.Update();
-
-        AABB& aabb = obj.second->GetAABB();
-        aabb.Update(trans.GetPosition(), trans.GetScale(), trans.GetRotation());
-    }
+    // Update world transforms, AABBs and the spatial index
+    mScene->Update(&mEngine->GetJobSystem());
 
     // Update the camera matrix
     mCamera.Update();
+
+    // Hand the tick over to the render path
+    PublishSnapshot();
+}
+
+void MaterialScreen::PublishSnapshot()
+{
+    // The renderer's projection belongs to the render thread
+    const glm::mat4& projection = mEngine->GetTickProjection();
+
+    // Update render form
+    mRenderformCreator->Update(*mScene, mScene->PullUpdates());
+
+    // Cull nodes outside of the camera frustum, anywhere between the previous and the current view
+    mRenderformCreator->Cull(
+        *mScene,
+        projection * mCamera.View(),
+        projection * mCamera.InterpolatedView(0.0f),
+        &mEngine->GetJobSystem());
+
+    // Capture the tick
+    RenderSnapshot& snapshot = mSnapshots.Write();
+    CaptureSnapshot(snapshot, *mRenderformCreator, *mScene);
+    snapshot.camera = mCamera;
+    snapshot.lights = mLights;
+    mSnapshots.Publish();
 }
 
 void MaterialScreen::onRender(float interpolation)
@@ -165,14 +188,15 @@ void MaterialScreen::onRender(float interpolation)
     auto& skyboxRenderer = mEngine->GetSkyboxRenderer();
     auto& cubemapStore   = mEngine->GetCubemapStore();
 
-    // Get the view matrix and pass it to the renderer
-    glm::mat4 view = mCamera.InterpolatedView(interpolation);
+    // Pick up the latest tick
+    mSnapshots.Acquire();
+    const RenderSnapshot& snapshot = mSnapshots.Read();
 
-    // Update render form
-    mRenderformCreator->Update(mScene->PullUpdates());
+    // Get the view matrix and pass it to the renderer
+    glm::mat4 view = snapshot.camera.InterpolatedView(interpolation);
 
-    // Convert render form to int form
-    auto intForm = bakeIntForm(*mRenderformCreator);
+    // Convert the snapshot to int form
+    auto intForm = bakeIntForm(snapshot);
 
     // Add skybox and irrMap id to intform
     intForm.skyboxId = cubemapStore[skybox]->id;
@@ -180,6 +204,7 @@ void MaterialScreen::onRender(float interpolation)
     intForm.radMapId = cubemapStore[radmap]->id;
 
     // Render
+    renderer.GetLights() = snapshot.lights;
     renderer.SetView(view);
     renderer.Render(interpolation, intForm);
 
@@ -35,6 +35,8 @@
 #include "../Graphics/Util/Camera.hpp"
 #include "../Graphics/Scene/Scene.hpp"
 #include "../Graphics/Scene/RenderformCreator.hpp"
+#include "../Graphics/Scene/RenderSnapshot.hpp"
+#include "../Util/TripleBuffer.hpp"
 
 class MaterialScreen : public Screen
 {
@@ -60,6 +62,15 @@ class MaterialScreen : public Screen
         std::unique_ptr<Scene> mScene;
         // Scene graphical handler converter
         std::unique_ptr<RenderformCreator> mRenderformCreator;
+
+        // The scene lights
+        Lights mLights;
+
+        // Snapshots handed from the updates to the rendering
+        TripleBuffer<RenderSnapshot> mSnapshots;
+
+        // Updates the render lists and publishes the snapshot of the tick to the render path
+        void PublishSnapshot();
 };
 
 #endif // ! _MATERIAL_SCREEN_HPP_
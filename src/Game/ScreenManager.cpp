@@ -1,4 +1,5 @@
 #include "ScreenManager.hpp"
+#include "../Core/Profiler.hpp"
 
 void ScreenManager::AddScreen(ScreenPtr screen, ScreenContext& sc)
 {
@@ -59,14 +60,19 @@ void ScreenManager::PerfomQueuedActions()
 
 void ScreenManager::AddScreenImpl(std::unique_ptr<Screen> screen, ScreenContext& sc)
 {
+    PROFILE_SCOPE("ScreenInit");
     mScreens.push_back(std::move(screen));
     mScreens.back()->onInit(sc);
 }
 
 void ScreenManager::ReplaceScreenImpl(std::unique_ptr<Screen> screen, ScreenContext& sc)
 {
-    mScreens.back()->onShutdown();
-    mScreens.pop_back();
+    PROFILE_SCOPE("ScreenInit");
+    if (!mScreens.empty())
+    {
+        mScreens.back()->onShutdown();
+        mScreens.pop_back();
+    }
     mScreens.push_back(std::move(screen));
     mScreens.back()->onInit(sc);
 }
@@ -44,7 +44,7 @@ class ScreenManager
         // Appends a screen the the screen stack
         void AddScreen(ScreenPtr screen, ScreenContext& sc);
 
-        // Replaces current active screen with the given one
+        // Replaces current active screen with the given one, or adds it if there is none
         void ReplaceScreen(ScreenPtr screen, ScreenContext& sc);
 
         // Retrieves the currently active screen
@@ -1,10 +1,12 @@
 #include "ScreenRouting.hpp"
 #include <vector>
 #include <string>
+#include <stdexcept>
 #include "LoadingScreen.hpp"
 #include "MainScreen.hpp"
 #include "GalleryScreen.hpp"
 #include "MaterialScreen.hpp"
+#include "LightsScreen.hpp"
 
 #include "../Util/WarnGuard.hpp"
 WARN_GUARD_ON
@@ -142,7 +144,38 @@ void ScreenRouter::ChangeToMaterialScreen(ScreenManager* screenMgr)
     screenMgr->ReplaceScreen(std::move(ls), mScrContext);
 }
 
-void ScreenRouter::SetupScreenRouting(ScreenManager* screenMgr)
+void ScreenRouter::ChangeToLightsScreen(ScreenManager* screenMgr)
+{
+    std::unique_ptr<LoadingScreen> ls = std::make_unique<LoadingScreen>();
+    std::vector<std::string> fl = galleryScrFileList;
+    fl.insert(std::begin(fl), std::begin(blueSkyEnvMap), std::end(blueSkyEnvMap));
+    ls->SetFileList(fl);
+    ls->SetOnLoadedCb(
+        [this, screenMgr]()
+        {
+            std::unique_ptr<LightsScreen> scr = std::make_unique<LightsScreen>();
+            screenMgr->ReplaceScreen(std::move(scr), mScrContext);
+        }
+    );
+    screenMgr->ReplaceScreen(std::move(ls), mScrContext);
+}
+
+bool ScreenRouter::ChangeToScreen(ScreenManager* screenMgr, const std::string& name)
+{
+    if (name == "main")
+        ChangeToMainScreen(screenMgr);
+    else if (name == "gallery")
+        ChangeToGalleryScreen(screenMgr);
+    else if (name == "material")
+        ChangeToMaterialScreen(screenMgr);
+    else if (name == "lights")
+        ChangeToLightsScreen(screenMgr);
+    else
+        return false;
+    return true;
+}
+
+void ScreenRouter::SetupScreenRouting(ScreenManager* screenMgr, const std::string& startScreen)
 {
     mScrContext.GetEngine()->GetWindow().AddKeyHook(
         [this, screenMgr](Key k, KeyAction ka) -> bool
@@ -153,21 +186,13 @@ void ScreenRouter::SetupScreenRouting(ScreenManager* screenMgr)
                 ChangeToGalleryScreen(screenMgr);
             else if (k == Key::F3 && ka == KeyAction::Press)
                 ChangeToMaterialScreen(screenMgr);
+            else if (k == Key::F4 && ka == KeyAction::Press)
+                ChangeToLightsScreen(screenMgr);
             return true;
         },
         Window::HookPos::Start
     );
 
-    std::unique_ptr<LoadingScreen> ls = std::make_unique<LoadingScreen>();
-    std::vector<std::string> fl = mainScrFileList;
-    fl.insert(std::begin(fl), std::begin(blueSkyEnvMap), std::end(blueSkyEnvMap));
-    ls->SetFileList(fl);
-    ls->SetOnLoadedCb(
-        [this, screenMgr]()
-        {
-            std::unique_ptr<MainScreen> mainScr = std::make_unique<MainScreen>();
-            screenMgr->ReplaceScreen(std::move(mainScr), mScrContext);
-        }
-    );
-    screenMgr->AddScreen(std::move(ls), mScrContext);
+    if (!ChangeToScreen(screenMgr, startScreen))
+        throw std::runtime_error("Unknown screen (" + startScreen + ")");
 }
@@ -31,6 +31,7 @@
 #ifndef _SCREEN_ROUTING_HPP_
 #define _SCREEN_ROUTING_HPP_
 
+#include <string>
 #include "ScreenManager.hpp"
 
 class ScreenRouter
@@ -39,8 +40,11 @@ class ScreenRouter
         // Constructor
         ScreenRouter(ScreenContext screenContext);
 
-        // Main routing setup function
-        void SetupScreenRouting(ScreenManager* screenMgr);
+        // Main routing setup function, starting with the screen of the given name
+        void SetupScreenRouting(ScreenManager* screenMgr, const std::string& startScreen);
+
+        // Loads the screen of the given name (main, gallery, material or lights), false if there is none
+        bool ChangeToScreen(ScreenManager* screenMgr, const std::string& name);
 
     private:
         // The context passed to the screen instantiation actions
@@ -49,6 +53,7 @@ class ScreenRouter
         void ChangeToMainScreen(ScreenManager* screenMgr);
         void ChangeToGalleryScreen(ScreenManager* screenMgr);
         void ChangeToMaterialScreen(ScreenManager* screenMgr);
+        void ChangeToLightsScreen(ScreenManager* screenMgr);
 };
 
 #endif // ! _SCREEN_ROUTING_HPP_
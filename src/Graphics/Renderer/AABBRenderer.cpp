@@ -1,5 +1,6 @@
 #include "AABBRenderer.hpp"
-#include "RenderUtils.hpp"
+#include "GLStateCache.hpp"
+#include "RenderStats.hpp"
 
 WARN_GUARD_ON
 #include <glm/gtc/type_ptr.hpp>
@@ -9,13 +10,15 @@ WARN_GUARD_OFF
 const GLchar* simpleVert = R"foo(
 #version 330
 layout(location=0) in vec3 position;
+layout(location=1) in vec3 boxMin;
+layout(location=2) in vec3 boxMax;
 
 uniform mat4 projection;
 uniform mat4 view;
 
 void main(void)
 {
-    gl_Position = projection * view * vec4(position, 1.0f);
+    gl_Position = projection * view * vec4(mix(boxMin, boxMax, position), 1.0f);
 }
 )foo";
 
@@ -29,41 +32,46 @@ void main(void)
 }
 )foo";
 
-void AABBRenderer::Init()
+void AABBRenderer::Init(const PrimitiveCache* primitives)
 {
+    mBounds = nullptr;
+    mPrimitives = primitives;
+
     Shader vShader(simpleVert, Shader::Type::Vertex);
     Shader fShader(simpleFrag, Shader::Type::Fragment);
     mProgram = std::make_unique<ShaderProgram>(vShader.Id(), fShader.Id());
+    mProjectionUniform = mProgram->GetUniform<glm::mat4>("projection");
+    mViewUniform = mProgram->GetUniform<glm::mat4>("view");
 }
 
 void AABBRenderer::Render(float interpolation)
 {
     (void) interpolation;
 
-    glUseProgram(mProgram->Id());
-    for(const auto& p : mScene->GetNodes())
-    {
-        SceneNode* const node = p.second.get();
+    if (mBounds == nullptr)
+        return;
+    RenderPassScope pass(RenderPass::Debug);
 
-        // Upload model, projection and view matrices
-        glUniformMatrix4fv(glGetUniformLocation(mProgram->Id(), "projection"), 1, GL_FALSE, glm::value_ptr(mProjection));
-        glUniformMatrix4fv(glGetUniformLocation(mProgram->Id(), "view"), 1, GL_FALSE, glm::value_ptr(mView));
+    // Upload projection and view matrices
+    GLState().UseProgram(mProgram->Id());
+    mProjectionUniform.Set(mProjection);
+    mViewUniform.Set(mView);
 
-        // Draw the AABB
-        RenderBox(node->GetAABB());
-    }
-    glUseProgram(0);
+    // Draw all the AABBs at once
+    mPrimitives->RenderBoxes(*mBounds);
+    GLState().UseProgram(0);
 }
 
 void AABBRenderer::Shutdown()
 {
-    mScene = nullptr;
+    mBounds = nullptr;
+    mPrimitives = nullptr;
     mProgram.reset();
 }
 
-void AABBRenderer::SetScene(const Scene* scene)
+void AABBRenderer::SetBounds(const std::vector<glm::vec3>* bounds)
 {
-    mScene = scene;
+    mBounds = bounds;
 }
 
 void AABBRenderer::SetProjection(const glm::mat4& projection)
@@ -32,9 +32,10 @@
 #define _AABB_RENDERER_HPP_
 
 #include <memory>
+#include <vector>
 #include "../Resource/ModelStore.hpp"
 #include "../Shader/Shader.hpp"
-#include "../Scene/Scene.hpp"
+#include "PrimitiveCache.hpp"
 
 #include "../../Util/WarnGuard.hpp"
 WARN_GUARD_ON
@@ -45,16 +46,16 @@ class AABBRenderer
 {
     public:
         // Initializes the renderer state
-        void Init();
+        void Init(const PrimitiveCache* primitives);
 
-        // Renders AABBs in the given scene
+        // Renders the AABBs of the given bounds
         void Render(float interpolation);
 
         // Deinitializes the renderer state
         void Shutdown();
 
-        // Sets the scene to process
-        void SetScene(const Scene* scene);
+        // Sets the AABBs to render, as min / max point pairs
+        void SetBounds(const std::vector<glm::vec3>* bounds);
 
         // Sets the projection matrix
         void SetProjection(const glm::mat4& projection);
@@ -63,10 +64,13 @@ class AABBRenderer
         void SetView(const glm::mat4& view);
 
     private:
-        const Scene* mScene;
+        const std::vector<glm::vec3>* mBounds;
+        const PrimitiveCache* mPrimitives;
         glm::mat4 mProjection;
         glm::mat4 mView;
         std::unique_ptr<ShaderProgram> mProgram;
+        Uniform<glm::mat4> mProjectionUniform;
+        Uniform<glm::mat4> mViewUniform;
 };
 
 #endif // ! _AABB_RENDERER_HPP_
@@ -1,6 +1,7 @@
 #include "ConsoleRenderer.hpp"
 #include <glad/glad.h>
-#include "RenderUtils.hpp"
+#include "GLStateCache.hpp"
+#include "RenderStats.hpp"
 #include "../../Util/WarnGuard.hpp"
 WARN_GUARD_ON
 #include <glm/glm.hpp>
@@ -25,9 +26,10 @@ void main(void)
     color = vec4(0.0, 0.0, 0.0, 0.3);
 }
 )foo";
-void ConsoleRenderer::Init(TextRenderer* textRenderer)
+void ConsoleRenderer::Init(TextRenderer* textRenderer, const PrimitiveCache* primitives)
 {
     mTextRenderer = textRenderer;
+    mPrimitives = primitives;
 
     // Load default font
     mTextRenderer->GetFontStore().LoadFont("atari", "ext/Assets/Fonts/atari.ttf");
@@ -40,38 +42,41 @@ void ConsoleRenderer::Init(TextRenderer* textRenderer)
 void ConsoleRenderer::Shutdown()
 {
     mTextRenderer = nullptr;
+    mPrimitives = nullptr;
 }
 
 void ConsoleRenderer::Render(const Console& c, int width, int height)
 {
     (void) width;
+    RenderPassScope pass(RenderPass::Debug);
+    GLStateCache& state = GLState();
+
     // Store previous blending state
-    GLboolean blend = glIsEnabled(GL_BLEND);
+    bool blend = state.IsEnabled(GL_BLEND);
 
-    // Store previous src alpha blend function
-    GLint srcAlphaBlendFunc;
-    glGetIntegerv(GL_BLEND_SRC_ALPHA, &srcAlphaBlendFunc);
+    // Store previous blend function
+    GLenum blendSrc, blendDst;
+    state.GetBlendFunc(blendSrc, blendDst);
 
     // Store previous depth test state
-    GLint depthTest;
-    glGetIntegerv(GL_DEPTH_TEST, &depthTest);
-    glDisable(GL_DEPTH_TEST);
+    bool depthTest = state.IsEnabled(GL_DEPTH_TEST);
+    state.Disable(GL_DEPTH_TEST);
 
     // Enable blending
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    state.Enable(GL_BLEND);
+    state.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     // Actual rendering
-    glUseProgram(mProgram->Id());
+    state.UseProgram(mProgram->Id());
     {
         const std::string& cmdbuf = c.GetCommandBuffer();
         int xOffset = 4;
         int yOffset = height - 24;
 
-        glEnable(GL_SCISSOR_TEST);
+        state.Enable(GL_SCISSOR_TEST);
         glScissor(xOffset, yOffset, width - 8, 20);
-        RenderQuad();
-        glDisable(GL_SCISSOR_TEST);
+        mPrimitives->RenderQuad();
+        state.Disable(GL_SCISSOR_TEST);
 
         mTextRenderer->RenderText(
             cmdbuf,
@@ -80,18 +85,12 @@ void ConsoleRenderer::Render(const Console& c, int width, int height)
             "atari"
         );
     }
-    glUseProgram(0);
+    state.UseProgram(0);
 
     // Restore previous depth test state
-    if(depthTest)
-        glEnable(GL_DEPTH_TEST);
-    else
-        glDisable(GL_DEPTH_TEST);
+    state.SetEnabled(GL_DEPTH_TEST, depthTest);
 
     // Restore blending options
-    glBlendFunc(GL_SRC_ALPHA, srcAlphaBlendFunc);
-    if(blend)
-        glEnable(GL_BLEND);
-    else
-        glDisable(GL_BLEND);
+    state.BlendFunc(blendSrc, blendDst);
+    state.SetEnabled(GL_BLEND, blend);
 }
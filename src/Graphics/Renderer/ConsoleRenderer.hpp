@@ -34,16 +34,18 @@
 #include "../../Core/Console.hpp"
 #include "../Shader/Shader.hpp"
 #include "TextRenderer.hpp"
+#include "PrimitiveCache.hpp"
 
 class ConsoleRenderer
 {
     public:
-        void Init(TextRenderer* textRenderer);
+        void Init(TextRenderer* textRenderer, const PrimitiveCache* primitives);
         void Render(const Console& c, int width, int height);
         void Shutdown();
 
     private:
         TextRenderer* mTextRenderer;
+        const PrimitiveCache* mPrimitives;
         std::unique_ptr<ShaderProgram> mProgram;
 };
 
@@ -1,7 +1,10 @@
 #include "DebugRenderer.hpp"
+#include <array>
+#include <string>
 #include <vector>
 #include <tuple>
-#include "RenderUtils.hpp"
+#include "GLStateCache.hpp"
+#include "RenderStats.hpp"
 
 WARN_GUARD_ON
 #include <glm/gtc/type_ptr.hpp>
@@ -44,29 +47,37 @@ void main(void)
 }
 )foo";
 
-void DebugRenderer::Init(int width, int height)
+void DebugRenderer::Init(int width, int height, const PrimitiveCache* primitives)
 {
     SetWindowDimensions(width, height);
+    mPrimitives = primitives;
 
     Shader vShader(vertShSrc, Shader::Type::Vertex);
     Shader fShader(fragShSrc, Shader::Type::Fragment);
     mProgram = std::make_unique<ShaderProgram>(vShader.Id(), fShader.Id());
+    mScreenSizeUniform        = mProgram->GetUniform<glm::ivec2>("gScreenSize");
+    mOffsetUniform            = mProgram->GetUniform<glm::ivec2>("offset");
+    mSamplerUniform           = mProgram->GetUniform<GLint>("sampler");
+    mSamplerArrayUniform      = mProgram->GetUniform<GLint>("samplerArray");
+    mSamplerArrayIndexUniform = mProgram->GetUniform<GLint>("samplerArrayIndex");
+    mModeUniform              = mProgram->GetUniform<GLint>("mode");
 }
 
 void DebugRenderer::Render(float interpolation)
 {
     (void) interpolation;
+    RenderPassScope pass(RenderPass::Debug);
+
+    GLStateCache& state = GLState();
 
     // Store previous viewport
-    GLint viewport[4];
-    glGetIntegerv(GL_VIEWPORT, viewport);
+    const std::array<GLint, 4> viewport = state.GetViewport();
 
     // Store previous depth test state
-    GLint depthTest;
-    glGetIntegerv(GL_DEPTH_TEST, &depthTest);
-    glDisable(GL_DEPTH_TEST);
+    bool depthTest = state.IsEnabled(GL_DEPTH_TEST);
+    state.Disable(GL_DEPTH_TEST);
 
-    glUseProgram(mProgram->Id());
+    state.UseProgram(mProgram->Id());
 
     // Count total textures
     unsigned int totalTextures = 0;
@@ -79,7 +90,7 @@ void DebugRenderer::Render(float interpolation)
     float scaleFactor = ((mWndWidth - totalPadding) / totalTextures) / mWndWidth;
     int curWidth = static_cast<int>(mWndWidth * scaleFactor);
     int curHeight = static_cast<int>(mWndHeight * scaleFactor);
-    glUniform2i(glGetUniformLocation(mProgram->Id(), "gScreenSize"), curWidth, curHeight);
+    mScreenSizeUniform.Set(glm::ivec2(curWidth, curHeight));
 
     unsigned int curTex = 0;
     for (std::size_t i = 0; i < mDbgTextures.size(); ++i)
@@ -104,43 +115,93 @@ void DebugRenderer::Render(float interpolation)
         }
 
         // Set the shader mode
-        glUniform1i(glGetUniformLocation(mProgram->Id(), "mode"), mode);
+        mModeUniform.Set(mode);
 
         for (int j = 0; j < numTextures; ++j)
         {
             // Setup sampler texture
-            glActiveTexture(GL_TEXTURE0);
-            const char* samplerUniformName = texType == GL_TEXTURE_2D ? "sampler" : "samplerArray";
-            glUniform1i(glGetUniformLocation(mProgram->Id(), samplerUniformName), 0);
-            glUniform1i(glGetUniformLocation(mProgram->Id(), "samplerArrayIndex"), j);
+            state.ActiveTexture(GL_TEXTURE0);
+            const auto& samplerUniform = texType == GL_TEXTURE_2D ? mSamplerUniform : mSamplerArrayUniform;
+            samplerUniform.Set(0);
+            mSamplerArrayIndexUniform.Set(j);
 
             // Set the viewport
             int xOffset = static_cast<int>(padding + (curWidth + padding) * curTex);
             int yOffset = static_cast<int>(padding);
-            glViewport(xOffset, yOffset, curWidth, curHeight);
-            glUniform2i(glGetUniformLocation(mProgram->Id(), "offset"), xOffset, yOffset);
+            state.Viewport(xOffset, yOffset, curWidth, curHeight);
+            mOffsetUniform.Set(glm::ivec2(xOffset, yOffset));
 
             // Render
-            glBindTexture(texType, tex);
-            RenderQuad();
-            glBindTexture(texType, 0);
+            state.BindTexture(texType, tex);
+            mPrimitives->RenderQuad();
             ++curTex;
         }
     }
-    glUseProgram(0);
+    state.UseProgram(0);
 
     // Restore previous depth test state
-    if(depthTest)
-        glEnable(GL_DEPTH_TEST);
-    else
-        glDisable(GL_DEPTH_TEST);
+    state.SetEnabled(GL_DEPTH_TEST, depthTest);
 
     // Restore previous viewport
-    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    state.Viewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+void DebugRenderer::RenderFrameStats(TextRenderer& textRenderer, const FrameRenderStats& stats, const std::string& font)
+{
+    const int textSize = 16;
+    const float lineHeight = 18.0f;
+    const float nameWidth = 80.0f;
+    const float columnWidth = 64.0f;
+    const glm::vec3 color = glm::vec3(1.0f, 0.5f, 0.3f);
+
+    // Shortens the large counts so that they fit in their column
+    auto abbreviate = [](std::uint64_t value) -> std::string
+    {
+        if (value >= 10000000)
+            return std::to_string(value / 1000000) + "M";
+        if (value >= 10000)
+            return std::to_string(value / 1000) + "k";
+        return std::to_string(value);
+    };
+
+    float y = static_cast<float>(mWndHeight) - 10.0f - textSize;
+    auto row = [&](const char* name, const std::array<std::string, 9>& cells)
+    {
+        textRenderer.RenderText(name, 10.0f, y, textSize, color, font);
+        for (std::size_t i = 0; i < cells.size(); ++i)
+            textRenderer.RenderText(cells[i], 10.0f + nameWidth + columnWidth * i, y, textSize, color, font);
+        y -= lineHeight;
+    };
+    auto passRow = [&](const char* name, const PassStats& pass)
+    {
+        row(name, {{
+            abbreviate(pass.drawCalls),
+            abbreviate(pass.instances),
+            abbreviate(pass.triangles),
+            abbreviate(pass.vertices),
+            abbreviate(pass.programBinds),
+            abbreviate(pass.vaoBinds),
+            abbreviate(pass.textureBinds),
+            abbreviate(pass.bufferBytes),
+            abbreviate(pass.uniformUploads)
+        }});
+    };
+
+    row("Pass", {{"Draws", "Inst", "Tris", "Verts", "Progs", "VAOs", "Texs", "Bytes", "Unifs"}});
+    for (std::size_t i = 0; i < stats.passes.size(); ++i)
+        passRow(RenderPassName(static_cast<RenderPass>(i)), stats.passes[i]);
+    passRow("Total", stats.Total());
+
+    textRenderer.RenderText(
+        "Lights: " + std::to_string(stats.dirLights) + " directional / "
+                   + std::to_string(stats.clusteredPointLights) + " clustered / "
+                   + std::to_string(stats.stencilPointLights) + " stencil volumes",
+        10.0f, y, textSize, color, font);
 }
 
 void DebugRenderer::Shutdown()
 {
+    mPrimitives = nullptr;
     mProgram.reset();
 }
 
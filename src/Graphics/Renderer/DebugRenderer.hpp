@@ -35,6 +35,9 @@
 #include <memory>
 #include <glad/glad.h>
 #include "../Shader/Shader.hpp"
+#include "PrimitiveCache.hpp"
+#include "RenderStats.hpp"
+#include "TextRenderer.hpp"
 
 #include "../../Util/WarnGuard.hpp"
 WARN_GUARD_ON
@@ -45,11 +48,14 @@ class DebugRenderer
 {
     public:
         // Initializes the renderer state
-        void Init(int scrWidth, int scrHeight);
+        void Init(int scrWidth, int scrHeight, const PrimitiveCache* primitives);
 
         // Renders AABBs in the given scene
         void Render(float interpolation);
 
+        // Renders the per pass frame statistics as a table in the top left corner of the window
+        void RenderFrameStats(TextRenderer& textRenderer, const FrameRenderStats& stats, const std::string& font);
+
         // Deinitializes the renderer state
         void Shutdown();
 
@@ -63,7 +69,14 @@ class DebugRenderer
 
     private:
         int mWndWidth, mWndHeight;
+        const PrimitiveCache* mPrimitives;
         std::unique_ptr<ShaderProgram> mProgram;
+        Uniform<glm::ivec2> mScreenSizeUniform;
+        Uniform<glm::ivec2> mOffsetUniform;
+        Uniform<GLint> mSamplerUniform;
+        Uniform<GLint> mSamplerArrayUniform;
+        Uniform<GLint> mSamplerArrayIndexUniform;
+        Uniform<GLint> mModeUniform;
         std::vector<TextureTarget> mDbgTextures;
 };
 
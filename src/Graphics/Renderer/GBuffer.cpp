@@ -1,50 +1,88 @@
 #include "GBuffer.hpp"
+#include "GLStateCache.hpp"
 #include <stdexcept>
 
-GBuffer::GBuffer(unsigned int width, unsigned int height)
+// Sets the geometry pass outputs, the compact layout has no position output
+static void SetGeometryDrawBuffers(GBuffer::Layout layout)
 {
+    GLuint attachments[4] = {
+        layout == GBuffer::Layout::Full ? static_cast<GLuint>(GL_COLOR_ATTACHMENT0) : static_cast<GLuint>(GL_NONE)
+      , GL_COLOR_ATTACHMENT1
+      , GL_COLOR_ATTACHMENT2
+      , GL_COLOR_ATTACHMENT4
+    };
+    glDrawBuffers(4, attachments);
+}
+
+unsigned int GBuffer::BytesPerPixel(Layout layout)
+{
+    // Position, normal, albedo-specular and material index
+    if (layout == Layout::Full)
+        return 6 + 6 + 4 + 4;
+    // Depth copy, normal, albedo-specular and material
+    return 4 + 4 + 4 + 4;
+}
+
+GBuffer::GBuffer(unsigned int width, unsigned int height, Layout layout)
+    : mLayout(layout)
+    , mWidth(width)
+    , mHeight(height)
+    , mPositionBufId(0)
+    , mDepthCopyFboId(0)
+    , mDepthCopyBufId(0)
+{
+    const bool compact = mLayout == Layout::Compact;
+
     // Create the framebuffer
     glGenFramebuffers(1, &mGBufferId);
-    glBindFramebuffer(GL_FRAMEBUFFER, mGBufferId);
+    GLState().BindFramebuffer(GL_FRAMEBUFFER, mGBufferId);
 
-    // - Position color buffer
-    glGenTextures(1, &mPositionBufId);
-    glBindTexture(GL_TEXTURE_2D, mPositionBufId);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mPositionBufId, 0);
+    // - Position color buffer, reconstructed from depth with the compact layout
+    if (!compact)
+    {
+        glGenTextures(1, &mPositionBufId);
+        GLState().BindTexture(GL_TEXTURE_2D, mPositionBufId);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mPositionBufId, 0);
+    }
 
-    // - Normal color buffer
+    // - Normal color buffer, octahedral encoded with the compact layout
     glGenTextures(1, &mNormalBufId);
-    glBindTexture(GL_TEXTURE_2D, mNormalBufId);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, nullptr);
+    GLState().BindTexture(GL_TEXTURE_2D, mNormalBufId);
+    if (compact)
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16, width, height, 0, GL_RG, GL_UNSIGNED_SHORT, nullptr);
+    else
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, mNormalBufId, 0);
 
     // - Color + Specular color buffer
     glGenTextures(1, &mAlbedoSpecBufId);
-    glBindTexture(GL_TEXTURE_2D, mAlbedoSpecBufId);
+    GLState().BindTexture(GL_TEXTURE_2D, mAlbedoSpecBufId);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, mAlbedoSpecBufId, 0);
 
-    // - Material index buffer
+    // - Material index buffer, along with the roughness and metallic factors with the compact layout
     glGenTextures(1, &mMatIndexBufId);
-    glBindTexture(GL_TEXTURE_2D, mMatIndexBufId);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, width, height, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    GLState().BindTexture(GL_TEXTURE_2D, mMatIndexBufId);
+    if (compact)
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    else
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, width, height, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT4, GL_TEXTURE_2D, mMatIndexBufId, 0);
 
-    GLuint attachments[4] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT4 };
-    glDrawBuffers(4, attachments);
+    SetGeometryDrawBuffers(mLayout);
 
     // - Depth + stencil buffer
     glGenTextures(1, &mDepthStencilBufId);
-    glBindTexture(GL_TEXTURE_2D, mDepthStencilBufId);
+    GLState().BindTexture(GL_TEXTURE_2D, mDepthStencilBufId);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, width, height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -52,7 +90,7 @@ GBuffer::GBuffer(unsigned int width, unsigned int height)
 
     // - Final buffer
     glGenTextures(1, &mFinalBufId);
-    glBindTexture(GL_TEXTURE_2D, mFinalBufId);
+    GLState().BindTexture(GL_TEXTURE_2D, mFinalBufId);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGB, GL_FLOAT, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -62,16 +100,35 @@ GBuffer::GBuffer(unsigned int width, unsigned int height)
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
         throw std::runtime_error("OpenGL: Framebuffer incomplete!");
 
+    // - Depth copy buffer, the blit source and destination formats must match
+    if (compact)
+    {
+        glGenTextures(1, &mDepthCopyBufId);
+        GLState().BindTexture(GL_TEXTURE_2D, mDepthCopyBufId);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, width, height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        glGenFramebuffers(1, &mDepthCopyFboId);
+        GLState().BindFramebuffer(GL_FRAMEBUFFER, mDepthCopyFboId);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, mDepthCopyBufId, 0);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            throw std::runtime_error("OpenGL: Depth copy framebuffer incomplete!");
+    }
+
     // Unbind stuff
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState().BindTexture(GL_TEXTURE_2D, 0);
+    GLState().BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 GBuffer::~GBuffer()
 {
-    GLuint textures[6] = { mPositionBufId, mNormalBufId, mAlbedoSpecBufId, mMatIndexBufId, mDepthStencilBufId, mFinalBufId };
-    glDeleteTextures(6, textures);
-    glDeleteFramebuffers(1, &mGBufferId);
+    GLuint textures[7] = { mPositionBufId, mNormalBufId, mAlbedoSpecBufId, mMatIndexBufId, mDepthStencilBufId, mDepthCopyBufId, mFinalBufId };
+    GLState().DeleteTextures(7, textures);
+    GLuint framebuffers[2] = { mGBufferId, mDepthCopyFboId };
+    GLState().DeleteFramebuffers(2, framebuffers);
 }
 
 void GBuffer::PrepareFor(Mode mode)
@@ -80,24 +137,19 @@ void GBuffer::PrepareFor(Mode mode)
     {
         case Mode::GeometryPass:
         {
-            glBindFramebuffer(GL_FRAMEBUFFER, mGBufferId);
-            GLuint attachments[4] = {
-                GL_COLOR_ATTACHMENT0
-              , GL_COLOR_ATTACHMENT1
-              , GL_COLOR_ATTACHMENT2
-              , GL_COLOR_ATTACHMENT4
-            };
-            glDrawBuffers(4, attachments);
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            GLState().BindFramebuffer(GL_FRAMEBUFFER, mGBufferId);
+            SetGeometryDrawBuffers(mLayout);
+            GLState().BindFramebuffer(GL_FRAMEBUFFER, 0);
             break;
         }
         case Mode::LightPass:
         {
-            glBindFramebuffer(GL_FRAMEBUFFER, mGBufferId);
+            GLState().BindFramebuffer(GL_FRAMEBUFFER, mGBufferId);
             glDrawBuffer(GL_COLOR_ATTACHMENT3);
 
+            // The compact layout reconstructs the position from the depth copy
             GLuint textureIds[] = {
-                mPositionBufId,
+                mLayout == Layout::Full ? mPositionBufId : mDepthCopyBufId,
                 mNormalBufId,
                 mAlbedoSpecBufId,
                 mMatIndexBufId
@@ -105,34 +157,36 @@ void GBuffer::PrepareFor(Mode mode)
 
             for (unsigned int i = 0; i < 4; ++i)
             {
-                glActiveTexture(GL_TEXTURE0 + i);
-                glBindTexture(GL_TEXTURE_2D, textureIds[i]);
+                GLState().ActiveTexture(GL_TEXTURE0 + i);
+                GLState().BindTexture(GL_TEXTURE_2D, textureIds[i]);
             }
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            GLState().BindFramebuffer(GL_FRAMEBUFFER, 0);
             break;
         }
         case Mode::StencilPass:
         {
-            glBindFramebuffer(GL_FRAMEBUFFER, mGBufferId);
+            GLState().BindFramebuffer(GL_FRAMEBUFFER, mGBufferId);
             glDrawBuffer(GL_NONE);
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            GLState().BindFramebuffer(GL_FRAMEBUFFER, 0);
             break;
         }
     }
 }
 
-void GBuffer::CopyResultToDefault(int width, int height)
+void GBuffer::CopyDepth()
 {
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, mGBufferId);
-    glReadBuffer(GL_COLOR_ATTACHMENT3);
+    if (mLayout == Layout::Full)
+        return;
+
+    GLState().BindFramebuffer(GL_READ_FRAMEBUFFER, mGBufferId);
+    GLState().BindFramebuffer(GL_DRAW_FRAMEBUFFER, mDepthCopyFboId);
     glBlitFramebuffer(
-        0, 0, width, height,
-        0, 0, width, height,
-        GL_COLOR_BUFFER_BIT,
-        GL_LINEAR
+        0, 0, static_cast<GLint>(mWidth), static_cast<GLint>(mHeight),
+        0, 0, static_cast<GLint>(mWidth), static_cast<GLint>(mHeight),
+        GL_DEPTH_BUFFER_BIT,
+        GL_NEAREST
     );
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState().BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 GLuint GBuffer::Id() const
@@ -140,6 +194,11 @@ GLuint GBuffer::Id() const
     return mGBufferId;
 }
 
+GBuffer::Layout GBuffer::GetLayout() const
+{
+    return mLayout;
+}
+
 GLuint GBuffer::PosId() const
 {
     return mPositionBufId;
@@ -165,6 +224,11 @@ GLuint GBuffer::DepthStencilId() const
     return mDepthStencilBufId;
 }
 
+GLuint GBuffer::DepthCopyId() const
+{
+    return mDepthCopyBufId;
+}
+
 GLuint GBuffer::FinalId() const
 {
     return mFinalBufId;
@@ -36,8 +36,19 @@
 class GBuffer
 {
     public:
+        // The ways the geometry pass data is stored
+        enum class Layout
+        {
+            Full,   // Float position and normal buffers and a 32 bit material index
+            Compact // Position reconstructed from depth, octahedral normals and an 8 bit material index
+                    // packed with the roughness and metallic factors, shaders need GBUFFER_COMPACT defined
+        };
+
+        // Retrieves the bytes per pixel the light pass samples with the given layout
+        static unsigned int BytesPerPixel(Layout layout);
+
         // Constructor
-        GBuffer(unsigned int width, unsigned int height);
+        GBuffer(unsigned int width, unsigned int height, Layout layout = Layout::Full);
 
         // Destructor
         ~GBuffer();
@@ -51,13 +62,16 @@ class GBuffer
         // Sets the GBuffer mode by binding the relevant internal data
         void PrepareFor(Mode mode);
 
-        // Copies the final texture to the default framebuffer
-        void CopyResultToDefault(int width, int height);
+        // Copies the depth to the texture the light pass samples, does nothing with the full layout
+        void CopyDepth();
 
         // Retrieves the internal GBuffer id
         GLuint Id() const;
 
-        // Retrieves the position buffer id
+        // Retrieves the layout of the buffers
+        Layout GetLayout() const;
+
+        // Retrieves the position buffer id, zero with the compact layout
         GLuint PosId() const;
 
         // Retrieves the normal buffer id
@@ -66,16 +80,23 @@ class GBuffer
         // Retrieves the albedo-specular buffer id
         GLuint AlbedoSpecId() const;
 
-        // Retrieves the material index buffer id
+        // Retrieves the material index buffer id, also holding roughness and metallic with the compact layout
         GLuint MatIndexId() const;
 
         // Retrieves the depth-stencil buffer id
         GLuint DepthStencilId() const;
 
+        // Retrieves the depth copy buffer id, zero with the full layout
+        GLuint DepthCopyId() const;
+
         // Retrieves the final buffer id
         GLuint FinalId() const;
 
     private:
+        // The layout of the buffers
+        Layout mLayout;
+        // The size of the buffers
+        unsigned int mWidth, mHeight;
         // The GBuffer's framebuffer id
         GLuint mGBufferId;
         // The position, normal and albedo + specular buffer ids'
@@ -84,6 +105,8 @@ class GBuffer
         GLuint mMatIndexBufId;
         // The depth + stencil buffer id
         GLuint mDepthStencilBufId;
+        // The depth copy framebuffer and buffer ids, the depth-stencil buffer cannot be sampled while attached
+        GLuint mDepthCopyFboId, mDepthCopyBufId;
         // The final buffer
         GLuint mFinalBufId;
 };
@@ -0,0 +1,458 @@
+#include "GLStateCache.hpp"
+#include "RenderStats.hpp"
+
+// Bound by reference through std::array::fill, so it needs a definition in C++14
+const GLuint GLStateCache::Unknown;
+
+GLStateCache::GLStateCache()
+{
+    mDefaultFramebuffer = 0;
+    mFrameStats = {0, 0};
+    mLastFrameStats = {0, 0};
+    Invalidate();
+}
+
+bool GLStateCache::Changed(bool differs)
+{
+    if (differs)
+        ++mFrameStats.issued;
+    else
+        ++mFrameStats.skipped;
+    return differs;
+}
+
+int GLStateCache::BufferTargetIndex(GLenum target)
+{
+    switch (target)
+    {
+        case GL_ARRAY_BUFFER:
+            return 0;
+        case GL_UNIFORM_BUFFER:
+            return 1;
+        case GL_TEXTURE_BUFFER:
+            return 2;
+        default:
+            return -1;
+    }
+}
+
+int GLStateCache::TextureTargetIndex(GLenum target)
+{
+    switch (target)
+    {
+        case GL_TEXTURE_2D:
+            return 0;
+        case GL_TEXTURE_2D_ARRAY:
+            return 1;
+        case GL_TEXTURE_CUBE_MAP:
+            return 2;
+        case GL_TEXTURE_BUFFER:
+            return 3;
+        default:
+            return -1;
+    }
+}
+
+//--------------------------------------------------
+// Bindings
+//--------------------------------------------------
+void GLStateCache::UseProgram(GLuint program)
+{
+    if (Changed(mProgram != program))
+    {
+        glUseProgram(program);
+        mProgram = program;
+        RenderStats().CountProgramBind();
+    }
+}
+
+void GLStateCache::BindVertexArray(GLuint vao)
+{
+    if (Changed(mVao != vao))
+    {
+        glBindVertexArray(vao);
+        mVao = vao;
+        RenderStats().CountVaoBind();
+    }
+}
+
+void GLStateCache::BindBuffer(GLenum target, GLuint buffer)
+{
+    if (target == GL_ELEMENT_ARRAY_BUFFER)
+    {
+        // The element buffer binding is part of the bound VAO
+        auto it = mElementBuffers.find(mVao);
+        bool differs = mVao == Unknown || it == std::end(mElementBuffers) || it->second != buffer;
+        if (Changed(differs))
+        {
+            glBindBuffer(target, buffer);
+            if (mVao != Unknown)
+                mElementBuffers[mVao] = buffer;
+        }
+        return;
+    }
+
+    int idx = BufferTargetIndex(target);
+    if (idx < 0)
+    {
+        Changed(true);
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (Changed(mBuffers[idx] != buffer))
+    {
+        glBindBuffer(target, buffer);
+        mBuffers[idx] = buffer;
+    }
+}
+
+void GLStateCache::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+    // Indexed bindings are not shadowed, but they also replace the generic binding point
+    Changed(true);
+    glBindBufferBase(target, index, buffer);
+    int idx = BufferTargetIndex(target);
+    if (idx >= 0)
+        mBuffers[idx] = buffer;
+}
+
+void GLStateCache::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    if (framebuffer == 0)
+        framebuffer = mDefaultFramebuffer;
+
+    bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+    bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+    bool differs = (draw && mDrawFramebuffer != framebuffer) || (read && mReadFramebuffer != framebuffer);
+    if (Changed(differs))
+    {
+        glBindFramebuffer(target, framebuffer);
+        if (draw)
+            mDrawFramebuffer = framebuffer;
+        if (read)
+            mReadFramebuffer = framebuffer;
+    }
+}
+
+void GLStateCache::ActiveTexture(GLenum unit)
+{
+    if (Changed(mActiveTexture != unit))
+    {
+        glActiveTexture(unit);
+        mActiveTexture = unit;
+    }
+}
+
+void GLStateCache::BindTexture(GLenum target, GLuint texture)
+{
+    int idx = TextureTargetIndex(target);
+    std::size_t unit = mActiveTexture - GL_TEXTURE0;
+    if (idx < 0 || mActiveTexture == Unknown || unit >= MaxTextureUnits)
+    {
+        Changed(true);
+        glBindTexture(target, texture);
+        RenderStats().CountTextureBind();
+        return;
+    }
+    GLuint& bound = mTextures[unit][idx];
+    if (Changed(bound != texture))
+    {
+        glBindTexture(target, texture);
+        bound = texture;
+        RenderStats().CountTextureBind();
+    }
+}
+
+//--------------------------------------------------
+// Capabilities
+//--------------------------------------------------
+void GLStateCache::Enable(GLenum cap)
+{
+    SetEnabled(cap, true);
+}
+
+void GLStateCache::Disable(GLenum cap)
+{
+    SetEnabled(cap, false);
+}
+
+void GLStateCache::SetEnabled(GLenum cap, bool enabled)
+{
+    auto it = mCaps.find(cap);
+    if (Changed(it == std::end(mCaps) || it->second != enabled))
+    {
+        if (enabled)
+            glEnable(cap);
+        else
+            glDisable(cap);
+        mCaps[cap] = enabled;
+    }
+}
+
+bool GLStateCache::IsEnabled(GLenum cap)
+{
+    auto it = mCaps.find(cap);
+    if (it != std::end(mCaps))
+        return it->second;
+    bool enabled = glIsEnabled(cap) == GL_TRUE;
+    mCaps[cap] = enabled;
+    return enabled;
+}
+
+//--------------------------------------------------
+// Fixed function state
+//--------------------------------------------------
+void GLStateCache::BlendFunc(GLenum sfactor, GLenum dfactor)
+{
+    if (Changed(mBlendSrc != sfactor || mBlendDst != dfactor))
+    {
+        glBlendFunc(sfactor, dfactor);
+        mBlendSrc = sfactor;
+        mBlendDst = dfactor;
+    }
+}
+
+void GLStateCache::BlendEquation(GLenum mode)
+{
+    if (Changed(mBlendEquation != mode))
+    {
+        glBlendEquation(mode);
+        mBlendEquation = mode;
+    }
+}
+
+void GLStateCache::DepthMask(GLboolean flag)
+{
+    if (Changed(mDepthMask != flag))
+    {
+        glDepthMask(flag);
+        mDepthMask = flag;
+    }
+}
+
+void GLStateCache::DepthFunc(GLenum func)
+{
+    if (Changed(mDepthFunc != func))
+    {
+        glDepthFunc(func);
+        mDepthFunc = func;
+    }
+}
+
+void GLStateCache::CullFace(GLenum mode)
+{
+    if (Changed(mCullFace != mode))
+    {
+        glCullFace(mode);
+        mCullFace = mode;
+    }
+}
+
+void GLStateCache::StencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+    if (Changed(mStencilFunc != func || mStencilRef != ref || mStencilMask != mask))
+    {
+        glStencilFunc(func, ref, mask);
+        mStencilFunc = func;
+        mStencilRef = ref;
+        mStencilMask = mask;
+    }
+}
+
+void GLStateCache::StencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass)
+{
+    const std::array<GLenum, 3> ops = {{sfail, dpfail, dppass}};
+    bool front = face == GL_FRONT || face == GL_FRONT_AND_BACK;
+    bool back = face == GL_BACK || face == GL_FRONT_AND_BACK;
+    bool differs = (front && mStencilOps[0] != ops) || (back && mStencilOps[1] != ops);
+    if (Changed(differs))
+    {
+        glStencilOpSeparate(face, sfail, dpfail, dppass);
+        if (front)
+            mStencilOps[0] = ops;
+        if (back)
+            mStencilOps[1] = ops;
+    }
+}
+
+void GLStateCache::PolygonMode(GLenum mode)
+{
+    if (Changed(mPolygonMode != mode))
+    {
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+        mPolygonMode = mode;
+    }
+}
+
+void GLStateCache::Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    const std::array<GLint, 4> viewport = {{x, y, width, height}};
+    if (Changed(!mViewportKnown || mViewport != viewport))
+    {
+        glViewport(x, y, width, height);
+        mViewport = viewport;
+        mViewportKnown = true;
+    }
+}
+
+//--------------------------------------------------
+// Object deletion
+//--------------------------------------------------
+void GLStateCache::DeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    glDeleteBuffers(n, buffers);
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        for (auto& bound : mBuffers)
+            if (bound == buffers[i])
+                bound = 0;
+        for (auto it = std::begin(mElementBuffers); it != std::end(mElementBuffers);)
+        {
+            if (it->second == buffers[i])
+                it = mElementBuffers.erase(it);
+            else
+                ++it;
+        }
+    }
+}
+
+void GLStateCache::DeleteVertexArrays(GLsizei n, const GLuint* vaos)
+{
+    glDeleteVertexArrays(n, vaos);
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        if (mVao == vaos[i])
+            mVao = 0;
+        mElementBuffers.erase(vaos[i]);
+    }
+}
+
+void GLStateCache::DeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+    glDeleteFramebuffers(n, framebuffers);
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        if (mDrawFramebuffer == framebuffers[i])
+            mDrawFramebuffer = 0;
+        if (mReadFramebuffer == framebuffers[i])
+            mReadFramebuffer = 0;
+    }
+}
+
+void GLStateCache::DeleteTextures(GLsizei n, const GLuint* textures)
+{
+    glDeleteTextures(n, textures);
+    for (GLsizei i = 0; i < n; ++i)
+        for (auto& unit : mTextures)
+            for (auto& bound : unit)
+                if (bound == textures[i])
+                    bound = 0;
+}
+
+//--------------------------------------------------
+// Queries
+//--------------------------------------------------
+GLuint GLStateCache::CurrentProgram()
+{
+    if (mProgram == Unknown)
+    {
+        GLint program;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+        mProgram = static_cast<GLuint>(program);
+    }
+    return mProgram;
+}
+
+void GLStateCache::GetBlendFunc(GLenum& sfactor, GLenum& dfactor)
+{
+    if (mBlendSrc == Unknown || mBlendDst == Unknown)
+    {
+        GLint src, dst;
+        glGetIntegerv(GL_BLEND_SRC_RGB, &src);
+        glGetIntegerv(GL_BLEND_DST_RGB, &dst);
+        mBlendSrc = static_cast<GLenum>(src);
+        mBlendDst = static_cast<GLenum>(dst);
+    }
+    sfactor = mBlendSrc;
+    dfactor = mBlendDst;
+}
+
+GLenum GLStateCache::GetPolygonMode()
+{
+    if (mPolygonMode == Unknown)
+    {
+        GLint modes[2];
+        glGetIntegerv(GL_POLYGON_MODE, modes);
+        mPolygonMode = static_cast<GLenum>(modes[0]);
+    }
+    return mPolygonMode;
+}
+
+const std::array<GLint, 4>& GLStateCache::GetViewport()
+{
+    if (!mViewportKnown)
+    {
+        glGetIntegerv(GL_VIEWPORT, mViewport.data());
+        mViewportKnown = true;
+    }
+    return mViewport;
+}
+
+//--------------------------------------------------
+// Bookkeeping
+//--------------------------------------------------
+void GLStateCache::SetDefaultFramebuffer(GLuint framebuffer)
+{
+    mDefaultFramebuffer = framebuffer;
+}
+
+void GLStateCache::Invalidate()
+{
+    mProgram = Unknown;
+    mVao = Unknown;
+    mBuffers.fill(Unknown);
+    mElementBuffers.clear();
+    mDrawFramebuffer = Unknown;
+    mReadFramebuffer = Unknown;
+    mActiveTexture = Unknown;
+    for (auto& unit : mTextures)
+        unit.fill(Unknown);
+
+    mCaps.clear();
+
+    mBlendSrc = Unknown;
+    mBlendDst = Unknown;
+    mBlendEquation = Unknown;
+    mDepthMask = Unknown;
+    mDepthFunc = Unknown;
+    mCullFace = Unknown;
+    mStencilFunc = Unknown;
+    mStencilRef = -1;
+    mStencilMask = Unknown;
+    for (auto& ops : mStencilOps)
+        ops.fill(Unknown);
+    mPolygonMode = Unknown;
+    mViewportKnown = false;
+}
+
+void GLStateCache::NewFrame()
+{
+    mLastFrameStats = mFrameStats;
+    mFrameStats = {0, 0};
+}
+
+const GLStateCache::Stats& GLStateCache::GetFrameStats() const
+{
+    return mFrameStats;
+}
+
+const GLStateCache::Stats& GLStateCache::GetLastFrameStats() const
+{
+    return mLastFrameStats;
+}
+
+GLStateCache& GLState()
+{
+    static GLStateCache cache;
+    return cache;
+}
@@ -0,0 +1,157 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _GL_STATE_CACHE_HPP_
+#define _GL_STATE_CACHE_HPP_
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <glad/glad.h>
+
+// Shadows the GL binding and fixed function state so that redundant state changes never reach the driver.
+// All the code touching GL state must go through it, as state changed behind its back would make it skip needed calls.
+class GLStateCache
+{
+    public:
+        // Counters of the state changes requested through the cache
+        struct Stats
+        {
+            std::uint64_t issued,
+                          skipped;
+        };
+
+        // Constructor
+        GLStateCache();
+
+        // Bindings
+        void UseProgram(GLuint program);
+        void BindVertexArray(GLuint vao);
+        void BindBuffer(GLenum target, GLuint buffer);
+        void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+        void BindFramebuffer(GLenum target, GLuint framebuffer);
+        void ActiveTexture(GLenum unit);
+        void BindTexture(GLenum target, GLuint texture);
+
+        // Capabilities
+        void Enable(GLenum cap);
+        void Disable(GLenum cap);
+        void SetEnabled(GLenum cap, bool enabled);
+        bool IsEnabled(GLenum cap);
+
+        // Fixed function state
+        void BlendFunc(GLenum sfactor, GLenum dfactor);
+        void BlendEquation(GLenum mode);
+        void DepthMask(GLboolean flag);
+        void DepthFunc(GLenum func);
+        void CullFace(GLenum mode);
+        void StencilFunc(GLenum func, GLint ref, GLuint mask);
+        void StencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass);
+        void PolygonMode(GLenum mode);
+        void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+        // Object deletion, resetting the bindings of the deleted objects as GL does
+        void DeleteBuffers(GLsizei n, const GLuint* buffers);
+        void DeleteVertexArrays(GLsizei n, const GLuint* vaos);
+        void DeleteFramebuffers(GLsizei n, const GLuint* framebuffers);
+        void DeleteTextures(GLsizei n, const GLuint* textures);
+
+        // Queries, answered from the cache and falling back to the driver only for unknown state
+        GLuint CurrentProgram();
+        void GetBlendFunc(GLenum& sfactor, GLenum& dfactor);
+        GLenum GetPolygonMode();
+        const std::array<GLint, 4>& GetViewport();
+
+        // Sets the framebuffer bound in place of the default one, for rendering offscreen
+        void SetDefaultFramebuffer(GLuint framebuffer);
+
+        // Forgets all the cached state, forcing the next change of every state to be issued
+        void Invalidate();
+
+        // Starts a new frame, closing the counters of the previous one. The cached state carries over
+        void NewFrame();
+
+        // Counters of the frame in progress and of the last completed frame
+        const Stats& GetFrameStats() const;
+        const Stats& GetLastFrameStats() const;
+
+    private:
+        // Value of cached state that is not known
+        static const GLuint Unknown = ~0u;
+        // Number of texture units shadowed
+        static const std::size_t MaxTextureUnits = 32;
+        // Number of texture targets shadowed per unit
+        static const std::size_t MaxTextureTargets = 4;
+
+        // Accounts a requested change, returning whether it should be issued
+        bool Changed(bool differs);
+
+        // Index of the given buffer or texture target in the shadowed arrays, -1 if not shadowed
+        static int BufferTargetIndex(GLenum target);
+        static int TextureTargetIndex(GLenum target);
+
+        // Bindings
+        GLuint mProgram;
+        GLuint mVao;
+        std::array<GLuint, 3> mBuffers;
+        std::unordered_map<GLuint, GLuint> mElementBuffers; // Element buffers are VAO state
+        GLuint mDrawFramebuffer,
+               mReadFramebuffer,
+               mDefaultFramebuffer;
+        GLenum mActiveTexture;
+        std::array<std::array<GLuint, MaxTextureTargets>, MaxTextureUnits> mTextures;
+
+        // Capabilities, absent while unknown
+        std::unordered_map<GLenum, bool> mCaps;
+
+        // Fixed function state
+        GLenum mBlendSrc,
+               mBlendDst,
+               mBlendEquation;
+        GLuint mDepthMask;
+        GLenum mDepthFunc;
+        GLenum mCullFace;
+        GLenum mStencilFunc;
+        GLint  mStencilRef;
+        GLuint mStencilMask;
+        std::array<std::array<GLenum, 3>, 2> mStencilOps; // Front and back
+        GLenum mPolygonMode;
+        std::array<GLint, 4> mViewport;
+        bool mViewportKnown;
+
+        // Counters
+        Stats mFrameStats;
+        Stats mLastFrameStats;
+};
+
+// Retrieves the state cache of the current GL context
+GLStateCache& GLState();
+
+#endif // ! _GL_STATE_CACHE_HPP_
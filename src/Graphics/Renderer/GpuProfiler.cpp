@@ -0,0 +1,161 @@
+#include "GpuProfiler.hpp"
+#include "../../Util/Timer.hpp"
+
+namespace
+{
+// The GPU clock drifts from the CPU one, so their offset is measured again every so often
+const std::uint32_t CalibrationInterval = 256;
+}
+
+GpuProfiler::GpuProfiler()
+    : mCurrent(0)
+    , mDepth(0)
+    , mTrack(nullptr)
+    , mClockOffset(0)
+    , mFramesSinceCalibration(0)
+    , mDroppedFrames(0)
+    , mInitialized(false)
+{
+}
+
+void GpuProfiler::Init()
+{
+    for (Frame& frame : mFrames)
+    {
+        glGenQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+        frame.zoneCount = 0;
+        frame.pending = false;
+    }
+    mCurrent = 0;
+    mDepth = 0;
+
+    if (mTrack == nullptr)
+        mTrack = Profiler::CreateTrack("GPU");
+    Calibrate();
+    mInitialized = true;
+}
+
+void GpuProfiler::Shutdown()
+{
+    if (!mInitialized)
+        return;
+    for (Frame& frame : mFrames)
+        glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+    mInitialized = false;
+}
+
+void GpuProfiler::BeginFrame()
+{
+    if (!mInitialized)
+        return;
+
+    // Zones left open close with the frame
+    while (mDepth != 0)
+        EndZone();
+
+    // Reuse the oldest frame, its queries were issued FrameLatency frames ago
+    mCurrent = (mCurrent + 1) % FrameLatency;
+    Frame& frame = mFrames[mCurrent];
+    if (frame.pending && !Resolve(frame))
+        ++mDroppedFrames;
+    frame.zoneCount = 0;
+    frame.pending = false;
+
+    if (++mFramesSinceCalibration >= CalibrationInterval)
+        Calibrate();
+}
+
+void GpuProfiler::BeginZone(const char* name)
+{
+    if (!mInitialized)
+        return;
+
+    if (mDepth < MaxDepth)
+    {
+        Frame& frame = mFrames[mCurrent];
+        const std::size_t zone = frame.zoneCount;
+        if (zone < MaxZones)
+        {
+            frame.zones[zone] = FrameZone{name, static_cast<std::uint32_t>(mDepth)};
+            glQueryCounter(frame.queries[zone * 2], GL_TIMESTAMP);
+            frame.lastQuery = frame.queries[zone * 2];
+            ++frame.zoneCount;
+            frame.pending = true;
+        }
+        mOpen[mDepth] = zone;
+    }
+    ++mDepth;
+}
+
+void GpuProfiler::EndZone()
+{
+    if (!mInitialized || mDepth == 0)
+        return;
+
+    --mDepth;
+    if (mDepth < MaxDepth && mOpen[mDepth] < MaxZones)
+    {
+        Frame& frame = mFrames[mCurrent];
+        frame.lastQuery = frame.queries[mOpen[mDepth] * 2 + 1];
+        glQueryCounter(frame.lastQuery, GL_TIMESTAMP);
+    }
+}
+
+void GpuProfiler::Flush()
+{
+    if (!mInitialized)
+        return;
+
+    // Zones left open close with the frame
+    while (mDepth != 0)
+        EndZone();
+
+    glFinish();
+    for (std::size_t i = 1; i <= FrameLatency; ++i)
+    {
+        // Oldest frame first, ending with the current one
+        Frame& frame = mFrames[(mCurrent + i) % FrameLatency];
+        if (frame.pending && !Resolve(frame))
+            ++mDroppedFrames;
+        frame.zoneCount = 0;
+        frame.pending = false;
+    }
+}
+
+std::uint64_t GpuProfiler::GetDroppedFrames() const
+{
+    return mDroppedFrames;
+}
+
+//--------------------------------------------------
+// Private functions
+//--------------------------------------------------
+bool GpuProfiler::Resolve(Frame& frame)
+{
+    // Timestamps complete in order, so all of them are available once the last one is
+    GLint available = 0;
+    glGetQueryObjectiv(frame.lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+        return false;
+
+    for (std::size_t i = 0; i < frame.zoneCount; ++i)
+    {
+        GLint64 start = 0, end = 0;
+        glGetQueryObjecti64v(frame.queries[i * 2], GL_QUERY_RESULT, &start);
+        glGetQueryObjecti64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+        Profiler::RecordZone(mTrack, Profiler::Zone{frame.zones[i].name,
+                                                    start + mClockOffset,
+                                                    end + mClockOffset,
+                                                    frame.zones[i].depth});
+    }
+    return true;
+}
+
+void GpuProfiler::Calibrate()
+{
+    // Reads the GPU time once the preceding commands have reached the GPU, without waiting on them
+    GLint64 gpuTime = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+    mClockOffset = MonotonicTimeNs() - gpuTime;
+    mFramesSinceCalibration = 0;
+}
@@ -0,0 +1,151 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _GPU_PROFILER_HPP_
+#define _GPU_PROFILER_HPP_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+#include "../../Core/Profiler.hpp"
+
+// Times GPU work with timestamp queries placed around each zone. The results are read back a few frames later,
+// once they are available, so the pipeline is never stalled, and are recorded on a "GPU" profiler track.
+class GpuProfiler
+{
+    public:
+        // Constructor
+        GpuProfiler();
+
+        // Creates the timestamp queries
+        void Init();
+
+        // Deletes the timestamp queries
+        void Shutdown();
+
+        // Reads back the zones of the oldest frame in flight and starts recording a new one
+        void BeginFrame();
+
+        // Opens a zone, the name must outlive the profiler
+        void BeginZone(const char* name);
+
+        // Closes the latest opened zone
+        void EndZone();
+
+        // Waits for the frames in flight and records their zones, stalling the pipeline
+        void Flush();
+
+        // Number of frames whose zones were dropped because their queries were still pending
+        std::uint64_t GetDroppedFrames() const;
+
+    private:
+        // Frames in flight before their queries are read back
+        static const std::size_t FrameLatency = 4;
+
+        // Zones kept per frame, the rest are not timed
+        static const std::size_t MaxZones = 64;
+
+        // Deepest zone nesting
+        static const std::size_t MaxDepth = 16;
+
+        struct FrameZone
+        {
+            const char*   name;
+            std::uint32_t depth;
+        };
+
+        // The queries of a frame, two per zone
+        struct Frame
+        {
+            std::array<GLuint, MaxZones * 2> queries;
+            std::array<FrameZone, MaxZones> zones;
+            std::size_t zoneCount = 0;
+            GLuint lastQuery = 0;
+            bool pending = false;
+        };
+
+        //--------------------------------------------------
+        // Private functions
+        //--------------------------------------------------
+        // Records the zones of the frame if its queries are available, returns false otherwise
+        bool Resolve(Frame& frame);
+
+        // Measures the offset between the GPU and the CPU clock
+        void Calibrate();
+
+        std::array<Frame, FrameLatency> mFrames;
+        std::size_t mCurrent;
+
+        // Zones opened and not yet closed in the current frame, as indices in its zones
+        std::array<std::size_t, MaxDepth> mOpen;
+        std::size_t mDepth;
+
+        // The track the resolved zones are recorded to
+        Profiler::Track* mTrack;
+
+        // CPU clock minus GPU clock, in nsec
+        std::int64_t mClockOffset;
+        std::uint32_t mFramesSinceCalibration;
+
+        std::uint64_t mDroppedFrames;
+        bool mInitialized;
+};
+
+// Times the enclosing scope on the GPU
+class GpuProfileScope
+{
+    public:
+        GpuProfileScope(GpuProfiler& profiler, const char* name)
+            : mProfiler(Profiler::IsEnabled() ? &profiler : nullptr)
+        {
+            if (mProfiler)
+                mProfiler->BeginZone(name);
+        }
+
+        ~GpuProfileScope()
+        {
+            if (mProfiler)
+                mProfiler->EndZone();
+        }
+
+        GpuProfileScope(const GpuProfileScope&) = delete;
+        GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+    private:
+        GpuProfiler* mProfiler;
+};
+
+// Times the enclosing scope both on the CPU and on the GPU, as zones with the given name
+#define PROFILE_GPU_SCOPE(gpuProfiler, name) \
+    PROFILE_SCOPE(name); \
+    GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(gpuProfiler, name)
+
+#endif // ! _GPU_PROFILER_HPP_
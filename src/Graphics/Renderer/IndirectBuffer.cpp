@@ -0,0 +1,75 @@
+#include "IndirectBuffer.hpp"
+#include "GLStateCache.hpp"
+#include "RenderStats.hpp"
+
+bool IndirectBuffer::IsSupported()
+{
+    // Base instances came with 4.2 and multi draw indirect with 4.3
+    return GLAD_GL_VERSION_4_3 != 0;
+}
+
+void IndirectBuffer::Init()
+{
+    if (IsSupported())
+        glGenBuffers(1, &mBufferId);
+}
+
+void IndirectBuffer::Shutdown()
+{
+    if (mBufferId != 0)
+        GLState().DeleteBuffers(1, &mBufferId);
+    mBufferId = 0;
+}
+
+bool IndirectBuffer::IsAvailable() const
+{
+    return mBufferId != 0;
+}
+
+void IndirectBuffer::Upload(const std::vector<InstanceBuffer::Batch>& batches)
+{
+    mCommands.resize(batches.size());
+    for (std::size_t i = 0; i < batches.size(); ++i)
+    {
+        const InstanceBuffer::Batch& batch = batches[i];
+        Command& cmd = mCommands[i];
+        cmd.count         = batch.numIndices;
+        cmd.instanceCount = static_cast<GLuint>(batch.count);
+        cmd.firstIndex    = batch.firstIndex;
+        cmd.baseVertex    = batch.baseVertex;
+        cmd.baseInstance  = static_cast<GLuint>(batch.first);
+    }
+
+    const std::size_t bytes = mCommands.size() * sizeof(Command);
+    GLState().BindBuffer(GL_DRAW_INDIRECT_BUFFER, mBufferId);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, bytes, mCommands.data());
+    RenderStats().CountBufferUpload(bytes);
+}
+
+void IndirectBuffer::Bind()
+{
+    GLState().BindBuffer(GL_DRAW_INDIRECT_BUFFER, mBufferId);
+}
+
+void IndirectBuffer::Draw(std::size_t first, std::size_t count)
+{
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+        (GLvoid*)(first * sizeof(Command)), static_cast<GLsizei>(count), 0);
+
+    RenderStats().CountDrawCall();
+    for (std::size_t i = first; i < first + count; ++i)
+        RenderStats().CountPrimitives(GL_TRIANGLES, static_cast<GLsizei>(mCommands[i].count),
+                                      static_cast<GLsizei>(mCommands[i].instanceCount));
+}
+
+std::size_t BatchRunEnd(const std::vector<InstanceBuffer::Batch>& batches, std::size_t first)
+{
+    std::size_t end = first + 1;
+    while (end < batches.size()
+        && batches[end].group == batches[first].group
+        && batches[end].vaoId == batches[first].vaoId
+        && batches[end].eboId == batches[first].eboId)
+        ++end;
+    return end;
+}
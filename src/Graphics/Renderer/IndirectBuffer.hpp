@@ -0,0 +1,87 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _INDIRECT_BUFFER_HPP_
+#define _INDIRECT_BUFFER_HPP_
+
+#include <vector>
+#include <glad/glad.h>
+#include "InstanceBuffer.hpp"
+
+// Stores an indirect draw command per instanced batch, so that runs of batches sharing their geometry buffers
+// are submitted with a single glMultiDrawElementsIndirect call. The first instance of each batch becomes the
+// base instance of its command, which offsets the instance attribute fetches, so the instance attributes are
+// pointed at the start of the instance buffer once per run. Needs GL 4.3, renderers draw each batch without it
+class IndirectBuffer
+{
+    public:
+        // The command layout read by glMultiDrawElementsIndirect
+        struct Command
+        {
+            GLuint count;
+            GLuint instanceCount;
+            GLuint firstIndex;
+            GLint  baseVertex;
+            GLuint baseInstance;
+        };
+
+        // True when the current context supports multi draw indirect
+        static bool IsSupported();
+
+        // Creates the buffer when supported
+        void Init();
+
+        // Destroys the buffer
+        void Shutdown();
+
+        // True when initialized on a context that supports it
+        bool IsAvailable() const;
+
+        // Writes a command per batch, in the same order, and uploads them orphaning the previous storage
+        void Upload(const std::vector<InstanceBuffer::Batch>& batches);
+
+        // Binds the command buffer as the indirect draw buffer
+        void Bind();
+
+        // Draws the triangles of the given range of uploaded batches, which must share the bound VAO and index buffer
+        void Draw(std::size_t first, std::size_t count);
+
+    private:
+        // The command buffer
+        GLuint mBufferId = 0;
+
+        // The commands of the last upload
+        std::vector<Command> mCommands;
+};
+
+// Retrieves the end of the run of batches starting at first that share the group and the geometry buffers
+std::size_t BatchRunEnd(const std::vector<InstanceBuffer::Batch>& batches, std::size_t first);
+
+#endif // ! _INDIRECT_BUFFER_HPP_
@@ -0,0 +1,49 @@
+#include "InstanceBuffer.hpp"
+#include "GLStateCache.hpp"
+#include "RenderStats.hpp"
+#include "../../Core/JobSystem.hpp"
+
+void InstanceBuffer::Init()
+{
+    glGenBuffers(1, &mVboId);
+}
+
+void InstanceBuffer::Shutdown()
+{
+    GLState().DeleteBuffers(1, &mVboId);
+}
+
+void InstanceBuffer::Upload(const std::vector<glm::mat4>& instances)
+{
+    GLState().BindBuffer(GL_ARRAY_BUFFER, mVboId);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(glm::mat4), instances.data());
+    RenderStats().CountBufferUpload(instances.size() * sizeof(glm::mat4));
+    GLState().BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBuffer::BindAttributes(std::size_t first)
+{
+    GLState().BindBuffer(GL_ARRAY_BUFFER, mVboId);
+    for (GLuint i = 0; i < 4; ++i)
+    {
+        GLuint loc = AttribLocation + i;
+        glEnableVertexAttribArray(loc);
+        glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+            (GLvoid*)(first * sizeof(glm::mat4) + i * sizeof(glm::vec4)));
+        glVertexAttribDivisor(loc, 1);
+    }
+}
+
+void InterpolateInstances(JobSystem* jobs, const WorldTransforms& transforms,
+    const std::vector<std::uint32_t>& sources, float interpolation, std::vector<glm::mat4>& instances)
+{
+    instances.resize(sources.size());
+    ParallelFor(jobs, sources.size(), 1024,
+        [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+                instances[i] = transforms.Interpolated(sources[i], interpolation);
+        }
+    );
+}
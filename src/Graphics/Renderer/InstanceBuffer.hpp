@@ -0,0 +1,85 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _INSTANCE_BUFFER_HPP_
+#define _INSTANCE_BUFFER_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+#include "../Scene/TransformHierarchy.hpp"
+
+#include "../../Util/WarnGuard.hpp"
+WARN_GUARD_ON
+#include <glm/glm.hpp>
+WARN_GUARD_OFF
+
+class InstanceBuffer
+{
+    public:
+        // First of the 4 consecutive attribute locations used by the instance model matrix
+        static const GLuint AttribLocation = 4;
+
+        // A run of instances sharing the same geometry
+        struct Batch
+        {
+            std::size_t group;
+            GLuint      vaoId,
+                        eboId,
+                        numIndices;
+            GLint       baseVertex;
+            GLuint      firstIndex;
+            std::size_t first,
+                        count;
+        };
+
+        // Creates the buffer
+        void Init();
+
+        // Destroys the buffer
+        void Shutdown();
+
+        // Uploads the given instance matrices, orphaning the previous storage
+        void Upload(const std::vector<glm::mat4>& instances);
+
+        // Points the instance matrix attributes of the bound VAO to the instance at the given index
+        void BindAttributes(std::size_t first);
+
+    private:
+        // The instance data vbo
+        GLuint mVboId;
+};
+
+// Fills the instance matrices with the interpolated world matrices of the given transforms,
+// split over the job system when one is given
+void InterpolateInstances(JobSystem* jobs, const WorldTransforms& transforms,
+    const std::vector<std::uint32_t>& sources, float interpolation, std::vector<glm::mat4>& instances);
+
+#endif // ! _INSTANCE_BUFFER_HPP_
@@ -0,0 +1,12 @@
+#include "Light.hpp"
+#include <cmath>
+
+float CalcPointLightBSphere(const PointLight& light)
+{
+    float MaxChannel = fmax(fmax(light.color.r, light.color.g), light.color.b);
+    float ret =
+        (-light.attProps.linear
+         +sqrtf(light.attProps.linear * light.attProps.linear - 4 * light.attProps.quadratic
+                * (light.attProps.constant - (256.0f / 5.0f) * MaxChannel))) / (2 * light.attProps.quadratic);
+    return ret;
+}
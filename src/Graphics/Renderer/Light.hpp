@@ -80,4 +80,7 @@ struct Lights
     std::vector<SpotLight> spotLights;
 };
 
+// Calculates the radius of the sphere bounding the visible influence of the given point light
+float CalcPointLightBSphere(const PointLight& light);
+
 #endif // ! _LIGHT_HPP_
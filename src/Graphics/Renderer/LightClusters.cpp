@@ -0,0 +1,178 @@
+#include "LightClusters.hpp"
+#include <algorithm>
+#include <cmath>
+#include "GLStateCache.hpp"
+#include "RenderStats.hpp"
+
+void LightClusters::Init()
+{
+    const GLenum formats[3] = { GL_RG32UI, GL_R32UI, GL_RGBA32F };
+
+    glGenBuffers(3, mBufferIds);
+    glGenTextures(3, mTextureIds);
+    for (int i = 0; i < 3; ++i)
+    {
+        Upload(mBufferIds[i], nullptr, 0);
+        GLState().BindTexture(GL_TEXTURE_BUFFER, mTextureIds[i]);
+        glTexBuffer(GL_TEXTURE_BUFFER, formats[i], mBufferIds[i]);
+    }
+    GLState().BindTexture(GL_TEXTURE_BUFFER, 0);
+
+    mDepthParams = glm::vec2(0.0f);
+    mClusterData.resize(2 * GridX * GridY * GridZ);
+}
+
+void LightClusters::Shutdown()
+{
+    GLState().DeleteTextures(3, mTextureIds);
+    GLState().DeleteBuffers(3, mBufferIds);
+}
+
+void LightClusters::Upload(GLuint buffer, const void* data, std::size_t size)
+{
+    // Never leave a buffer texture without storage
+    GLState().BindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, std::max<std::size_t>(size, 16), nullptr, GL_STREAM_DRAW);
+    if (size != 0)
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+    RenderStats().CountBufferUpload(size);
+}
+
+void LightClusters::Build(const std::vector<PointLight>& lights, const glm::mat4& view, const glm::mat4& projection)
+{
+    // Near and far planes of the perspective projection
+    const float nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+    const float farPlane  = projection[3][2] / (projection[2][2] + 1.0f);
+
+    // Exponential depth slicing, keeping the clusters roughly cubic
+    const float sliceScale = GridZ / std::log(farPlane / nearPlane);
+    mDepthParams = glm::vec2(sliceScale, std::log(nearPlane) * sliceScale);
+    auto sliceOf = [this, nearPlane](float depth) -> int
+    {
+        float slice = std::log(std::max(depth, nearPlane)) * mDepthParams.x - mDepthParams.y;
+        return glm::clamp(static_cast<int>(slice), 0, GridZ - 1);
+    };
+    auto tileOf = [](float ndc, int count) -> int
+    {
+        return glm::clamp(static_cast<int>((ndc * 0.5f + 0.5f) * count), 0, count - 1);
+    };
+
+    mLightRanges.clear();
+    mLightData.clear();
+    std::fill(std::begin(mClusterData), std::end(mClusterData), 0);
+
+    // Find the cluster range of each light and count the lights of each cluster
+    for (const PointLight& light : lights)
+    {
+        const float radius = CalcPointLightBSphere(light);
+        const glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+
+        // Skip the lights outside of the depth range
+        const float minDepth = -center.z - radius;
+        const float maxDepth = -center.z + radius;
+        if (maxDepth < nearPlane || minDepth > farPlane)
+        {
+            mLightRanges.push_back(LightRange{glm::ivec3(0), glm::ivec3(-1)});
+            continue;
+        }
+
+        LightRange range;
+        range.min.z = sliceOf(minDepth);
+        range.max.z = sliceOf(maxDepth);
+
+        if (minDepth <= nearPlane)
+        {
+            // The light reaches the nearPlane plane, and may cover any tile
+            range.min.x = 0;
+            range.min.y = 0;
+            range.max.x = GridX - 1;
+            range.max.y = GridY - 1;
+        }
+        else
+        {
+            // Project the bounding box of the light sphere to find the tiles it covers
+            glm::vec2 ndcMin(1.0f), ndcMax(-1.0f);
+            for (int i = 0; i < 8; ++i)
+            {
+                const glm::vec3 corner = center + radius * glm::vec3(
+                    (i & 1) ? 1.0f : -1.0f,
+                    (i & 2) ? 1.0f : -1.0f,
+                    (i & 4) ? 1.0f : -1.0f);
+                const glm::vec4 clip = projection * glm::vec4(corner, 1.0f);
+                const glm::vec2 ndc = glm::vec2(clip) / clip.w;
+                ndcMin = glm::min(ndcMin, ndc);
+                ndcMax = glm::max(ndcMax, ndc);
+            }
+            if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f)
+            {
+                mLightRanges.push_back(LightRange{glm::ivec3(0), glm::ivec3(-1)});
+                continue;
+            }
+            range.min.x = tileOf(ndcMin.x, GridX);
+            range.min.y = tileOf(ndcMin.y, GridY);
+            range.max.x = tileOf(ndcMax.x, GridX);
+            range.max.y = tileOf(ndcMax.y, GridY);
+        }
+        mLightRanges.push_back(range);
+
+        for (int z = range.min.z; z <= range.max.z; ++z)
+            for (int y = range.min.y; y <= range.max.y; ++y)
+                for (int x = range.min.x; x <= range.max.x; ++x)
+                    ++mClusterData[2 * (x + GridX * (y + GridY * z)) + 1];
+    }
+
+    // Turn the counts into offsets in the light index list
+    GLuint total = 0;
+    for (std::size_t i = 0; i < mClusterData.size(); i += 2)
+    {
+        mClusterData[i] = total;
+        total += mClusterData[i + 1];
+        mClusterData[i + 1] = 0;
+    }
+
+    // Fill in the light indices, counting again to find each cluster's next free slot
+    mLightIndices.resize(total);
+    for (std::size_t l = 0; l < mLightRanges.size(); ++l)
+    {
+        const LightRange& range = mLightRanges[l];
+        for (int z = range.min.z; z <= range.max.z; ++z)
+            for (int y = range.min.y; y <= range.max.y; ++y)
+                for (int x = range.min.x; x <= range.max.x; ++x)
+                {
+                    GLuint* cluster = &mClusterData[2 * (x + GridX * (y + GridY * z))];
+                    mLightIndices[cluster[0] + cluster[1]++] = static_cast<GLuint>(l);
+                }
+    }
+
+    // Pack the light properties
+    for (const PointLight& light : lights)
+    {
+        mLightData.push_back(glm::vec4(light.position, CalcPointLightBSphere(light)));
+        mLightData.push_back(glm::vec4(light.color, light.attProps.constant));
+        mLightData.push_back(glm::vec4(light.attProps.linear, light.attProps.quadratic, 0.0f, 0.0f));
+    }
+
+    // Upload everything
+    Upload(mBufferIds[0], mClusterData.data(), mClusterData.size() * sizeof(GLuint));
+    Upload(mBufferIds[1], mLightIndices.data(), mLightIndices.size() * sizeof(GLuint));
+    Upload(mBufferIds[2], mLightData.data(), mLightData.size() * sizeof(glm::vec4));
+}
+
+void LightClusters::Bind(GLuint firstUnit) const
+{
+    for (GLuint i = 0; i < 3; ++i)
+    {
+        GLState().ActiveTexture(GL_TEXTURE0 + firstUnit + i);
+        GLState().BindTexture(GL_TEXTURE_BUFFER, mTextureIds[i]);
+    }
+}
+
+const glm::vec2& LightClusters::GetDepthParams() const
+{
+    return mDepthParams;
+}
+
+std::size_t LightClusters::GetAssignmentCount() const
+{
+    return mLightIndices.size();
+}
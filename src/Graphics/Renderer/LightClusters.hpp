@@ -0,0 +1,98 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _LIGHT_CLUSTERS_HPP_
+#define _LIGHT_CLUSTERS_HPP_
+
+#include <vector>
+#include <glad/glad.h>
+#include "Light.hpp"
+
+#include "../../Util/WarnGuard.hpp"
+WARN_GUARD_ON
+#include <glm/glm.hpp>
+WARN_GUARD_OFF
+
+// Bins point lights into a grid of view frustum clusters (froxels) on the CPU,
+// and exposes the result to the shaders through texture buffers
+class LightClusters
+{
+    public:
+        // Number of clusters along the screen x and y axes and along the view depth
+        static const int GridX = 16;
+        static const int GridY = 9;
+        static const int GridZ = 24;
+
+        // Number of texels each light occupies in the light data buffer
+        static const int LightTexels = 3;
+
+        // Creates the texture buffers
+        void Init();
+
+        // Destroys the texture buffers
+        void Shutdown();
+
+        // Assigns the given lights to the clusters of the given view and projection and uploads the result
+        void Build(const std::vector<PointLight>& lights, const glm::mat4& view, const glm::mat4& projection);
+
+        // Binds the cluster, light index and light data buffers to the given consecutive texture units
+        void Bind(GLuint firstUnit) const;
+
+        // Parameters mapping a view space depth to a cluster slice, as slice = log(depth) * x - y
+        const glm::vec2& GetDepthParams() const;
+
+        // Number of light to cluster assignments made by the last build
+        std::size_t GetAssignmentCount() const;
+
+    private:
+        // Tile and slice range a light overlaps
+        struct LightRange
+        {
+            glm::ivec3 min, max;
+        };
+
+        // Uploads the given data to the given buffer, orphaning its previous storage
+        static void Upload(GLuint buffer, const void* data, std::size_t size);
+
+        // Buffer and texture of each of the cluster, light index and light data texture buffers
+        GLuint mBufferIds[3];
+        GLuint mTextureIds[3];
+
+        // Depth to slice mapping of the last build
+        glm::vec2 mDepthParams;
+
+        // Per frame data, kept around to avoid reallocating it
+        std::vector<LightRange> mLightRanges;
+        std::vector<GLuint> mClusterData;  // Offset and count pairs
+        std::vector<GLuint> mLightIndices;
+        std::vector<glm::vec4> mLightData;
+};
+
+#endif // ! _LIGHT_CLUSTERS_HPP_
@@ -0,0 +1,149 @@
+#include "PrimitiveCache.hpp"
+#include <cstddef>
+#include "GLStateCache.hpp"
+#include "RenderStats.hpp"
+#include "../../Asset/Geometry/Geometry.hpp"
+
+void PrimitiveCache::Init()
+{
+    GLStateCache& state = GLState();
+
+    // Quad
+    {
+        const GLfloat vertices[] =
+        {
+           -1.0f,  1.0f, 0.0f,
+           -1.0f, -1.0f, 0.0f,
+            1.0f,  1.0f, 0.0f,
+            1.0f, -1.0f, 0.0f
+        };
+
+        glGenVertexArrays(1, &mQuad.vao);
+        glGenBuffers(1, &mQuad.vbo);
+        mQuad.ebo = 0;
+        mQuad.numElements = 4;
+
+        state.BindVertexArray(mQuad.vao);
+        state.BindBuffer(GL_ARRAY_BUFFER, mQuad.vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), nullptr);
+    }
+
+    // Sphere
+    {
+        ModelData sphere = GenUVSphere(1.0f, 16, 16);
+        const auto& vertices = sphere.meshes.front().data;
+        const auto& indices = sphere.meshes.front().indices;
+
+        glGenVertexArrays(1, &mSphere.vao);
+        glGenBuffers(1, &mSphere.vbo);
+        glGenBuffers(1, &mSphere.ebo);
+        mSphere.numElements = static_cast<GLsizei>(indices.size());
+
+        state.BindVertexArray(mSphere.vao);
+        state.BindBuffer(GL_ARRAY_BUFFER, mSphere.vbo);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(VertexData), vertices.data(), GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (GLvoid*)(offsetof(VertexData, vx)));
+        state.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mSphere.ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+    }
+
+    // Unit cube edges, scaled and offset per instance
+    {
+        const GLfloat vertices[] =
+        {
+            0.0f, 0.0f, 0.0f,
+            1.0f, 0.0f, 0.0f,
+            1.0f, 1.0f, 0.0f,
+            0.0f, 1.0f, 0.0f,
+            0.0f, 0.0f, 1.0f,
+            1.0f, 0.0f, 1.0f,
+            1.0f, 1.0f, 1.0f,
+            0.0f, 1.0f, 1.0f
+        };
+        const GLuint indices[] =
+        {
+            0, 1, 1, 2, 2, 3, 3, 0,
+            4, 5, 5, 6, 6, 7, 7, 4,
+            0, 4, 1, 5, 2, 6, 3, 7
+        };
+
+        glGenVertexArrays(1, &mBox.vao);
+        glGenBuffers(1, &mBox.vbo);
+        glGenBuffers(1, &mBox.ebo);
+        glGenBuffers(1, &mBoxInstanceVbo);
+        mBox.numElements = 24;
+
+        state.BindVertexArray(mBox.vao);
+        state.BindBuffer(GL_ARRAY_BUFFER, mBox.vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), nullptr);
+        state.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBox.ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+        // Instance bounds are stored as interleaved min/max pairs
+        state.BindBuffer(GL_ARRAY_BUFFER, mBoxInstanceVbo);
+        glEnableVertexAttribArray(BoxMinAttribLocation);
+        glVertexAttribPointer(BoxMinAttribLocation, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec3), nullptr);
+        glVertexAttribDivisor(BoxMinAttribLocation, 1);
+        glEnableVertexAttribArray(BoxMaxAttribLocation);
+        glVertexAttribPointer(BoxMaxAttribLocation, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec3), (GLvoid*)(sizeof(glm::vec3)));
+        glVertexAttribDivisor(BoxMaxAttribLocation, 1);
+    }
+
+    state.BindVertexArray(0);
+    state.BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void PrimitiveCache::Destroy(Primitive& p)
+{
+    GLStateCache& state = GLState();
+    state.DeleteVertexArrays(1, &p.vao);
+    state.DeleteBuffers(1, &p.vbo);
+    if (p.ebo != 0)
+        state.DeleteBuffers(1, &p.ebo);
+}
+
+void PrimitiveCache::Shutdown()
+{
+    Destroy(mQuad);
+    Destroy(mSphere);
+    Destroy(mBox);
+    GLState().DeleteBuffers(1, &mBoxInstanceVbo);
+}
+
+void PrimitiveCache::RenderQuad() const
+{
+    GLState().BindVertexArray(mQuad.vao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, mQuad.numElements);
+    RenderStats().CountDraw(GL_TRIANGLE_STRIP, mQuad.numElements);
+}
+
+void PrimitiveCache::RenderSphere() const
+{
+    GLState().BindVertexArray(mSphere.vao);
+    glDrawElements(GL_TRIANGLES, mSphere.numElements, GL_UNSIGNED_INT, 0);
+    RenderStats().CountDraw(GL_TRIANGLES, mSphere.numElements);
+}
+
+void PrimitiveCache::RenderBoxes(const std::vector<glm::vec3>& bounds) const
+{
+    if (bounds.empty())
+        return;
+
+    // Upload the instance bounds, orphaning the previous storage
+    GLStateCache& state = GLState();
+    GLsizeiptr size = bounds.size() * sizeof(glm::vec3);
+    state.BindBuffer(GL_ARRAY_BUFFER, mBoxInstanceVbo);
+    glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, bounds.data());
+    RenderStats().CountBufferUpload(static_cast<std::size_t>(size));
+
+    // Draw all the boxes at once
+    state.BindVertexArray(mBox.vao);
+    glDrawElementsInstanced(GL_LINES, mBox.numElements, GL_UNSIGNED_INT, 0, static_cast<GLsizei>(bounds.size() / 2));
+    RenderStats().CountDraw(GL_LINES, mBox.numElements, static_cast<GLsizei>(bounds.size() / 2));
+}
@@ -28,69 +28,59 @@
 /*   ' ') '( (/                                                                                                      */
 /*     '   '  `                                                                                                      */
 /*********************************************************************************************************************/
-#ifndef _TRANSFORM_HPP_
-#define _TRANSFORM_HPP_
+#ifndef _PRIMITIVE_CACHE_HPP_
+#define _PRIMITIVE_CACHE_HPP_
+
+#include <vector>
+#include <glad/glad.h>
 
 #include "../../Util/WarnGuard.hpp"
 WARN_GUARD_ON
 #include <glm/glm.hpp>
 WARN_GUARD_OFF
 
-class Transform
+// Owns the geometry of the primitive shapes used by the renderers, created once and drawn many times
+class PrimitiveCache
 {
     public:
-        // Constructor
-        Transform();
-
-        // Retrieves the current transformation matrix
-        const glm::mat4& Get() const;
-
-        // Retrieves the current local position vector
-        const glm::vec3& GetPosition() const;
-
-        // Retrieves the current local scaling vector
-        const glm::vec3& GetScale() const;
-
-        // Retrieves the current rotation vector
-        const glm::vec3 GetRotation() const;
-
-        // Moves relatively to the current position
-        void Move(const glm::vec3& pos);
+        // Attribute locations of the per instance box bounds
+        static const GLuint BoxMinAttribLocation = 1;
+        static const GLuint BoxMaxAttribLocation = 2;
 
-        // Rotates relatively to the current X rotation
-        void RotateX(float angle);
+        // Creates the primitive geometry
+        void Init();
 
-        // Rotates relatively to the current Y rotation
-        void RotateY(float angle);
+        // Destroys the primitive geometry
+        void Shutdown();
 
-        // Rotates relatively to the current Z rotation
-        void RotateZ(float angle);
+        // Renders a 1x1 quad in NDC, used for framebuffer color targets
+        void RenderQuad() const;
 
-        // Scales relatively to the current scale
-        void Scale(const glm::vec3& scale);
+        // Renders a unit sphere
+        void RenderSphere() const;
 
-        // Updates the interpolation state variables
-        void Update();
-
-        // Calculates interpolated translation matrix
-        glm::mat4 GetInterpolated(float interpolation) const;
+        // Renders the edges of boxes given as consecutive min/max point pairs,
+        // with a single instanced draw of a unit cube
+        void RenderBoxes(const std::vector<glm::vec3>& bounds) const;
 
     private:
-        // Current cached transformation matrix
-        glm::mat4 mTransform;
-
-        // Transform position
-        glm::vec3 mPosition;
-
-        // Transform rotation
-        float mYaw, mPitch, mRoll;
-
-        // Transform scale
-        glm::vec3 mScale;
-
-        // Stored for calculating interpolation states
-        glm::mat4 mOldTrans;
+        // Buffers of a single primitive
+        struct Primitive
+        {
+            GLuint vao, vbo, ebo;
+            GLsizei numElements;
+        };
+
+        // Destroys the buffers of the given primitive
+        static void Destroy(Primitive& p);
+
+        // Primitive geometry
+        Primitive mQuad;
+        Primitive mSphere;
+        Primitive mBox;
+
+        // Per instance box bounds
+        GLuint mBoxInstanceVbo;
 };
 
-#endif // ! _TRANSFORM_HPP_
-
+#endif // ! _PRIMITIVE_CACHE_HPP_
@@ -0,0 +1,171 @@
+#include "RenderStats.hpp"
+
+const char* RenderPassName(RenderPass pass)
+{
+    switch (pass)
+    {
+        case RenderPass::Shadow:
+            return "Shadow";
+        case RenderPass::ShadowCascade0:
+            return "Cascade 0";
+        case RenderPass::ShadowCascade1:
+            return "Cascade 1";
+        case RenderPass::ShadowCascade2:
+            return "Cascade 2";
+        case RenderPass::ShadowCascade3:
+            return "Cascade 3";
+        case RenderPass::Geometry:
+            return "Geometry";
+        case RenderPass::Stencil:
+            return "Stencil";
+        case RenderPass::Light:
+            return "Light";
+        case RenderPass::Skybox:
+            return "Skybox";
+        case RenderPass::Text:
+            return "Text";
+        case RenderPass::Debug:
+            return "Debug";
+        default:
+            return "Other";
+    }
+}
+
+RenderPass ShadowCascadePass(unsigned int cascade)
+{
+    if (cascade >= MaxShadowCascadePasses)
+        cascade = MaxShadowCascadePasses - 1;
+    return static_cast<RenderPass>(static_cast<unsigned int>(RenderPass::ShadowCascade0) + cascade);
+}
+
+PassStats& PassStats::operator+=(const PassStats& other)
+{
+    drawCalls      += other.drawCalls;
+    instances      += other.instances;
+    triangles      += other.triangles;
+    vertices       += other.vertices;
+    programBinds   += other.programBinds;
+    vaoBinds       += other.vaoBinds;
+    textureBinds   += other.textureBinds;
+    bufferBytes    += other.bufferBytes;
+    uniformUploads += other.uniformUploads;
+    return *this;
+}
+
+const PassStats& FrameRenderStats::operator[](RenderPass pass) const
+{
+    return passes[static_cast<std::size_t>(pass)];
+}
+
+PassStats FrameRenderStats::Total() const
+{
+    PassStats total = {};
+    for (const PassStats& pass : passes)
+        total += pass;
+    return total;
+}
+
+RenderStatsTracker::RenderStatsTracker()
+    : mFrameStats()
+    , mLastFrameStats()
+    , mPass(RenderPass::Other)
+{
+}
+
+void RenderStatsTracker::NewFrame()
+{
+    mLastFrameStats = mFrameStats;
+    mFrameStats = FrameRenderStats();
+    mPass = RenderPass::Other;
+}
+
+void RenderStatsTracker::SetPass(RenderPass pass)
+{
+    mPass = pass;
+}
+
+RenderPass RenderStatsTracker::GetPass() const
+{
+    return mPass;
+}
+
+void RenderStatsTracker::CountDraw(GLenum mode, GLsizei count, GLsizei instances)
+{
+    CountDrawCall();
+    CountPrimitives(mode, count, instances);
+}
+
+void RenderStatsTracker::CountDrawCall()
+{
+    ++Current().drawCalls;
+}
+
+void RenderStatsTracker::CountPrimitives(GLenum mode, GLsizei count, GLsizei instances)
+{
+    PassStats& stats = Current();
+    const std::uint64_t n = static_cast<std::uint64_t>(count);
+    const std::uint64_t i = static_cast<std::uint64_t>(instances);
+
+    std::uint64_t triangles = 0;
+    if (mode == GL_TRIANGLES)
+        triangles = n / 3;
+    else if ((mode == GL_TRIANGLE_STRIP || mode == GL_TRIANGLE_FAN) && n > 2)
+        triangles = n - 2;
+
+    stats.instances += i;
+    stats.triangles += triangles * i;
+    stats.vertices  += n * i;
+}
+
+void RenderStatsTracker::CountProgramBind()
+{
+    ++Current().programBinds;
+}
+
+void RenderStatsTracker::CountVaoBind()
+{
+    ++Current().vaoBinds;
+}
+
+void RenderStatsTracker::CountTextureBind()
+{
+    ++Current().textureBinds;
+}
+
+void RenderStatsTracker::CountBufferUpload(std::size_t bytes)
+{
+    Current().bufferBytes += bytes;
+}
+
+void RenderStatsTracker::CountUniformUpload()
+{
+    ++Current().uniformUploads;
+}
+
+void RenderStatsTracker::CountLights(std::uint32_t dirLights, std::uint32_t clusteredPointLights, std::uint32_t stencilPointLights)
+{
+    mFrameStats.dirLights            += dirLights;
+    mFrameStats.clusteredPointLights += clusteredPointLights;
+    mFrameStats.stencilPointLights   += stencilPointLights;
+}
+
+const FrameRenderStats& RenderStatsTracker::GetFrameStats() const
+{
+    return mFrameStats;
+}
+
+const FrameRenderStats& RenderStatsTracker::GetLastFrameStats() const
+{
+    return mLastFrameStats;
+}
+
+PassStats& RenderStatsTracker::Current()
+{
+    return mFrameStats.passes[static_cast<std::size_t>(mPass)];
+}
+
+RenderStatsTracker& RenderStats()
+{
+    static RenderStatsTracker tracker;
+    return tracker;
+}
@@ -0,0 +1,173 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _RENDER_STATS_HPP_
+#define _RENDER_STATS_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <glad/glad.h>
+
+// The passes the submitted work is accounted to
+enum class RenderPass : std::uint8_t
+{
+    Shadow,         // Shadow map setup and the uploads all the cascades share
+    ShadowCascade0, // Each cascade's clear and draws
+    ShadowCascade1,
+    ShadowCascade2,
+    ShadowCascade3,
+    Geometry,
+    Stencil,
+    Light,
+    Skybox,
+    Text,
+    Debug,
+    Other,
+    Count
+};
+
+// Number of shadow cascades accounted apart
+const unsigned int MaxShadowCascadePasses = 4;
+
+// Retrieves the display name of a pass
+const char* RenderPassName(RenderPass pass);
+
+// Retrieves the pass of the given shadow cascade, the cascades past the last accounted one share its pass
+RenderPass ShadowCascadePass(unsigned int cascade);
+
+// Counters of the work a pass submitted in a frame
+struct PassStats
+{
+    std::uint64_t drawCalls,
+                  instances,
+                  triangles,
+                  vertices,
+                  programBinds,
+                  vaoBinds,
+                  textureBinds,
+                  bufferBytes,
+                  uniformUploads;
+
+    PassStats& operator+=(const PassStats& other);
+};
+
+// Counters of the work submitted in a frame
+struct FrameRenderStats
+{
+    std::array<PassStats, static_cast<std::size_t>(RenderPass::Count)> passes;
+
+    // Lights shaded by the light pass, by the way they were processed
+    std::uint32_t dirLights,
+                  clusteredPointLights,
+                  stencilPointLights;
+
+    // Retrieves the counters of the given pass
+    const PassStats& operator[](RenderPass pass) const;
+
+    // Sums the counters of all the passes
+    PassStats Total() const;
+};
+
+// Accumulates the work submitted to the current GL context, accounting it to the active pass.
+// The draw and upload sites report to it directly, the binds are reported by the GL state cache once issued.
+class RenderStatsTracker
+{
+    public:
+        // Constructor
+        RenderStatsTracker();
+
+        // Starts a new frame, closing the counters of the previous one
+        void NewFrame();
+
+        // Sets the pass the following work is accounted to
+        void SetPass(RenderPass pass);
+        RenderPass GetPass() const;
+
+        // Accounts a draw of count vertices or indices in the given primitive mode
+        void CountDraw(GLenum mode, GLsizei count, GLsizei instances = 1);
+
+        // Account a draw call and the primitives drawn separately, for calls that make many draws
+        void CountDrawCall();
+        void CountPrimitives(GLenum mode, GLsizei count, GLsizei instances = 1);
+
+        // Accounts binds issued to the driver
+        void CountProgramBind();
+        void CountVaoBind();
+        void CountTextureBind();
+
+        // Accounts data uploaded to buffer objects
+        void CountBufferUpload(std::size_t bytes);
+
+        // Accounts an uniform value set
+        void CountUniformUpload();
+
+        // Accounts the lights shaded by the light pass
+        void CountLights(std::uint32_t dirLights, std::uint32_t clusteredPointLights, std::uint32_t stencilPointLights);
+
+        // Counters of the frame in progress and of the last completed frame
+        const FrameRenderStats& GetFrameStats() const;
+        const FrameRenderStats& GetLastFrameStats() const;
+
+    private:
+        // Counters of the active pass in the frame in progress
+        PassStats& Current();
+
+        FrameRenderStats mFrameStats;
+        FrameRenderStats mLastFrameStats;
+        RenderPass mPass;
+};
+
+// Retrieves the statistics tracker of the current GL context
+RenderStatsTracker& RenderStats();
+
+// Accounts the work submitted in the enclosing scope to the given pass
+class RenderPassScope
+{
+    public:
+        explicit RenderPassScope(RenderPass pass)
+            : mPrevious(RenderStats().GetPass())
+        {
+            RenderStats().SetPass(pass);
+        }
+
+        ~RenderPassScope()
+        {
+            RenderStats().SetPass(mPrevious);
+        }
+
+        RenderPassScope(const RenderPassScope&) = delete;
+        RenderPassScope& operator=(const RenderPassScope&) = delete;
+
+    private:
+        RenderPass mPrevious;
+};
+
+#endif // ! _RENDER_STATS_HPP_
@@ -1,7 +1,12 @@
 #include "Renderer.hpp"
 #include <GL/gl.h>
-#include "RenderUtils.hpp"
+#include "GLStateCache.hpp"
+#include "RenderStats.hpp"
+#include <algorithm>
+#include <tuple>
 #include "../Util/GLUtils.hpp"
+#include "../../Util/AllocCounter.hpp"
+#include "../../Core/JobSystem.hpp"
 
 WARN_GUARD_ON
 #include <glm/gtc/type_ptr.hpp>
@@ -33,6 +38,9 @@ void Renderer::Init(int width, int height, std::unique_ptr<ShaderPrograms> shdrP
     // Store the needed program id's
     SetShaderPrograms(std::move(shdrProgs));
 
+    // Reset the submit statistics
+    mSubmitAllocations = 0;
+
     // Initialize screen size dependent values
     Resize(width, height);
 
@@ -40,21 +48,30 @@ void Renderer::Init(int width, int height, std::unique_ptr<ShaderPrograms> shdrP
     Shader vert(nullVShader, Shader::Type::Vertex);
     Shader frag(nullFShader, Shader::Type::Fragment);
     mNullProgram = std::make_unique<ShaderProgram>(vert.Id(), frag.Id());
+    mNullProgMVP = mNullProgram->GetUniform<glm::mat4>("MVP");
 
     // Initialize the ShadowRenderer
     mShadowRenderer.Init(1024, 1024);
 
+    // Initialize the instance buffer
+    mInstanceBuffer.Init();
+    mIndirectBuffer.Init();
+    mPrimitives.Init();
+    mLightClusters.Init();
+    mLightCulling = LightCulling::Clustered;
+    mGpuProfiler.Init();
+
     // Create UBO buffer
     glGenBuffers(1, &mUboMatrices);
-    glBindBuffer(GL_UNIFORM_BUFFER, mUboMatrices);
+    GLState().BindBuffer(GL_UNIFORM_BUFFER, mUboMatrices);
     glBufferData(GL_UNIFORM_BUFFER, 2 * sizeof(glm::mat4), NULL, GL_STATIC_DRAW);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    GLState().BindBuffer(GL_UNIFORM_BUFFER, 0);
 
     // Define the range of the buffer that links to a uniform binding point
     glBindBufferRange(GL_UNIFORM_BUFFER, 0, mUboMatrices, 0, 2 * sizeof(glm::mat4));
 
     // Enable seamless cubemaps
-    glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+    GLState().Enable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
 }
 
 void Renderer::Resize(int width, int height)
@@ -66,17 +83,41 @@ void Renderer::Resize(int width, int height)
         static_cast<float>(mScreenWidth) / mScreenHeight,
         0.1f, 300.0f
     );
-    mGBuffer = std::make_unique<GBuffer>(width, height);
+    mGBuffer = std::make_unique<GBuffer>(width, height, mGBufferLayout);
+}
+
+void Renderer::SetGBufferLayout(GBuffer::Layout layout)
+{
+    mGBufferLayout = layout;
+    if (mGBuffer && mGBuffer->GetLayout() != layout)
+        mGBuffer = std::make_unique<GBuffer>(mScreenWidth, mScreenHeight, mGBufferLayout);
+}
+
+GBuffer::Layout Renderer::GetGBufferLayout() const
+{
+    return mGBufferLayout;
+}
+
+std::vector<std::string> Renderer::GeometryPassDefines()
+{
+    return { "NORMAL_MAP" };
+}
+
+std::vector<std::string> Renderer::LightPassDefines()
+{
+    return { "LIGHT_DIR", "LIGHT_POINT", "LIGHT_AMBIENT", "LIGHT_CLUSTERED", "SHADOWS", "COMPOSITE" };
 }
 
 void Renderer::SetShaderPrograms(std::unique_ptr<ShaderPrograms> shdrProgs)
 {
-    // Store shader program ids
+    // Build the variants the passes use up front, so that failures surface here
+    shdrProgs->geometryPass.Warm({ 0, NormalMap });
+    shdrProgs->lightPass.Warm({ LightDir | Shadows, LightAmbient, LightPoint, LightClustered, Composite });
+
+    // Store shader programs, their uniforms are resolved on first use
     mShdrProgs = std::move(shdrProgs);
-    // Get ubo index
-    GLuint geometryPassUboIndex = glGetUniformBlockIndex(mShdrProgs->geometryPassProg.Id(), "Matrices");
-    // Link block to its binding point
-    glUniformBlockBinding(mShdrProgs->geometryPassProg.Id(), geometryPassUboIndex, 0);
+    mGeomPassUniforms.clear();
+    mLightPassUniforms.clear();
 }
 
 void Renderer::Update(float dt)
@@ -86,31 +127,40 @@ void Renderer::Update(float dt)
 
 void Renderer::Render(float interpolation, const IntForm& intForm)
 {
+    // Collect the GPU timings of the frames in flight
+    mGpuProfiler.BeginFrame();
+    PROFILE_GPU_SCOPE(mGpuProfiler, "Render");
+
     // Setup clear color
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
     //
     // Set view and projection matrices in UBO
     //
-    glBindBuffer(GL_UNIFORM_BUFFER, mUboMatrices);
+    GLState().BindBuffer(GL_UNIFORM_BUFFER, mUboMatrices);
     glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4), glm::value_ptr(mProjection));
     glBufferSubData(GL_UNIFORM_BUFFER, sizeof(glm::mat4), sizeof(glm::mat4), glm::value_ptr(mView));
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    RenderStats().CountBufferUpload(2 * sizeof(glm::mat4));
+    GLState().BindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    // The light passes reconstruct positions with these
+    mInverseView = glm::inverse(mView);
+    mInverseViewProj = glm::inverse(mProjection * mView);
+
+    // Track heap allocations made while submitting the render lists, by the render thread alone
+    std::uint64_t allocationsBefore = GetThreadAllocationCount();
 
     //
     // Render the shadow map
     //
-    // Set the rendering scene
-    std::vector<ShadowRenderer::IntMesh> shadowRendererIntForm;
-    for (const auto& matEntry : intForm.materials)
-        for (const auto& mesh : matEntry.second)
-            shadowRendererIntForm.emplace_back(
-                ShadowRenderer::IntMesh{mesh.transformation, mesh.vaoId, mesh.eboId, mesh.numIndices}
-            );
-    // Set light's properties
-    mShadowRenderer.SetLightViewParams(mProjection, mView, -(mLights.dirLights.front().direction));
-    // Render depth map
-    mShadowRenderer.Render(interpolation, shadowRendererIntForm);
+    {
+        PROFILE_GPU_SCOPE(mGpuProfiler, "ShadowPass");
+        RenderPassScope pass(RenderPass::Shadow);
+        // Set light's properties
+        mShadowRenderer.SetLightViewParams(mProjection, mView, -(mLights.dirLights.front().direction));
+        // Render depth map
+        mShadowRenderer.Render(interpolation, *intForm.shadowCasters, intForm.transforms);
+    }
 
     //
     // Make the GeometryPass
@@ -122,21 +172,23 @@ void Renderer::Render(float interpolation, const IntForm& intForm)
     //
     LightPass(interpolation, intForm);
 
+    mSubmitAllocations = GetThreadAllocationCount() - allocationsBefore;
+
     //
-    // Copy result to default fbo
+    // Composite result to default fbo
     //
-    mGBuffer->CopyResultToDefault(mScreenWidth, mScreenHeight);
+    CompositePass();
 
     //
     // Setup forward render context
     //
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, mGBuffer->Id());
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    GLState().BindFramebuffer(GL_READ_FRAMEBUFFER, mGBuffer->Id());
+    GLState().BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
     glBlitFramebuffer(0, 0, mScreenWidth, mScreenHeight,
                       0, 0, mScreenWidth, mScreenHeight,
                       GL_DEPTH_BUFFER_BIT,
                       GL_NEAREST);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState().BindFramebuffer(GL_FRAMEBUFFER, 0);
 
     // Check for OpenGL errors
     CheckGLError();
@@ -144,7 +196,7 @@ void Renderer::Render(float interpolation, const IntForm& intForm)
     //
     // Forward render stuff on top
     //
-    glEnable(GL_DEPTH_TEST);
+    GLState().Enable(GL_DEPTH_TEST);
     // Forward rendering block
     {
     }
@@ -156,230 +208,293 @@ void Renderer::Shutdown()
     mShdrProgs.reset();
 
     // Delete matrices UBO
-    glDeleteBuffers(1, &mUboMatrices);
+    GLState().DeleteBuffers(1, &mUboMatrices);
 
     // Shutdown the ShadowRenderer
     mShadowRenderer.Shutdown();
 
+    // Delete instance buffer
+    mInstanceBuffer.Shutdown();
+    mIndirectBuffer.Shutdown();
+    mPrimitives.Shutdown();
+    mLightClusters.Shutdown();
+    mGpuProfiler.Shutdown();
+
     // Destroy GBuffer
     mGBuffer.reset();
 }
 
 void Renderer::GeometryPass(float interpolation, const IntForm& intForm)
 {
+    PROFILE_GPU_SCOPE(mGpuProfiler, "GeometryPass");
+    RenderPassScope pass(RenderPass::Geometry);
+
     // Enable depth testing
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_CULL_FACE);
-    glDepthMask(GL_TRUE);
+    GLState().Enable(GL_DEPTH_TEST);
+    GLState().Enable(GL_CULL_FACE);
+    GLState().DepthMask(GL_TRUE);
 
     // Prepare and bind the GBuffer
     mGBuffer->PrepareFor(GBuffer::Mode::GeometryPass);
-    glBindFramebuffer(GL_FRAMEBUFFER, mGBuffer->Id());
+    GLState().BindFramebuffer(GL_FRAMEBUFFER, mGBuffer->Id());
 
     // Clear the current framebuffer
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // Use the geometry pass program
-    GLuint progId = mShdrProgs->geometryPassProg.Id();
-    glUseProgram(progId);
+    // The compact layout packs the material factors into the GBuffer
+    GLState().BindBufferBase(GL_UNIFORM_BUFFER, 1, mMaterialStore->DataId());
+
+    // Group the visible meshes of each material that share the same geometry into instanced batches
+    const auto& materials = *intForm.materials;
+    mInstanceSources.clear();
+    mInstanceBatches.clear();
+    for (std::size_t i = 0; i < materials.size(); ++i)
+    {
+        mBatchScratch.clear();
+        for (const IntMesh& mesh : materials[i].second)
+        {
+            // Skip meshes outside of the view frustum
+            if (!mesh.culled)
+                mBatchScratch.push_back(&mesh);
+        }
+
+        std::sort(std::begin(mBatchScratch), std::end(mBatchScratch),
+            [](const IntMesh* a, const IntMesh* b) -> bool
+            {
+                return std::tie(a->vaoId, a->eboId, a->firstIndex, a->baseVertex)
+                     < std::tie(b->vaoId, b->eboId, b->firstIndex, b->baseVertex);
+            });
 
-    // Set sampler locations
-    glUniform1i(glGetUniformLocation(progId, "material.diffuseTexture"), 0);
-    glUniform1i(glGetUniformLocation(progId, "material.specularTexture"), 1);
-    glUniform1i(glGetUniformLocation(progId, "normalMap"), 2);
+        for (const IntMesh* mesh : mBatchScratch)
+        {
+            if (mInstanceBatches.empty()
+             || mInstanceBatches.back().group != i
+             || mInstanceBatches.back().vaoId != mesh->vaoId
+             || mInstanceBatches.back().eboId != mesh->eboId
+             || mInstanceBatches.back().firstIndex != mesh->firstIndex
+             || mInstanceBatches.back().baseVertex != mesh->baseVertex)
+            {
+                mInstanceBatches.push_back({i, mesh->vaoId, mesh->eboId, mesh->numIndices, mesh->baseVertex, mesh->firstIndex,
+                                            mInstanceSources.size(), 0});
+            }
+            mInstanceSources.push_back(mesh->transform);
+            ++mInstanceBatches.back().count;
+        }
+    }
+
+    // Interpolate the instance matrices
+    InterpolateInstances(mJobs, intForm.transforms, mInstanceSources, interpolation, mInstanceData);
+
+    // Upload the instance matrices
+    mInstanceBuffer.Upload(mInstanceData);
+
+    // Upload the draw commands, which read the instance matrices through their base instance
+    const bool indirect = mIndirectBuffer.IsAvailable();
+    if (indirect)
+    {
+        mIndirectBuffer.Upload(mInstanceBatches);
+        mIndirectBuffer.Bind();
+    }
 
-    for (auto& p : intForm.materials)
+    std::size_t curMaterial = materials.size();
+    for (std::size_t b = 0; b < mInstanceBatches.size();)
     {
-        auto& intMat    = p.first;
-        auto& intMeshes = p.second;
+        const InstanceBuffer::Batch& batch = mInstanceBatches[b];
 
-        // Upload material's properties to GPU
-        // Pass the material index in the material buffer object
-        glUniform1ui(glGetUniformLocation(progId, "matIdx"), intMat.matIndex);
+        // Upload material's properties to GPU when changed
+        if (batch.group != curMaterial)
+        {
+            curMaterial = batch.group;
+            const IntMaterial& intMat = materials[curMaterial].first;
+
+            // Use the variant with the material's features
+            UseGeometryPassVariant(intMat.useNormalMap ? ShaderVariants::Key(NormalMap) : ShaderVariants::Key(0));
+
+            // Pass the material index in the material buffer object
+            mCurGeomPassUniforms->matIdx.Set(intMat.matIndex);
+
+            //
+            // Upload material parameters
+            //
+            // Diffuse
+            GLuint diffTexId = intMat.diffTexId;
+            GLState().ActiveTexture(GL_TEXTURE0);
+            GLState().BindTexture(GL_TEXTURE_2D, diffTexId);
+
+            // Specular
+            GLuint specTexId = intMat.specTexId;
+            GLState().ActiveTexture(GL_TEXTURE1);
+            GLState().BindTexture(GL_TEXTURE_2D, specTexId);
+
+            // Normal map
+            if(intMat.useNormalMap)
+            {
+                GLState().ActiveTexture(GL_TEXTURE2);
+                GLState().BindTexture(GL_TEXTURE_2D, intMat.nmapTexId);
+            }
+        }
 
-        //
-        // Upload material parameters
-        //
-        // Diffuse
-        GLuint diffTexId = intMat.diffTexId;
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, diffTexId);
-
-        // Specular
-        GLuint specTexId = intMat.specTexId;
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, specTexId);
-
-        // Normal map
-        if(intMat.useNormalMap)
+        GLState().BindVertexArray(batch.vaoId);
+        GLState().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.eboId);
+        if (indirect)
         {
-            glUniform1i(glGetUniformLocation(progId, "useNormalMaps"), GL_TRUE);
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, intMat.nmapTexId);
+            // Draw the batches of the material sharing the geometry buffers at once
+            const std::size_t end = BatchRunEnd(mInstanceBatches, b);
+            mInstanceBuffer.BindAttributes(0);
+            mIndirectBuffer.Draw(b, end - b);
+            b = end;
         }
         else
-            glUniform1i(glGetUniformLocation(progId, "useNormalMaps"), GL_FALSE);
-
-        // Draw every mesh of this material
-        for (const IntMesh& mesh : intMeshes)
         {
-            // Upload model matrix
-            auto modelId = glGetUniformLocation(progId, "model");
-            glUniformMatrix4fv(modelId, 1, GL_FALSE, glm::value_ptr(mesh.transformation.GetInterpolated(interpolation)));
-
-            // Draw mesh
-            glBindVertexArray(mesh.vaoId);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.eboId);
-            glDrawElements(GL_TRIANGLES, mesh.numIndices, GL_UNSIGNED_INT, 0);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-            glBindVertexArray(0);
+            // Draw every instance of the batch
+            mInstanceBuffer.BindAttributes(batch.first);
+            glDrawElementsInstancedBaseVertex(GL_TRIANGLES, batch.numIndices, GL_UNSIGNED_INT,
+                    (GLvoid*)(batch.firstIndex * sizeof(GLuint)), static_cast<GLsizei>(batch.count), batch.baseVertex);
+            RenderStats().CountDraw(GL_TRIANGLES, batch.numIndices, static_cast<GLsizei>(batch.count));
+            ++b;
         }
     }
+    GLState().BindVertexArray(0);
 
-    glUseProgram(0);
+    GLState().UseProgram(0);
 
     // Unbind the GBuffer
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState().BindFramebuffer(GL_FRAMEBUFFER, 0);
 
-    // Disable depth testing
-    glDepthMask(GL_FALSE);
-    glDisable(GL_CULL_FACE);
-    glDisable(GL_DEPTH_TEST);
-}
+    // The light pass samples a copy of the depth, the stencil volumes still test against the attached one
+    mGBuffer->CopyDepth();
 
-float CalcPointLightBSphere(const PointLight& light)
-{
-    float MaxChannel = fmax(fmax(light.color.r, light.color.g), light.color.b);
-    float ret =
-        (-light.attProps.linear
-         +sqrtf(light.attProps.linear * light.attProps.linear - 4 * light.attProps.quadratic
-                * (light.attProps.constant - (256.0f / 5.0f) * MaxChannel))) / (2 * light.attProps.quadratic);
-    return ret;
+    // Disable depth testing
+    GLState().DepthMask(GL_FALSE);
+    GLState().Disable(GL_CULL_FACE);
+    GLState().Disable(GL_DEPTH_TEST);
 }
 
 void Renderer::LightPass(float interpolation, const IntForm& intForm)
 {
     (void)interpolation;
+    PROFILE_GPU_SCOPE(mGpuProfiler, "LightPass");
+    RenderPassScope pass(RenderPass::Light);
 
     // Prepare GBuffer for the light pass
     mGBuffer->PrepareFor(GBuffer::Mode::LightPass);
-    glBindFramebuffer(GL_FRAMEBUFFER, mGBuffer->Id());
+    GLState().BindFramebuffer(GL_FRAMEBUFFER, mGBuffer->Id());
 
     // Clear framebuffer
     glClear(GL_COLOR_BUFFER_BIT);
 
     // Enable blending for multiple light passes
-    glEnable(GL_BLEND);
-    glBlendEquation(GL_FUNC_ADD);
-    glBlendFunc(GL_ONE, GL_ONE);
-
-    // Use the light pass program
-    GLuint progId = mShdrProgs->lightPassProg.Id();
-    glUseProgram(progId);
+    GLState().Enable(GL_BLEND);
+    GLState().BlendEquation(GL_FUNC_ADD);
+    GLState().BlendFunc(GL_ONE, GL_ONE);
 
     // Setup material index buffer
-    GLuint blockIndex = glGetUniformBlockIndex(progId, "MaterialDataBlock");
-    GLuint bindingPointIndex = 1;
-    glBindBufferBase(GL_UNIFORM_BUFFER, bindingPointIndex, mMaterialStore->DataId());
-    glUniformBlockBinding(progId, blockIndex, bindingPointIndex);
-
-    // Bind the data textures
-    GLuint gPosId = glGetUniformLocation(progId, "gPosition");
-    glUniform1i(gPosId, 0);
-    GLuint gNormId = glGetUniformLocation(progId, "gNormal");
-    glUniform1i(gNormId, 1);
-    GLuint gAlbSpecId = glGetUniformLocation(progId, "gAlbedoSpec");
-    glUniform1i(gAlbSpecId, 2);
-    GLuint gMatIdxId = glGetUniformLocation(progId, "gMatIdx");
-    glUniform1i(gMatIdxId, 3);
+    GLState().BindBufferBase(GL_UNIFORM_BUFFER, 1, mMaterialStore->DataId());
 
     // Bind the shadow map
-    glActiveTexture(GL_TEXTURE4);
-    glBindTexture(GL_TEXTURE_2D_ARRAY, mShadowRenderer.DepthMapId());
-    glUniform1i(glGetUniformLocation(progId, "uShadowMap"), 4);
+    GLState().ActiveTexture(GL_TEXTURE4);
+    GLState().BindTexture(GL_TEXTURE_2D_ARRAY, mShadowRenderer.DepthMapId());
 
     // Bind the irradiance cube
     GLuint irrMapId = intForm.irrMapId;
-    glActiveTexture(GL_TEXTURE5);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, irrMapId);
-    glUniform1i(glGetUniformLocation(progId, "irrMap"), 5);
+    GLState().ActiveTexture(GL_TEXTURE5);
+    GLState().BindTexture(GL_TEXTURE_CUBE_MAP, irrMapId);
 
     // Bind the skybox cube
     GLuint envMapId = intForm.skyboxId;
-    glActiveTexture(GL_TEXTURE6);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, envMapId);
-    glUniform1i(glGetUniformLocation(progId, "skybox"), 6);
+    GLState().ActiveTexture(GL_TEXTURE6);
+    GLState().BindTexture(GL_TEXTURE_CUBE_MAP, envMapId);
 
     // Bind the skybox cube
     GLuint radMapId = intForm.radMapId;
-    glActiveTexture(GL_TEXTURE7);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, radMapId);
-    glUniform1i(glGetUniformLocation(progId, "radMap"), 7);
+    GLState().ActiveTexture(GL_TEXTURE7);
+    GLState().BindTexture(GL_TEXTURE_CUBE_MAP, radMapId);
 
-    // Pass the screen size
-    glUniform2i(glGetUniformLocation(progId, "gScreenSize"), mScreenWidth, mScreenHeight);
+    //
+    // Directional light pass, the only one shadowed
+    //
+    const LightPassUniforms& lpu = UseLightPassVariant(LightDir | Shadows);
 
     //
     // Pass the shadow uniforms
     //
     // Near values
-    glUniform1fv(
-        glGetUniformLocation(progId, "uCascadesNear"),
-        static_cast<GLsizei>(mShadowRenderer.GetSplitNearPlanes().size()),
-        mShadowRenderer.GetSplitNearPlanes().data()
+    lpu.cascadesNear.Set(
+        mShadowRenderer.GetSplitNearPlanes().data(),
+        static_cast<GLsizei>(mShadowRenderer.GetSplitNearPlanes().size())
     );
     // Far values
-    glUniform1fv(
-        glGetUniformLocation(progId, "uCascadesFar"),
-        static_cast<GLsizei>(mShadowRenderer.GetSplitFarPlanes().size()),
-        mShadowRenderer.GetSplitFarPlanes().data()
+    lpu.cascadesFar.Set(
+        mShadowRenderer.GetSplitFarPlanes().data(),
+        static_cast<GLsizei>(mShadowRenderer.GetSplitFarPlanes().size())
     );
     // Plane values
-    glUniform2fv(
-        glGetUniformLocation(progId, "uCascadesPlanes"),
-        static_cast<GLsizei>(mShadowRenderer.GetSplitPlanes().size()),
-        glm::value_ptr(*mShadowRenderer.GetSplitPlanes().data())
+    lpu.cascadesPlanes.Set(
+        mShadowRenderer.GetSplitPlanes().data(),
+        static_cast<GLsizei>(mShadowRenderer.GetSplitPlanes().size())
     );
     // Matrices values
-    glUniformMatrix4fv(
-        glGetUniformLocation(progId, "uCascadesMatrices"),
-        static_cast<GLsizei>(mShadowRenderer.GetSplitShadowMats().size()), GL_FALSE,
-        glm::value_ptr(*mShadowRenderer.GetSplitShadowMats().data())
+    lpu.cascadesMatrices.Set(
+        mShadowRenderer.GetSplitShadowMats().data(),
+        static_cast<GLsizei>(mShadowRenderer.GetSplitShadowMats().size())
     );
-    // View matrix
-    glUniformMatrix4fv(glGetUniformLocation(progId, "viewMat"), 1, GL_FALSE, glm::value_ptr(mView));
-
-    //
-    // Directional light passes
-    //
-    // Setup lighting position parameters
-    const glm::mat4 inverseView = glm::inverse(mView);
-    const glm::vec3 viewPos = glm::vec3(inverseView[3].x, inverseView[3].y, inverseView[3].z);
-    GLint viewPosId = glGetUniformLocation(progId, "viewPos");
-    glUniform3f(viewPosId, viewPos.x, viewPos.y, viewPos.z);
 
     // Set directional light properties
     const DirLight& dirLight = mLights.dirLights.front();
-    glUniform3fv(glGetUniformLocation(progId, "dirLight.direction"), 1, glm::value_ptr(dirLight.direction));
-    glUniform3fv(glGetUniformLocation(progId, "dirLight.color"), 1, glm::value_ptr(dirLight.color));
+    lpu.dirLightDirection.Set(dirLight.direction);
+    lpu.dirLightColor.Set(dirLight.color);
 
     // Render
-    glm::mat4 mvp = glm::mat4();
-    glUniformMatrix4fv(glGetUniformLocation(progId, "MVP"), 1, GL_FALSE, glm::value_ptr(mvp));
-    glUniform1i(glGetUniformLocation(progId, "lMode"), 1);
-    RenderQuad();
+    lpu.MVP.Set(glm::mat4());
+    mPrimitives.RenderQuad();
+    RenderStats().CountLights(1, 0, 0);
 
     //
     // Ambient Light Pass
     //
-    glUniform1i(glGetUniformLocation(progId, "lMode"), 3);
-    RenderQuad();
+    UseLightPassVariant(LightAmbient).MVP.Set(glm::mat4());
+    mPrimitives.RenderQuad();
 
     //
     // Point light passes
     //
+    if (mLightCulling == LightCulling::Clustered)
+        ClusteredPointLightPass();
+    else
+        StencilVolumePointLightPasses();
+
+    // Disable and unbind things
+    GLState().UseProgram(0);
+    GLState().Disable(GL_BLEND);
+    GLState().BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Renderer::ClusteredPointLightPass()
+{
+    // Bin the lights into the clusters of the current view
+    mLightClusters.Build(mLights.pointLights, mView, mProjection);
+    if (mLights.pointLights.empty())
+        return;
+    RenderStats().CountLights(0, static_cast<std::uint32_t>(mLights.pointLights.size()), 0);
+
+    // Bind the cluster data
+    const LightPassUniforms& lpu = UseLightPassVariant(LightClustered);
+    mLightClusters.Bind(8);
+    lpu.clusterGrid.Set(glm::ivec3(LightClusters::GridX, LightClusters::GridY, LightClusters::GridZ));
+    lpu.clusterDepthParams.Set(mLightClusters.GetDepthParams());
+
+    // Render
+    lpu.MVP.Set(glm::mat4());
+    mPrimitives.RenderQuad();
+}
+
+void Renderer::StencilVolumePointLightPasses()
+{
+    const LightPassUniforms& lpu = UseLightPassVariant(LightPoint);
+
     // Enable stencil test for bounding sphere optimization
-    glEnable(GL_STENCIL_TEST);
+    GLState().Enable(GL_STENCIL_TEST);
+    RenderStats().CountLights(0, 0, static_cast<std::uint32_t>(mLights.pointLights.size()));
 
     // Set point light's properties
     for (const PointLight& pLight : mLights.pointLights)
@@ -387,57 +502,54 @@ void Renderer::LightPass(float interpolation, const IntForm& intForm)
         // Make the stencil pass
         StencilPass(pLight);
         mGBuffer->PrepareFor(GBuffer::Mode::LightPass);
-        glBindFramebuffer(GL_FRAMEBUFFER, mGBuffer->Id());
+        GLState().BindFramebuffer(GL_FRAMEBUFFER, mGBuffer->Id());
 
         //
-        glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_FRONT);
+        GLState().StencilFunc(GL_NOTEQUAL, 0, 0xFF);
+        GLState().Enable(GL_CULL_FACE);
+        GLState().CullFace(GL_FRONT);
 
-        glUniform3fv(glGetUniformLocation(progId, "pLight.position"), 1, glm::value_ptr(pLight.position));
-        glUniform3fv(glGetUniformLocation(progId, "pLight.color"), 1, glm::value_ptr(pLight.color));
-        glUniform1f(glGetUniformLocation( progId, "pLight.attProps.constant"),   pLight.attProps.constant);
-        glUniform1f(glGetUniformLocation( progId, "pLight.attProps.linear"),     pLight.attProps.linear);
-        glUniform1f(glGetUniformLocation( progId, "pLight.attProps.quadratic"),  pLight.attProps.quadratic);
+        lpu.pLightPosition.Set(pLight.position);
+        lpu.pLightColor.Set(pLight.color);
+        lpu.pLightConstant.Set(pLight.attProps.constant);
+        lpu.pLightLinear.Set(pLight.attProps.linear);
+        lpu.pLightQuadratic.Set(pLight.attProps.quadratic);
 
         // Bounding sphere
         float scaleFactor = CalcPointLightBSphere(pLight);
         glm::mat4 bsMdl = glm::mat4();
         bsMdl = glm::translate(bsMdl, pLight.position);
         bsMdl = glm::scale(bsMdl, glm::vec3(scaleFactor));
-        mvp = mProjection * mView * bsMdl;
-        glUniformMatrix4fv(glGetUniformLocation(progId, "MVP"), 1, GL_FALSE, glm::value_ptr(mvp));
+        glm::mat4 mvp = mProjection * mView * bsMdl;
+        lpu.MVP.Set(mvp);
 
         // Render
-        glUniform1i(glGetUniformLocation(progId, "lMode"), 2);
-        RenderSphere();
+        mPrimitives.RenderSphere();
 
-        glCullFace(GL_BACK);
-        glDisable(GL_CULL_FACE);
+        GLState().CullFace(GL_BACK);
+        GLState().Disable(GL_CULL_FACE);
     }
 
-    // Disable and unbind things
-    glDisable(GL_STENCIL_TEST);
-    glUseProgram(0);
-    glDisable(GL_BLEND);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState().Disable(GL_STENCIL_TEST);
 }
 
 void Renderer::StencilPass(const PointLight& pLight)
 {
+    RenderPassScope pass(RenderPass::Stencil);
+
     // Prepare the GBuffer for the stencil pass
     mGBuffer->PrepareFor(GBuffer::Mode::StencilPass);
-    glBindFramebuffer(GL_FRAMEBUFFER, mGBuffer->Id());
+    GLState().BindFramebuffer(GL_FRAMEBUFFER, mGBuffer->Id());
 
     // Enable depth test
-    glEnable(GL_DEPTH_TEST);
+    GLState().Enable(GL_DEPTH_TEST);
     glClear(GL_STENCIL_BUFFER_BIT);
-    glDisable(GL_CULL_FACE);
+    GLState().Disable(GL_CULL_FACE);
 
     // Stencil properties
-    glStencilFunc(GL_ALWAYS, 0, 0);
-    glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
-    glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
+    GLState().StencilFunc(GL_ALWAYS, 0, 0);
+    GLState().StencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
+    GLState().StencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
 
     // Calc bounding sphere model
     float scaleFactor = CalcPointLightBSphere(pLight);
@@ -446,19 +558,121 @@ void Renderer::StencilPass(const PointLight& pLight)
     model = glm::scale(model, glm::vec3(scaleFactor));
 
     // Store previously used program
-    GLint prevProgram;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prevProgram);
+    GLuint prevProgram = GLState().CurrentProgram();
 
     // Render sphere
-    glUseProgram(mNullProgram->Id());
+    GLState().UseProgram(mNullProgram->Id());
     glm::mat4 MVP = mProjection * mView * model;
-    glUniformMatrix4fv(glGetUniformLocation(mNullProgram->Id(), "MVP"), 1, GL_FALSE, glm::value_ptr(MVP));
-    RenderSphere();
-    glUseProgram(prevProgram);
+    mNullProgMVP.Set(MVP);
+    mPrimitives.RenderSphere();
+    GLState().UseProgram(prevProgram);
 
     // Disable and unbind stuff
-    //glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glDisable(GL_DEPTH_TEST);
+    //GLState().BindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState().Disable(GL_DEPTH_TEST);
+}
+
+void Renderer::CompositePass()
+{
+    PROFILE_GPU_SCOPE(mGpuProfiler, "Composite");
+
+    // The light passes add up linear light, the display transform is applied to their sum only
+    GLState().BindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState().ActiveTexture(GL_TEXTURE11);
+    GLState().BindTexture(GL_TEXTURE_2D, mGBuffer->FinalId());
+
+    UseLightPassVariant(Composite).MVP.Set(glm::mat4());
+    mPrimitives.RenderQuad();
+    GLState().UseProgram(0);
+}
+
+void Renderer::UseGeometryPassVariant(ShaderVariants::Key key)
+{
+    const ShaderProgram& prog = mShdrProgs->geometryPass.Get(key);
+    GLState().UseProgram(prog.Id());
+
+    auto it = mGeomPassUniforms.find(key);
+    if (it == std::end(mGeomPassUniforms))
+    {
+        // Link the blocks to their binding points and set the sampler units, which the program keeps
+        GLuint matricesBlock = prog.GetUniformBlockIndex("Matrices");
+        if (matricesBlock != GL_INVALID_INDEX)
+            glUniformBlockBinding(prog.Id(), matricesBlock, 0);
+        GLuint materialBlock = prog.GetUniformBlockIndex("MaterialDataBlock");
+        if (materialBlock != GL_INVALID_INDEX)
+            glUniformBlockBinding(prog.Id(), materialBlock, 1);
+        prog.GetUniform<GLint>("material.diffuseTexture").Set(0);
+        prog.GetUniform<GLint>("material.specularTexture").Set(1);
+        prog.GetUniform<GLint>("normalMap").Set(2);
+
+        GeometryPassUniforms gpu;
+        gpu.matIdx = prog.GetUniform<GLuint>("matIdx");
+        it = mGeomPassUniforms.emplace(key, gpu).first;
+    }
+    mCurGeomPassUniforms = &it->second;
+}
+
+const Renderer::LightPassUniforms& Renderer::UseLightPassVariant(ShaderVariants::Key key)
+{
+    const ShaderProgram& prog = mShdrProgs->lightPass.Get(key);
+    GLState().UseProgram(prog.Id());
+
+    auto it = mLightPassUniforms.find(key);
+    if (it == std::end(mLightPassUniforms))
+    {
+        // Link the material block to its binding point and set the sampler units, which the program keeps.
+        // The compact layout has depth and the packed material in place of position and index
+        GLuint materialBlock = prog.GetUniformBlockIndex("MaterialDataBlock");
+        if (materialBlock != GL_INVALID_INDEX)
+            glUniformBlockBinding(prog.Id(), materialBlock, 1);
+        const std::pair<const char*, GLint> samplers[] = {
+            { "gPosition",     0 },
+            { "gDepth",        0 },
+            { "gNormal",       1 },
+            { "gAlbedoSpec",   2 },
+            { "gMatIdx",       3 },
+            { "gMaterial",     3 },
+            { "uShadowMap",    4 },
+            { "irrMap",        5 },
+            { "skybox",        6 },
+            { "radMap",        7 },
+            { "uClusters",     8 },
+            { "uLightIndices", 9 },
+            { "uLightData",    10 },
+            { "gFinal",        11 }
+        };
+        for (const auto& sampler : samplers)
+            prog.GetUniform<GLint>(sampler.first).Set(sampler.second);
+
+        LightPassUniforms lpu;
+        lpu.clusterGrid       = prog.GetUniform<glm::ivec3>("uClusterGrid");
+        lpu.clusterDepthParams = prog.GetUniform<glm::vec2>("uClusterDepthParams");
+        lpu.screenSize        = prog.GetUniform<glm::ivec2>("gScreenSize");
+        lpu.cascadesNear      = prog.GetUniform<GLfloat>("uCascadesNear");
+        lpu.cascadesFar       = prog.GetUniform<GLfloat>("uCascadesFar");
+        lpu.cascadesPlanes    = prog.GetUniform<glm::vec2>("uCascadesPlanes");
+        lpu.cascadesMatrices  = prog.GetUniform<glm::mat4>("uCascadesMatrices");
+        lpu.viewMat           = prog.GetUniform<glm::mat4>("viewMat");
+        lpu.invViewProj       = prog.GetUniform<glm::mat4>("invViewProj");
+        lpu.MVP               = prog.GetUniform<glm::mat4>("MVP");
+        lpu.viewPos           = prog.GetUniform<glm::vec3>("viewPos");
+        lpu.dirLightDirection = prog.GetUniform<glm::vec3>("dirLight.direction");
+        lpu.dirLightColor     = prog.GetUniform<glm::vec3>("dirLight.color");
+        lpu.pLightPosition    = prog.GetUniform<glm::vec3>("pLight.position");
+        lpu.pLightColor       = prog.GetUniform<glm::vec3>("pLight.color");
+        lpu.pLightConstant    = prog.GetUniform<GLfloat>("pLight.attProps.constant");
+        lpu.pLightLinear      = prog.GetUniform<GLfloat>("pLight.attProps.linear");
+        lpu.pLightQuadratic   = prog.GetUniform<GLfloat>("pLight.attProps.quadratic");
+        it = mLightPassUniforms.emplace(key, lpu).first;
+    }
+
+    // Set the uniforms all the light passes share
+    const LightPassUniforms& lpu = it->second;
+    lpu.screenSize.Set(glm::ivec2(mScreenWidth, mScreenHeight));
+    lpu.viewPos.Set(glm::vec3(mInverseView[3].x, mInverseView[3].y, mInverseView[3].z));
+    lpu.viewMat.Set(mView);
+    lpu.invViewProj.Set(mInverseViewProj);
+    return lpu;
 }
 
 void Renderer::SetView(const glm::mat4& view)
@@ -471,6 +685,12 @@ void Renderer::SetDataStores(MaterialStore* matStore)
     mMaterialStore = matStore;
 }
 
+void Renderer::SetJobSystem(JobSystem* jobs)
+{
+    mJobs = jobs;
+    mShadowRenderer.SetJobSystem(jobs);
+}
+
 Lights& Renderer::GetLights()
 {
     return mLights;
@@ -484,10 +704,55 @@ const glm::mat4 Renderer::GetProjection() const
 const std::vector<Renderer::TextureTarget> Renderer::GetTextureTargets() const
 {
     return {
-        TextureTarget{1, 3, mGBuffer->PosId()},
+        TextureTarget{1, 3, mGBufferLayout == GBuffer::Layout::Full ? mGBuffer->PosId() : mGBuffer->MatIndexId()},
         TextureTarget{1, 3, mGBuffer->NormalId()},
         TextureTarget{1, 3, mGBuffer->AlbedoSpecId()},
         TextureTarget{1, 3, mGBuffer->FinalId()},
         TextureTarget{4, 1, mShadowRenderer.DepthMapId()},
     };
 }
+
+const std::vector<unsigned int> Renderer::GetShadowCasterCounts() const
+{
+    return mShadowRenderer.GetSplitCasterCounts();
+}
+
+std::uint64_t Renderer::GetSubmitAllocations() const
+{
+    return mSubmitAllocations;
+}
+
+const FrameRenderStats& Renderer::GetFrameStats() const
+{
+    return RenderStats().GetLastFrameStats();
+}
+
+void Renderer::FlushGpuTimings()
+{
+    mGpuProfiler.Flush();
+}
+
+std::uint64_t Renderer::GetDroppedGpuTimings() const
+{
+    return mGpuProfiler.GetDroppedFrames();
+}
+
+void Renderer::SetLightCulling(LightCulling lightCulling)
+{
+    mLightCulling = lightCulling;
+}
+
+Renderer::LightCulling Renderer::GetLightCulling() const
+{
+    return mLightCulling;
+}
+
+std::size_t Renderer::GetClusterAssignmentCount() const
+{
+    return mLightCulling == LightCulling::Clustered ? mLightClusters.GetAssignmentCount() : 0;
+}
+
+const PrimitiveCache& Renderer::GetPrimitives() const
+{
+    return mPrimitives;
+}
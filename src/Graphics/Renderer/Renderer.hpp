@@ -31,13 +31,24 @@
 #ifndef _RENDERER_HPP_
 #define _RENDERER_HPP_
 
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include "GBuffer.hpp"
 #include "Light.hpp"
 #include "ShadowRenderer.hpp"
-#include "../Scene/Transform.hpp"
+#include "InstanceBuffer.hpp"
+#include "IndirectBuffer.hpp"
+#include "PrimitiveCache.hpp"
+#include "LightClusters.hpp"
+#include "GpuProfiler.hpp"
+#include "RenderStats.hpp"
+#include "../Scene/TransformHierarchy.hpp"
+#include "../Scene/AABB.hpp"
 #include "../Resource/MaterialStore.hpp"
+#include "../Shader/ShaderVariants.hpp"
 
 #include "../../Util/WarnGuard.hpp"
 WARN_GUARD_ON
@@ -49,10 +60,14 @@ class Renderer
     public:
         struct IntMesh
         {
-            Transform transformation;
-            GLuint    vaoId,
-                      eboId,
-                      numIndices;
+            std::uint32_t    transform;
+            const AABB*      aabb;
+            GLuint           vaoId,
+                             eboId,
+                             numIndices;
+            GLint            baseVertex;
+            GLuint           firstIndex;
+            bool             culled;
         };
 
         struct IntMaterial
@@ -66,18 +81,51 @@ class Renderer
 
         using MaterialVecEntry = std::pair<IntMaterial, std::vector<IntMesh>>;
 
+        // Non owning view of the render lists that are submitted each frame
         struct IntForm
         {
-            std::vector<MaterialVecEntry> materials;
+            const std::vector<MaterialVecEntry>* materials = nullptr;
+            const std::vector<ShadowRenderer::IntMesh>* shadowCasters = nullptr;
+            WorldTransforms transforms;
             GLuint skyboxId = 0;
             GLuint irrMapId = 0;
             GLuint radMapId = 0;
         };
 
+        // The ways point lights can be culled in the light pass
+        enum class LightCulling
+        {
+            Clustered,     // A single full screen pass over the lights binned into view clusters
+            StencilVolumes // A stencil and a shading pass over the bounding sphere of each light
+        };
+
+        /*! Shader features of the geometry pass, the bits of its variant keys */
+        enum GeometryPassFeature : ShaderVariants::Key
+        {
+            NormalMap = 1 << 0  // NORMAL_MAP, perturbs the normals with the material's normal map
+        };
+
+        /*! Shader features of the light pass, the bits of its variant keys */
+        enum LightPassFeature : ShaderVariants::Key
+        {
+            LightDir       = 1 << 0, // LIGHT_DIR, the directional light
+            LightPoint     = 1 << 1, // LIGHT_POINT, a single point light
+            LightAmbient   = 1 << 2, // LIGHT_AMBIENT, the environment light
+            LightClustered = 1 << 3, // LIGHT_CLUSTERED, the point lights of the fragment's cluster
+            Shadows        = 1 << 4, // SHADOWS, the cascaded shadow map term
+            Composite      = 1 << 5  // COMPOSITE, gamma corrects the accumulated light of the final texture
+        };
+
+        /*! Retrieves the define of each geometry pass feature, in bit order */
+        static std::vector<std::string> GeometryPassDefines();
+
+        /*! Retrieves the define of each light pass feature, in bit order */
+        static std::vector<std::string> LightPassDefines();
+
         struct ShaderPrograms
         {
-            ShaderProgram geometryPassProg;
-            ShaderProgram lightPassProg;
+            ShaderVariants geometryPass;
+            ShaderVariants lightPass;
         };
 
         /*! Initializes the renderer */
@@ -98,12 +146,22 @@ class Renderer
         /*! Sets the various data stores that hold the GPU handles to data */
         void SetDataStores(MaterialStore* matStore);
 
+        /*! Sets the job system the render lists are built on */
+        void SetJobSystem(JobSystem* jobs);
+
         /*! Sets the view matrix */
         void SetView(const glm::mat4& view);
 
-        /*! Sets the used shader programs */
+        /*! Sets the used shader programs, compiling the variants the passes use.
+            Throws std::runtime_error and keeps the current ones if they fail to build */
         void SetShaderPrograms(std::unique_ptr<ShaderPrograms> shdrProgs);
 
+        /*! Sets the GBuffer layout, the shader programs must be built for it */
+        void SetGBufferLayout(GBuffer::Layout layout);
+
+        /*! Retrieves the GBuffer layout */
+        GBuffer::Layout GetGBufferLayout() const;
+
         /*! Retrieves the renderer's Lights */
         Lights& GetLights();
 
@@ -115,22 +173,70 @@ class Renderer
         using TextureTarget = std::tuple<std::uint8_t, std::uint8_t, GLuint>;
         const std::vector<TextureTarget> GetTextureTargets() const;
 
+        /*! Retrieves the number of shadow casters drawn in each cascade */
+        const std::vector<unsigned int> GetShadowCasterCounts() const;
+
+        /*! Retrieves the number of heap allocations the render thread made while submitting the last frame */
+        std::uint64_t GetSubmitAllocations() const;
+
+        /*! Retrieves the work submitted by each pass during the last completed frame */
+        const FrameRenderStats& GetFrameStats() const;
+
+        /*! Waits for the GPU timings of the frames in flight and records them to the profiler */
+        void FlushGpuTimings();
+
+        /*! Retrieves the number of frames whose GPU timings were not ready in time and were dropped */
+        std::uint64_t GetDroppedGpuTimings() const;
+
+        /*! Sets the point light culling method */
+        void SetLightCulling(LightCulling lightCulling);
+
+        /*! Retrieves the point light culling method */
+        LightCulling GetLightCulling() const;
+
+        /*! Retrieves the number of light to cluster assignments made in the last frame */
+        std::size_t GetClusterAssignmentCount() const;
+
+        /*! Retrieves the shared primitive geometry */
+        const PrimitiveCache& GetPrimitives() const;
+
     private:
+        struct GeometryPassUniforms;
+        struct LightPassUniforms;
+
         // Performs the geometry pass rendering step
         void GeometryPass(float interpolation, const IntForm& intForm);
 
         // Performs the light pass rendering step
         void LightPass(float interpolation, const IntForm& intForm);
 
+        // Shades all the point lights with a single pass over the light clusters
+        void ClusteredPointLightPass();
+
+        // Shades each point light with a stencil pass and a pass over its bounding sphere
+        void StencilVolumePointLightPasses();
+
         // Performs a stencil pass
         void StencilPass(const PointLight& pLight);
 
+        // Writes the linear light the passes accumulated to the default framebuffer, gamma corrected once
+        void CompositePass();
+
+        // Binds the geometry pass variant of the given features, resolving its uniforms on first use
+        void UseGeometryPassVariant(ShaderVariants::Key key);
+
+        // Binds the light pass variant of the given features and sets the uniforms all light passes share
+        const LightPassUniforms& UseLightPassVariant(ShaderVariants::Key key);
+
         // The projection matrix
         glm::mat4 mProjection;
 
         // The view matrix
         glm::mat4 mView;
 
+        // The inverses of the view and view-projection matrices, computed once per frame
+        glm::mat4 mInverseView, mInverseViewProj;
+
         // The screen size
         int mScreenWidth, mScreenHeight;
 
@@ -140,20 +246,80 @@ class Renderer
         // References to various data stores
         MaterialStore* mMaterialStore;
 
-        // Shader programIds of the geometry pass and the lighting pass
+        // Splits the render list building over its threads, serial when null
+        JobSystem* mJobs = nullptr;
+
+        // Shader program variants of the geometry pass and the lighting pass
         std::unique_ptr<ShaderPrograms> mShdrProgs;
 
         // The GBuffer used by the deffered rendering steps
         std::unique_ptr<GBuffer> mGBuffer;
+        GBuffer::Layout mGBufferLayout = GBuffer::Layout::Full;
 
         // The null program used by the stencil passes
         std::unique_ptr<ShaderProgram> mNullProgram;
+        Uniform<glm::mat4> mNullProgMVP;
+
+        // Pre-resolved uniforms of the geometry pass variants
+        struct GeometryPassUniforms
+        {
+            Uniform<GLuint> matIdx;
+        };
+        std::unordered_map<ShaderVariants::Key, GeometryPassUniforms> mGeomPassUniforms;
+        const GeometryPassUniforms* mCurGeomPassUniforms = nullptr;
+
+        // Pre-resolved uniforms of the light pass variants, the samplers are set once when resolved
+        struct LightPassUniforms
+        {
+            Uniform<glm::ivec2> screenSize;
+            Uniform<glm::ivec3> clusterGrid;
+            Uniform<glm::vec2>  clusterDepthParams;
+            Uniform<GLfloat>    cascadesNear,
+                                cascadesFar;
+            Uniform<glm::vec2>  cascadesPlanes;
+            Uniform<glm::mat4>  cascadesMatrices,
+                                viewMat,
+                                invViewProj,
+                                MVP;
+            Uniform<glm::vec3>  viewPos,
+                                dirLightDirection,
+                                dirLightColor,
+                                pLightPosition,
+                                pLightColor;
+            Uniform<GLfloat>    pLightConstant,
+                                pLightLinear,
+                                pLightQuadratic;
+        };
+        std::unordered_map<ShaderVariants::Key, LightPassUniforms> mLightPassUniforms;
 
         // The shadow map rendering utility
         ShadowRenderer mShadowRenderer;
 
         // Uniform Buffer objects
         GLuint mUboMatrices;
+
+        // The point light culling method and the cluster grid used by the clustered one
+        LightCulling mLightCulling;
+        LightClusters mLightClusters;
+
+        // Quad, sphere and box geometry shared with the other renderers
+        PrimitiveCache mPrimitives;
+
+        // Times the render passes on the GPU
+        GpuProfiler mGpuProfiler;
+
+        // Per frame instancing data of the geometry pass
+        InstanceBuffer mInstanceBuffer;
+        std::vector<glm::mat4> mInstanceData;
+        std::vector<std::uint32_t> mInstanceSources;
+        std::vector<InstanceBuffer::Batch> mInstanceBatches;
+        std::vector<const IntMesh*> mBatchScratch;
+
+        // Draw commands of the batches, when multi draw indirect is supported
+        IndirectBuffer mIndirectBuffer;
+
+        // Heap allocations made while submitting the last frame
+        std::uint64_t mSubmitAllocations;
 };
 
 #endif // ! _RENDERER_HPP_
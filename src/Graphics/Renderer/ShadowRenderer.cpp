@@ -1,5 +1,11 @@
 #include "ShadowRenderer.hpp"
+#include "GLStateCache.hpp"
+#include "RenderStats.hpp"
+#include "../../Core/JobSystem.hpp"
+#include "../../Core/Profiler.hpp"
 #include <assert.h>
+#include <algorithm>
+#include <tuple>
 
 WARN_GUARD_ON
 #include <glm/common.hpp>
@@ -10,56 +16,32 @@ WARN_GUARD_OFF
 static const char* vShader = R"foo(
 #version 330 core
 layout (location = 0) in vec3 position;
+layout (location = 4) in mat4 model;
 
-uniform mat4 model;
+uniform mat4 uCascadeViewMatrix;
+uniform mat4 uCascadeProjMatrix;
 
-void main()
-{
-    gl_Position = model * vec4(position, 1.0f);
-}
-)foo";
-
-static const char* gShader = R"foo(
-#version 330 core
-#extension GL_ARB_gpu_shader5 : enable
-
-layout(triangles, invocations = 4) in;
-layout(triangle_strip, max_vertices = 3) out;
-
-uniform mat4 uCascadesViewMatrices[4];
-uniform mat4 uCascadesProjMatrices[4];
-
-out float gLayer;
-out vec3  vsPosition;
+out vec3 vsPosition;
 
 void main()
 {
-    for(int i = 0; i < gl_in.length(); ++i)
-    {
-        vec4 pos    = (uCascadesViewMatrices[gl_InvocationID] * gl_in[i].gl_Position);
-        gl_Position = uCascadesProjMatrices[gl_InvocationID] * pos;
-        vsPosition  = pos.xyz;
-        gl_Layer    = gl_InvocationID;
-        gLayer      = float(gl_InvocationID);
-        EmitVertex();
-    }
-    EndPrimitive();
+    vec4 pos    = uCascadeViewMatrix * model * vec4(position, 1.0f);
+    gl_Position = uCascadeProjMatrix * pos;
+    vsPosition  = pos.xyz;
 }
 )foo";
 
 static const char* fShader = R"foo(
 #version 330 core
 
-uniform float uCascadesNear[4];
-uniform float uCascadesFar[4];
+uniform float uCascadeNear;
+uniform float uCascadeFar;
 
-in float gLayer;
 in vec3 vsPosition;
 
 void main()
 {
-    int layer = int(gLayer);
-    float linearDepth = (-vsPosition.z - uCascadesNear[layer]) / (uCascadesFar[layer] - uCascadesNear[layer]);
+    float linearDepth = (-vsPosition.z - uCascadeNear) / (uCascadeFar - uCascadeNear);
     gl_FragDepth = linearDepth;
 }
 )foo";
@@ -71,13 +53,16 @@ void ShadowRenderer::Init(unsigned int width, unsigned int height)
     mSplitNum = 4;
 
     Shader vert(vShader, Shader::Type::Vertex);
-    Shader geom(gShader, Shader::Type::Geometry);
     Shader frag(fShader, Shader::Type::Fragment);
-    mProgram = std::make_unique<ShaderProgram>(vert.Id(), geom.Id(), frag.Id());
+    mProgram = std::make_unique<ShaderProgram>(vert.Id(), frag.Id());
+    mCascadeProjMatrixUniform = mProgram->GetUniform<glm::mat4>("uCascadeProjMatrix");
+    mCascadeViewMatrixUniform = mProgram->GetUniform<glm::mat4>("uCascadeViewMatrix");
+    mCascadeNearUniform       = mProgram->GetUniform<GLfloat>("uCascadeNear");
+    mCascadeFarUniform        = mProgram->GetUniform<GLfloat>("uCascadeFar");
 
     // Create textures that will hold the shadow maps
     glGenTextures(1, &mDepthMapId);
-    glBindTexture(GL_TEXTURE_2D_ARRAY, mDepthMapId);
+    GLState().BindTexture(GL_TEXTURE_2D_ARRAY, mDepthMapId);
 
     glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT, width, height, mSplitNum, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
     glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -87,89 +72,156 @@ void ShadowRenderer::Init(unsigned int width, unsigned int height)
     GLfloat borderColor[] = { 1.0, 1.0, 1.0, 1.0 };
     glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
 
-    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    GLState().BindTexture(GL_TEXTURE_2D_ARRAY, 0);
 
     // Prepare framebuffer
     glGenFramebuffers(1, &mDepthMapFboId);
-    glBindFramebuffer(GL_FRAMEBUFFER, mDepthMapFboId);
+    GLState().BindFramebuffer(GL_FRAMEBUFFER, mDepthMapFboId);
     //glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, mDepthMapId, 0);
     glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, mDepthMapId, 0);
 
     glDrawBuffer(GL_NONE);
     glReadBuffer(GL_NONE);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState().BindFramebuffer(GL_FRAMEBUFFER, 0);
 
     // Check if framebuffer is complete
     assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+
+    // Create the instance buffer
+    mInstanceBuffer.Init();
+    mIndirectBuffer.Init();
 }
 
 void ShadowRenderer::Shutdown()
 {
-    glDeleteTextures(1, &mDepthMapId);
-    glDeleteFramebuffers(1, &mDepthMapFboId);
+    GLState().DeleteTextures(1, &mDepthMapId);
+    GLState().DeleteFramebuffers(1, &mDepthMapFboId);
+    mInstanceBuffer.Shutdown();
+    mIndirectBuffer.Shutdown();
 }
 
-void ShadowRenderer::Render(float interpolation, std::vector<IntMesh> scene)
+void ShadowRenderer::Render(float interpolation, const std::vector<IntMesh>& scene, const WorldTransforms& transforms)
 {
-    glEnable(GL_DEPTH_TEST);
-    glCullFace(GL_FRONT);
+    // Build the per cascade draw lists from the casters that touch each cascade's light frustum,
+    // one cascade per job, and sort them so the casters sharing the same geometry are adjacent
+    mDrawLists.resize(mSplitNum);
+    ParallelFor(mJobs, mSplitNum, 1,
+        [this, &scene](std::size_t begin, std::size_t end)
+        {
+            PROFILE_SCOPE("ShadowDrawLists");
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                auto& drawList = mDrawLists[i];
+                drawList.clear();
+                for (const auto& gObj : scene)
+                    if (Intersects(mFrusta[i], *gObj.aabb))
+                        drawList.push_back(&gObj);
+
+                std::sort(std::begin(drawList), std::end(drawList),
+                    [](const IntMesh* a, const IntMesh* b) -> bool
+                    {
+                        return std::tie(a->vaoId, a->eboId, a->firstIndex, a->baseVertex)
+                     < std::tie(b->vaoId, b->eboId, b->firstIndex, b->baseVertex);
+                    });
+            }
+        }
+    );
+
+    // Group the casters sharing the same geometry into instanced batches
+    mInstanceSources.clear();
+    mInstanceBatches.clear();
+    for (unsigned int i = 0; i < mSplitNum; ++i)
+    {
+        for (const IntMesh* gObj : mDrawLists[i])
+        {
+            if (mInstanceBatches.empty()
+             || mInstanceBatches.back().group != i
+             || mInstanceBatches.back().vaoId != gObj->vaoId
+             || mInstanceBatches.back().eboId != gObj->eboId
+             || mInstanceBatches.back().firstIndex != gObj->firstIndex
+             || mInstanceBatches.back().baseVertex != gObj->baseVertex)
+            {
+                mInstanceBatches.push_back({i, gObj->vaoId, gObj->eboId, gObj->numIndices, gObj->baseVertex, gObj->firstIndex,
+                                            mInstanceSources.size(), 0});
+            }
+            mInstanceSources.push_back(gObj->transform);
+            ++mInstanceBatches.back().count;
+        }
+    }
+    InterpolateInstances(mJobs, transforms, mInstanceSources, interpolation, mInstanceData);
+
+    // Upload the instance matrices of all cascades
+    PROFILE_SCOPE("ShadowSubmit");
+    mInstanceBuffer.Upload(mInstanceData);
+
+    // Upload the draw commands of all cascades, which read the instance matrices through their base instance
+    const bool indirect = mIndirectBuffer.IsAvailable();
+    if (indirect)
+    {
+        mIndirectBuffer.Upload(mInstanceBatches);
+        mIndirectBuffer.Bind();
+    }
+
+    GLState().Enable(GL_DEPTH_TEST);
+    GLState().CullFace(GL_FRONT);
 
     // Store previous viewport and set the new one
-    GLint viewport[4];
-    glGetIntegerv(GL_VIEWPORT, viewport);
-    glViewport(0, 0, mWidth, mHeight);
+    const std::array<GLint, 4> viewport = GLState().GetViewport();
+    GLState().Viewport(0, 0, mWidth, mHeight);
 
     // Bind shadow map fbo
-    glBindFramebuffer(GL_FRAMEBUFFER, mDepthMapFboId);
-    glClear(GL_DEPTH_BUFFER_BIT);
-    glUseProgram(mProgram->Id());
-
-        // Projection matrices
-        glUniformMatrix4fv(
-            glGetUniformLocation(mProgram->Id(), "uCascadesProjMatrices"),
-            static_cast<GLsizei>(mProjectionMats.size()), GL_FALSE,
-            glm::value_ptr(mProjectionMats[0])
-        );
-        // View matrices
-        glUniformMatrix4fv(
-            glGetUniformLocation(mProgram->Id(), "uCascadesViewMatrices"),
-            static_cast<GLsizei>(mViewMats.size()), GL_FALSE,
-            glm::value_ptr(mViewMats[0])
-        );
-        // Near values
-        glUniform1fv(
-            glGetUniformLocation(mProgram->Id(), "uCascadesNear"),
-            static_cast<GLsizei>(mNearPlanes.size()),
-            mNearPlanes.data()
-        );
-        // Far values
-        glUniform1fv(
-            glGetUniformLocation(mProgram->Id(), "uCascadesFar"),
-            static_cast<GLsizei>(mFarPlanes.size()),
-            mFarPlanes.data()
-        );
+    GLState().BindFramebuffer(GL_FRAMEBUFFER, mDepthMapFboId);
+    GLState().UseProgram(mProgram->Id());
 
-    for (const auto& gObj : scene)
+    // Batches are ordered by cascade
+    std::size_t b = 0;
+    for (unsigned int i = 0; i < mSplitNum; ++i)
     {
-        // Upload needed uniforms
-        glm::mat4 model = gObj.transform.GetInterpolated(interpolation);
-        glUniformMatrix4fv(glGetUniformLocation(mProgram->Id(), "model"), 1, GL_FALSE, glm::value_ptr(model));
-
-        glBindVertexArray(gObj.vaoId);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gObj.eboId);
-        glDrawElements(GL_TRIANGLES, gObj.numIndices, GL_UNSIGNED_INT, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+        RenderPassScope pass(ShadowCascadePass(i));
+
+        // Attach the cascade's layer and clear it
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, mDepthMapId, 0, i);
+        glClear(GL_DEPTH_BUFFER_BIT);
+
+        // Upload cascade properties
+        mCascadeProjMatrixUniform.Set(mProjectionMats[i]);
+        mCascadeViewMatrixUniform.Set(mViewMats[i]);
+        mCascadeNearUniform.Set(mNearPlanes[i]);
+        mCascadeFarUniform.Set(mFarPlanes[i]);
+
+        while (b < mInstanceBatches.size() && mInstanceBatches[b].group == i)
+        {
+            const InstanceBuffer::Batch& batch = mInstanceBatches[b];
+            GLState().BindVertexArray(batch.vaoId);
+            GLState().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.eboId);
+            if (indirect)
+            {
+                // Draw the batches of the cascade sharing the geometry buffers at once
+                const std::size_t end = BatchRunEnd(mInstanceBatches, b);
+                mInstanceBuffer.BindAttributes(0);
+                mIndirectBuffer.Draw(b, end - b);
+                b = end;
+            }
+            else
+            {
+                mInstanceBuffer.BindAttributes(batch.first);
+                glDrawElementsInstancedBaseVertex(GL_TRIANGLES, batch.numIndices, GL_UNSIGNED_INT,
+                    (GLvoid*)(batch.firstIndex * sizeof(GLuint)), static_cast<GLsizei>(batch.count), batch.baseVertex);
+                RenderStats().CountDraw(GL_TRIANGLES, batch.numIndices, static_cast<GLsizei>(batch.count));
+                ++b;
+            }
+        }
     }
+    GLState().BindVertexArray(0);
 
-    glUseProgram(0);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState().UseProgram(0);
+    GLState().BindFramebuffer(GL_FRAMEBUFFER, 0);
 
     // Restore viewport
-    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    GLState().Viewport(viewport[0], viewport[1], viewport[2], viewport[3]);
 
-    glCullFace(GL_BACK);
-    glDisable(GL_DEPTH_TEST);
+    GLState().CullFace(GL_BACK);
+    GLState().Disable(GL_DEPTH_TEST);
 }
 
 static float ExtractFovFromProjection(const glm::mat4& projection)
@@ -193,6 +245,11 @@ static float ExtractAspectFromProjection(const glm::mat4& projection)
     return aspect;
 }
 
+void ShadowRenderer::SetJobSystem(JobSystem* jobs)
+{
+    mJobs = jobs;
+}
+
 void ShadowRenderer::SetLightViewParams(const glm::mat4& projection, const glm::mat4& view, const glm::vec3& lightPos)
 {
     // Get projection properties
@@ -213,6 +270,7 @@ void ShadowRenderer::SetLightViewParams(const glm::mat4& projection, const glm::
     mPlanes.clear();
     mNearPlanes.clear();
     mFarPlanes.clear();
+    mFrusta.clear();
 
     const float splitLambda = 0.5f;
     const unsigned int splitNum = mSplitNum;
@@ -295,6 +353,7 @@ void ShadowRenderer::SetLightViewParams(const glm::mat4& projection, const glm::
         mPlanes.push_back(glm::vec2(splitNear, splitFar));
         mNearPlanes.push_back(-max.z - nearOffset);
         mFarPlanes.push_back(-min.z + farOffset);
+        mFrusta.emplace_back(projMat * viewMat);
     }
 }
 
@@ -308,32 +367,40 @@ unsigned int ShadowRenderer::GetSplitNum() const
     return mSplitNum;
 }
 
-const std::vector<glm::mat4> ShadowRenderer::GetSplitProjMats() const
+const std::vector<glm::mat4>& ShadowRenderer::GetSplitProjMats() const
 {
     return mProjectionMats;
 }
 
-const std::vector<glm::mat4> ShadowRenderer::GetSplitViewMats() const
+const std::vector<glm::mat4>& ShadowRenderer::GetSplitViewMats() const
 {
     return mViewMats;
 }
 
-const std::vector<glm::mat4> ShadowRenderer::GetSplitShadowMats() const
+const std::vector<glm::mat4>& ShadowRenderer::GetSplitShadowMats() const
 {
     return mShadowMats;
 }
 
-const std::vector<glm::vec2> ShadowRenderer::GetSplitPlanes() const
+const std::vector<glm::vec2>& ShadowRenderer::GetSplitPlanes() const
 {
     return mPlanes;
 }
 
-const std::vector<float> ShadowRenderer::GetSplitNearPlanes() const
+const std::vector<float>& ShadowRenderer::GetSplitNearPlanes() const
 {
     return mNearPlanes;
 }
 
-const std::vector<float> ShadowRenderer::GetSplitFarPlanes() const
+const std::vector<float>& ShadowRenderer::GetSplitFarPlanes() const
 {
     return mFarPlanes;
 }
+
+const std::vector<unsigned int> ShadowRenderer::GetSplitCasterCounts() const
+{
+    std::vector<unsigned int> counts;
+    for (const auto& drawList : mDrawLists)
+        counts.push_back(static_cast<unsigned int>(drawList.size()));
+    return counts;
+}
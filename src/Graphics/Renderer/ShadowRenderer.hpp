@@ -34,8 +34,11 @@
 #include <vector>
 #include <memory>
 #include <glad/glad.h>
-#include "../Scene/Transform.hpp"
+#include "../Scene/TransformHierarchy.hpp"
+#include "../Scene/Frustum.hpp"
 #include "../Shader/Shader.hpp"
+#include "InstanceBuffer.hpp"
+#include "IndirectBuffer.hpp"
 
 #include "../../Util/WarnGuard.hpp"
 WARN_GUARD_ON
@@ -48,10 +51,13 @@ class ShadowRenderer
         // Input scene data
         struct IntMesh
         {
-            Transform transform;
-            GLuint    vaoId,
-                      eboId,
-                      numIndices;
+            std::uint32_t    transform;
+            const AABB*      aabb;
+            GLuint           vaoId,
+                             eboId,
+                             numIndices;
+            GLint            baseVertex;
+            GLuint           firstIndex;
         };
 
         // Initializes the renderer state
@@ -61,7 +67,10 @@ class ShadowRenderer
         void Shutdown();
 
         // Renders the scene from the light's view in the depth buffer
-        void Render(float interpolation, std::vector<IntMesh> scene);
+        void Render(float interpolation, const std::vector<IntMesh>& scene, const WorldTransforms& transforms);
+
+        // Sets the job system the cascade draw lists are built on
+        void SetJobSystem(JobSystem* jobs);
 
         // Sets the light properties
         void SetLightViewParams(const glm::mat4& projection, const glm::mat4& view, const glm::vec3& lightPos);
@@ -71,12 +80,15 @@ class ShadowRenderer
 
         // Retrieves various shadow frustum properties
         unsigned int GetSplitNum() const;
-        const std::vector<glm::mat4> GetSplitProjMats() const;
-        const std::vector<glm::mat4> GetSplitViewMats() const;
-        const std::vector<glm::mat4> GetSplitShadowMats() const;
-        const std::vector<glm::vec2> GetSplitPlanes() const;
-        const std::vector<float> GetSplitNearPlanes() const;
-        const std::vector<float> GetSplitFarPlanes() const;
+        const std::vector<glm::mat4>& GetSplitProjMats() const;
+        const std::vector<glm::mat4>& GetSplitViewMats() const;
+        const std::vector<glm::mat4>& GetSplitShadowMats() const;
+        const std::vector<glm::vec2>& GetSplitPlanes() const;
+        const std::vector<float>& GetSplitNearPlanes() const;
+        const std::vector<float>& GetSplitFarPlanes() const;
+
+        // Retrieves the number of casters drawn in each cascade on the last render
+        const std::vector<unsigned int> GetSplitCasterCounts() const;
 
     private:
         // Dimensions of each shadow map
@@ -86,6 +98,10 @@ class ShadowRenderer
         GLuint mDepthMapId;
         GLuint mDepthMapFboId;
         std::unique_ptr<ShaderProgram> mProgram;
+        Uniform<glm::mat4> mCascadeProjMatrixUniform;
+        Uniform<glm::mat4> mCascadeViewMatrixUniform;
+        Uniform<GLfloat> mCascadeNearUniform;
+        Uniform<GLfloat> mCascadeFarUniform;
 
         // Split data
         unsigned int mSplitNum;
@@ -94,6 +110,22 @@ class ShadowRenderer
         std::vector<glm::mat4> mShadowMats;
         std::vector<glm::vec2> mPlanes;
         std::vector<float> mNearPlanes, mFarPlanes;
+        std::vector<Frustum> mFrusta;
+
+        // Per cascade draw lists
+        std::vector<std::vector<const IntMesh*>> mDrawLists;
+
+        // Builds the cascade draw lists in parallel, serial when null
+        JobSystem* mJobs = nullptr;
+
+        // Per frame instancing data of all cascades
+        InstanceBuffer mInstanceBuffer;
+        std::vector<glm::mat4> mInstanceData;
+        std::vector<std::uint32_t> mInstanceSources;
+        std::vector<InstanceBuffer::Batch> mInstanceBatches;
+
+        // Draw commands of the batches, when multi draw indirect is supported
+        IndirectBuffer mIndirectBuffer;
 };
 
 #endif // ! _SHADOW_RENDERER_HPP_
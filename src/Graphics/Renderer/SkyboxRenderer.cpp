@@ -1,4 +1,6 @@
 #include "SkyboxRenderer.hpp"
+#include "GLStateCache.hpp"
+#include "RenderStats.hpp"
 #include <glm/gtc/type_ptr.hpp>
 
 // The skybox cube vertex data
@@ -81,51 +83,55 @@ void SkyboxRenderer::Init()
     Shader vert(vShader, Shader::Type::Vertex);
     Shader frag(fShader, Shader::Type::Fragment);
     mProgram = std::make_unique<ShaderProgram>(vert.Id(), frag.Id());
+    mProjectionUniform = mProgram->GetUniform<glm::mat4>("projection");
+    mViewUniform = mProgram->GetUniform<glm::mat4>("view");
+    mSkyboxUniform = mProgram->GetUniform<GLint>("skybox");
 
     glGenVertexArrays(1, &mVao);
-    glBindVertexArray(mVao);
+    GLState().BindVertexArray(mVao);
     {
         glGenBuffers(1, &mVbo);
-        glBindBuffer(GL_ARRAY_BUFFER, mVbo);
+        GLState().BindBuffer(GL_ARRAY_BUFFER, mVbo);
         {
             glBufferData(GL_ARRAY_BUFFER, sizeof(skyboxVertices), &skyboxVertices, GL_STATIC_DRAW);
             glEnableVertexAttribArray(0);
             glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), nullptr);
         }
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        GLState().BindBuffer(GL_ARRAY_BUFFER, 0);
     }
-    glBindVertexArray(0);
+    GLState().BindVertexArray(0);
 }
 
 void SkyboxRenderer::Shutdown()
 {
-    glDeleteBuffers(1, &mVbo);
-    glDeleteVertexArrays(1, &mVao);
+    GLState().DeleteBuffers(1, &mVbo);
+    GLState().DeleteVertexArrays(1, &mVao);
 }
 
 void SkyboxRenderer::Render(const glm::mat4& projection, const glm::mat4& view) const
 {
-    glDepthFunc(GL_LEQUAL);
-    glDepthMask(GL_FALSE);
-    glUseProgram(mProgram->Id());
+    RenderPassScope pass(RenderPass::Skybox);
+    GLState().DepthFunc(GL_LEQUAL);
+    GLState().DepthMask(GL_FALSE);
+    GLState().UseProgram(mProgram->Id());
     {
         // Remove any translation component of the view matrix
         glm::mat4 ntView = glm::mat4(glm::mat3(view));
-        glUniformMatrix4fv(glGetUniformLocation(mProgram->Id(), "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-        glUniformMatrix4fv(glGetUniformLocation(mProgram->Id(), "view"), 1, GL_FALSE, glm::value_ptr(ntView));
+        mProjectionUniform.Set(projection);
+        mViewUniform.Set(ntView);
 
-        glActiveTexture(GL_TEXTURE0);
-        glUniform1i(glGetUniformLocation(mProgram->Id(), "skybox"), 0);
+        GLState().ActiveTexture(GL_TEXTURE0);
+        mSkyboxUniform.Set(0);
 
-        glBindVertexArray(mVao);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, mCubemap);
+        GLState().BindVertexArray(mVao);
+        GLState().BindTexture(GL_TEXTURE_CUBE_MAP, mCubemap);
         glDrawArrays(GL_TRIANGLES, 0, 36);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-        glBindVertexArray(0);
+        RenderStats().CountDraw(GL_TRIANGLES, 36);
+        GLState().BindVertexArray(0);
     }
-    glUseProgram(0);
-    glDepthMask(GL_TRUE);
-    glDepthFunc(GL_LESS);
+    GLState().UseProgram(0);
+    GLState().DepthMask(GL_TRUE);
+    GLState().DepthFunc(GL_LESS);
 }
 
 void SkyboxRenderer::SetCubemapId(GLuint id)
@@ -63,6 +63,9 @@ class SkyboxRenderer
     private:
         GLuint mVao, mVbo, mCubemap;
         std::unique_ptr<ShaderProgram> mProgram;
+        Uniform<glm::mat4> mProjectionUniform;
+        Uniform<glm::mat4> mViewUniform;
+        Uniform<GLint> mSkyboxUniform;
 };
 
 #endif // ! _SKYBOX_RENDERER_HPP_
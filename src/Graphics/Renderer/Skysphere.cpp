@@ -1,4 +1,6 @@
 #include "Skysphere.hpp"
+#include "GLStateCache.hpp"
+#include "RenderStats.hpp"
 #include <glm/gtc/type_ptr.hpp>
 #include "../../Asset/Geometry/Geometry.hpp"
 
@@ -38,6 +40,9 @@ Skysphere::Skysphere()
     Shader vert(ssVShader, Shader::Type::Vertex);
     Shader frag(ssFShader, Shader::Type::Fragment);
     mProgram = std::make_unique<ShaderProgram>(vert.Id(), frag.Id());
+    mProjectionUniform = mProgram->GetUniform<glm::mat4>("projection");
+    mViewUniform = mProgram->GetUniform<glm::mat4>("view");
+    mSkyboxUniform = mProgram->GetUniform<GLint>("skybox");
 
     // Sphere geometry
     ModelData sphere = GenUVSphere(1.0f, 32, 32);
@@ -50,39 +55,39 @@ Skysphere::Skysphere()
     glGenBuffers(1, &mEbo);
 
     // Vertex data
-    glBindBuffer(GL_ARRAY_BUFFER, mVbo);
+    GLState().BindBuffer(GL_ARRAY_BUFFER, mVbo);
     glBufferData(GL_ARRAY_BUFFER,
         sphereData.size() * sizeof(VertexData),
         sphereData.data(),
         GL_STATIC_DRAW
     );
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState().BindBuffer(GL_ARRAY_BUFFER, 0);
 
     // Indices
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEbo);
+    GLState().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEbo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER,
         sphereIndices.size() * sizeof(GLuint),
         sphereIndices.data(),
         GL_STATIC_DRAW
     );
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GLState().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     // Vertex attributes
-    glBindVertexArray(mVao);
-    glBindBuffer(GL_ARRAY_BUFFER, mVbo);
+    GLState().BindVertexArray(mVao);
+    GLState().BindBuffer(GL_ARRAY_BUFFER, mVbo);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (GLvoid*)(offsetof(VertexData, vx)));
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(VertexData), (GLvoid*)(offsetof(VertexData, tx)));
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState().BindBuffer(GL_ARRAY_BUFFER, 0);
     glEnableVertexAttribArray(0);
     glEnableVertexAttribArray(1);
-    glBindVertexArray(0);
+    GLState().BindVertexArray(0);
 }
 
 Skysphere::~Skysphere()
 {
-    glDeleteBuffers(1, &mEbo);
-    glDeleteBuffers(1, &mVbo);
-    glDeleteVertexArrays(1, &mVao);
+    GLState().DeleteBuffers(1, &mEbo);
+    GLState().DeleteBuffers(1, &mVbo);
+    GLState().DeleteVertexArrays(1, &mVao);
 }
 
 void Skysphere::Load(const RawImage& image)
@@ -91,7 +96,7 @@ void Skysphere::Load(const RawImage& image)
     glGenTextures(1, &mTexture);
 
     // Setup image texture params
-    glBindTexture(GL_TEXTURE_2D, mTexture);
+    GLState().BindTexture(GL_TEXTURE_2D, mTexture);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
@@ -103,35 +108,35 @@ void Skysphere::Load(const RawImage& image)
 
     // Upload image data
     glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState().BindTexture(GL_TEXTURE_2D, 0);
 }
 
 void Skysphere::Render(const glm::mat4& projection, const glm::mat4& view) const
 {
-    glDepthFunc(GL_LEQUAL);
-    glDepthMask(GL_FALSE);
-    glUseProgram(mProgram->Id());
+    RenderPassScope pass(RenderPass::Skybox);
+    GLState().DepthFunc(GL_LEQUAL);
+    GLState().DepthMask(GL_FALSE);
+    GLState().UseProgram(mProgram->Id());
     {
         // Remove any translation component of the view matrix
         glm::mat4 ntView = glm::mat4(glm::mat3(view));
-        glUniformMatrix4fv(glGetUniformLocation(mProgram->Id(), "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-        glUniformMatrix4fv(glGetUniformLocation(mProgram->Id(), "view"), 1, GL_FALSE, glm::value_ptr(ntView));
+        mProjectionUniform.Set(projection);
+        mViewUniform.Set(ntView);
 
-        glUniform1i(glGetUniformLocation(mProgram->Id(), "skybox"), 0);
+        mSkyboxUniform.Set(0);
 
         // Render
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, mTexture);
-        glBindVertexArray(mVao);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEbo);
+        GLState().ActiveTexture(GL_TEXTURE0);
+        GLState().BindTexture(GL_TEXTURE_2D, mTexture);
+        GLState().BindVertexArray(mVao);
+        GLState().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEbo);
         glDrawElements(GL_TRIANGLES, mSphereNumIndices, GL_UNSIGNED_INT, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        RenderStats().CountDraw(GL_TRIANGLES, mSphereNumIndices);
+        GLState().BindVertexArray(0);
     }
-    glUseProgram(0);
-    glDepthMask(GL_TRUE);
-    glDepthFunc(GL_LESS);
+    GLState().UseProgram(0);
+    GLState().DepthMask(GL_TRUE);
+    GLState().DepthFunc(GL_LESS);
 }
 
 GLuint Skysphere::GetTextureId() const
@@ -64,6 +64,9 @@ class Skysphere
         GLuint mTexture;
         GLsizei mSphereNumIndices;
         std::unique_ptr<ShaderProgram> mProgram;
+        Uniform<glm::mat4> mProjectionUniform;
+        Uniform<glm::mat4> mViewUniform;
+        Uniform<GLint> mSkyboxUniform;
 };
 
 #endif // ! _SKYSPHERE_HPP_
@@ -1,4 +1,6 @@
 #include "TextRenderer.hpp"
+#include "GLStateCache.hpp"
+#include "RenderStats.hpp"
 
 WARN_GUARD_ON
 #include <glm/gtc/type_ptr.hpp>
@@ -43,23 +45,26 @@ void TextRenderer::Init(int width, int height)
     Shader vShader(textVertexSh, Shader::Type::Vertex);
     Shader fShader(textFragSh, Shader::Type::Fragment);
     mProgram = std::make_unique<ShaderProgram>(vShader.Id(), fShader.Id());
+    mProjectionUniform = mProgram->GetUniform<glm::mat4>("projection");
+    mTextColorUniform = mProgram->GetUniform<glm::vec3>("textColor");
+    mTextUniform = mProgram->GetUniform<GLint>("text");
 
     // Setup the rendering quad
     glGenVertexArrays(1, &mVao);
     glGenBuffers(1, &mVbo);
 
-    glBindVertexArray(mVao);
+    GLState().BindVertexArray(mVao);
     {
-        glBindBuffer(GL_ARRAY_BUFFER, mVbo);
+        GLState().BindBuffer(GL_ARRAY_BUFFER, mVbo);
 
         // 2D quad needs 6 vertices * 4 floats each (2 for pos + 2 for texCoords)
         glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), nullptr);
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        GLState().BindBuffer(GL_ARRAY_BUFFER, 0);
     }
-    glBindVertexArray(0);
+    GLState().BindVertexArray(0);
 }
 
 void TextRenderer::Resize(int width, int height)
@@ -103,24 +108,27 @@ void TextRenderer::Resize(int width, int height)
 
 void TextRenderer::RenderText(const std::string& text, float x, float y, int pixelHeight, glm::vec3 color, const std::string& font)
 {
+    RenderPassScope pass(RenderPass::Text);
+    GLStateCache& state = GLState();
+
     // Store previous blending state
-    GLboolean blend = glIsEnabled(GL_BLEND);
+    bool blend = state.IsEnabled(GL_BLEND);
 
-    // Store previous src alpha blend function
-    GLint srcAlphaBlendFunc;
-    glGetIntegerv(GL_BLEND_SRC_ALPHA, &srcAlphaBlendFunc);
+    // Store previous blend function
+    GLenum blendSrc, blendDst;
+    state.GetBlendFunc(blendSrc, blendDst);
 
     // Enable blending
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    state.Enable(GL_BLEND);
+    state.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    glUseProgram(mProgram->Id());
-    glUniformMatrix4fv(glGetUniformLocation(mProgram->Id(), "projection"), 1, GL_FALSE, glm::value_ptr(mProjection));
-    glUniform3f(glGetUniformLocation(mProgram->Id(), "textColor"), color.x, color.y, color.z);
-    glUniform1i(glGetUniformLocation(mProgram->Id(), "text"), 0);
+    state.UseProgram(mProgram->Id());
+    mProjectionUniform.Set(mProjection);
+    mTextColorUniform.Set(color);
+    mTextUniform.Set(0);
 
-    glBindVertexArray(mVao);
-    glActiveTexture(GL_TEXTURE0);
+    state.BindVertexArray(mVao);
+    state.ActiveTexture(GL_TEXTURE0);
 
     float curX = x;
     const Font* fontFace = mFontStore[font];
@@ -147,31 +155,29 @@ void TextRenderer::RenderText(const std::string& text, float x, float y, int pix
             { xPos + width, yPos + height, 1.0, 0.0 }
         };
         // Render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, glyph->texId);
-        glBindBuffer(GL_ARRAY_BUFFER, mVbo);
+        state.BindTexture(GL_TEXTURE_2D, glyph->texId);
+        state.BindBuffer(GL_ARRAY_BUFFER, mVbo);
         glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
         glDrawArrays(GL_TRIANGLES, 0, 6);
+        RenderStats().CountBufferUpload(sizeof(vertices));
+        RenderStats().CountDraw(GL_TRIANGLES, 6);
 
         // Advance cursor for next glyph (advance is number of 1/64 pixels)
         curX += (glyph->advance >> 6) * scale;
     }
 
-    glBindVertexArray(0);
-    glUseProgram(0);
+    state.BindVertexArray(0);
+    state.UseProgram(0);
 
     // Restore blending options
-    glBlendFunc(GL_SRC_ALPHA, srcAlphaBlendFunc);
-    if(blend)
-        glEnable(GL_BLEND);
-    else
-        glDisable(GL_BLEND);
+    state.BlendFunc(blendSrc, blendDst);
+    state.SetEnabled(GL_BLEND, blend);
 }
 
 void TextRenderer::Shutdown()
 {
-    glDeleteBuffers(1, &mVbo);
-    glDeleteVertexArrays(1, &mVao);
+    GLState().DeleteBuffers(1, &mVbo);
+    GLState().DeleteVertexArrays(1, &mVao);
 }
 
 FontStore& TextRenderer::GetFontStore()
@@ -72,6 +72,9 @@ class TextRenderer
 
         // The font renderer OpenGL program
         std::unique_ptr<ShaderProgram> mProgram;
+        Uniform<glm::mat4> mProjectionUniform;
+        Uniform<glm::vec3> mTextColorUniform;
+        Uniform<GLint> mTextUniform;
 };
 
 #endif // ! _TEXT_RENDERER_HPP_
@@ -1,4 +1,6 @@
 #include "CubemapStore.hpp"
+#include "../../Core/Profiler.hpp"
+#include "../Renderer/GLStateCache.hpp"
 
 CubemapStore::CubemapStore()
 {
@@ -11,9 +13,11 @@ CubemapStore::~CubemapStore()
 
 void CubemapStore::Load(const std::string& name, const std::unordered_map<Target, RawImage>& images, GLuint level /*= 0*/)
 {
+    PROFILE_SCOPE("UploadCubemap");
+
     CubemapDescription cubemap;
     glGenTextures(1, &cubemap.id);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap.id);
+    GLState().BindTexture(GL_TEXTURE_CUBE_MAP, cubemap.id);
 
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
@@ -28,7 +32,7 @@ void CubemapStore::Load(const std::string& name, const std::unordered_map<Target
                      0, GL_RGB, GL_UNSIGNED_BYTE, p.second.Data());
 
     glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    GLState().BindTexture(GL_TEXTURE_CUBE_MAP, 0);
 
     mCubemaps.insert({name, cubemap});
 }
@@ -67,9 +71,11 @@ static void crossFaceOffset(GLenum target, int* offx, int* offy, int width)
 
 void CubemapStore::Load(const std::string& name, const RawImage& img, GLuint level /*= 0*/)
 {
+    PROFILE_SCOPE("UploadCubemap");
+
     CubemapDescription cubemap;
     glGenTextures(1, &cubemap.id);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap.id);
+    GLState().BindTexture(GL_TEXTURE_CUBE_MAP, cubemap.id);
 
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
@@ -103,7 +109,7 @@ void CubemapStore::Load(const std::string& name, const RawImage& img, GLuint lev
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 
     glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    GLState().BindTexture(GL_TEXTURE_CUBE_MAP, 0);
 
     mCubemaps.insert({name, cubemap});
 }
@@ -117,6 +123,6 @@ CubemapDescription* CubemapStore::operator[](const std::string& name)
 void CubemapStore::Clear()
 {
     for (const auto& p : mCubemaps)
-        glDeleteTextures(1, &p.second.id);
+        GLState().DeleteTextures(1, &p.second.id);
     mCubemaps.clear();
 }
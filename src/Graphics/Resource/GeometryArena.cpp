@@ -0,0 +1,241 @@
+#include "GeometryArena.hpp"
+#include <algorithm>
+#include <cstddef>
+#include "../Renderer/GLStateCache.hpp"
+#include "../Renderer/RenderStats.hpp"
+
+GeometryArena::GeometryArena()
+    : mVao(0)
+    , mVbo(0)
+    , mEbo(0)
+{
+}
+
+void GeometryArena::Init(std::size_t vertexCapacity, std::size_t indexCapacity)
+{
+    glGenVertexArrays(1, &mVao);
+    glGenBuffers(1, &mVbo);
+    glGenBuffers(1, &mEbo);
+
+    GLState().BindVertexArray(mVao);
+    {
+        GLState().BindBuffer(GL_ARRAY_BUFFER, mVbo);
+        glBufferData(GL_ARRAY_BUFFER, vertexCapacity * sizeof(VertexData), nullptr, GL_STATIC_DRAW);
+
+        // Vertices
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (GLvoid*)(offsetof(VertexData, vx)));
+        glEnableVertexAttribArray(0);
+
+        // Normals
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (GLvoid*)(offsetof(VertexData, nx)));
+        glEnableVertexAttribArray(1);
+
+        // TexCoords
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VertexData), (GLvoid*)(offsetof(VertexData, tx)));
+        glEnableVertexAttribArray(2);
+
+        // Tangent
+        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (GLvoid*)(offsetof(VertexData, tnx)));
+        glEnableVertexAttribArray(3);
+
+        GLState().BindBuffer(GL_ARRAY_BUFFER, 0);
+
+        // The index buffer binding is VAO state, so it stays attached
+        GLState().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEbo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCapacity * sizeof(std::uint32_t), nullptr, GL_STATIC_DRAW);
+    }
+    GLState().BindVertexArray(0);
+
+    mVertices.Reset(vertexCapacity);
+    mIndices.Reset(indexCapacity);
+}
+
+void GeometryArena::Shutdown()
+{
+    if (!IsInitialized())
+        return;
+
+    GLState().DeleteVertexArrays(1, &mVao);
+    GLState().DeleteBuffers(1, &mVbo);
+    GLState().DeleteBuffers(1, &mEbo);
+    mVao = mVbo = mEbo = 0;
+    mVertices.Reset(0);
+    mIndices.Reset(0);
+}
+
+bool GeometryArena::IsInitialized() const
+{
+    return mVao != 0;
+}
+
+GeometryArena::Range GeometryArena::Upload(const std::vector<VertexData>& vertices, const std::vector<std::uint32_t>& indices)
+{
+    Range range = {};
+    range.numVertices = static_cast<GLsizei>(vertices.size());
+    range.numIndices = static_cast<GLsizei>(indices.size());
+
+    std::size_t firstVertex = mVertices.Allocate(vertices.size());
+    if (firstVertex == RangeAllocator::Invalid && !vertices.empty())
+    {
+        GrowToFit(mVertices, mVbo, sizeof(VertexData), vertices.size());
+        firstVertex = mVertices.Allocate(vertices.size());
+    }
+    std::size_t firstIndex = mIndices.Allocate(indices.size());
+    if (firstIndex == RangeAllocator::Invalid && !indices.empty())
+    {
+        GrowToFit(mIndices, mEbo, sizeof(std::uint32_t), indices.size());
+        firstIndex = mIndices.Allocate(indices.size());
+    }
+
+    // Empty meshes take no space
+    if (vertices.empty())
+        firstVertex = 0;
+    if (indices.empty())
+        firstIndex = 0;
+    range.baseVertex = static_cast<GLint>(firstVertex);
+    range.firstIndex = static_cast<GLuint>(firstIndex);
+
+    // Upload through the copy target, leaving the VAO and its index buffer binding alone
+    GLState().BindBuffer(GL_COPY_WRITE_BUFFER, mVbo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, firstVertex * sizeof(VertexData), vertices.size() * sizeof(VertexData), vertices.data());
+    GLState().BindBuffer(GL_COPY_WRITE_BUFFER, mEbo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, firstIndex * sizeof(std::uint32_t), indices.size() * sizeof(std::uint32_t), indices.data());
+    GLState().BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    RenderStats().CountBufferUpload(vertices.size() * sizeof(VertexData) + indices.size() * sizeof(std::uint32_t));
+
+    return range;
+}
+
+void GeometryArena::Free(const Range& range)
+{
+    mVertices.Free(static_cast<std::size_t>(range.baseVertex), static_cast<std::size_t>(range.numVertices));
+    mIndices.Free(range.firstIndex, static_cast<std::size_t>(range.numIndices));
+}
+
+void GeometryArena::Defragment(const std::vector<Range*>& ranges)
+{
+    // Lays the ranges out back to back in their current order, through a scratch buffer, as copies within a buffer may not overlap
+    auto compact = [&ranges](GLuint buffer, std::size_t used, std::size_t elementSize,
+                             auto offset, auto size)
+    {
+        std::vector<Range*> sorted;
+        for (Range* r : ranges)
+            if (size(*r) != 0)
+                sorted.push_back(r);
+        std::sort(std::begin(sorted), std::end(sorted),
+            [&offset](const Range* a, const Range* b) { return offset(*a) < offset(*b); });
+
+        GLuint scratch;
+        glGenBuffers(1, &scratch);
+        GLState().BindBuffer(GL_COPY_WRITE_BUFFER, scratch);
+        glBufferData(GL_COPY_WRITE_BUFFER, std::max<std::size_t>(used, 1) * elementSize, nullptr, GL_STREAM_COPY);
+        GLState().BindBuffer(GL_COPY_READ_BUFFER, buffer);
+
+        std::vector<std::size_t> packed;
+        std::size_t next = 0;
+        for (Range* r : sorted)
+        {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                offset(*r) * elementSize, next * elementSize, size(*r) * elementSize);
+            packed.push_back(next);
+            next += size(*r);
+        }
+
+        GLState().BindBuffer(GL_COPY_READ_BUFFER, scratch);
+        GLState().BindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        if (next != 0)
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, next * elementSize);
+        GLState().BindBuffer(GL_COPY_READ_BUFFER, 0);
+        GLState().BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        GLState().DeleteBuffers(1, &scratch);
+
+        return std::make_pair(sorted, packed);
+    };
+
+    const auto vertices = compact(mVbo, mVertices.GetUsed(), sizeof(VertexData),
+        [](const Range& r) { return static_cast<std::size_t>(r.baseVertex); },
+        [](const Range& r) { return static_cast<std::size_t>(r.numVertices); });
+    const auto indices = compact(mEbo, mIndices.GetUsed(), sizeof(std::uint32_t),
+        [](const Range& r) { return static_cast<std::size_t>(r.firstIndex); },
+        [](const Range& r) { return static_cast<std::size_t>(r.numIndices); });
+
+    for (std::size_t i = 0; i < vertices.first.size(); ++i)
+        vertices.first[i]->baseVertex = static_cast<GLint>(vertices.second[i]);
+    for (std::size_t i = 0; i < indices.first.size(); ++i)
+        indices.first[i]->firstIndex = static_cast<GLuint>(indices.second[i]);
+
+    // All the space in use is now at the start
+    const std::size_t usedVertices = mVertices.GetUsed();
+    const std::size_t usedIndices = mIndices.GetUsed();
+    mVertices.Reset(mVertices.GetCapacity());
+    mVertices.Allocate(usedVertices);
+    mIndices.Reset(mIndices.GetCapacity());
+    mIndices.Allocate(usedIndices);
+}
+
+GLuint GeometryArena::GetVao() const
+{
+    return mVao;
+}
+
+GLuint GeometryArena::GetVbo() const
+{
+    return mVbo;
+}
+
+GLuint GeometryArena::GetEbo() const
+{
+    return mEbo;
+}
+
+std::size_t GeometryArena::GetUsedVertices() const
+{
+    return mVertices.GetUsed();
+}
+
+std::size_t GeometryArena::GetVertexCapacity() const
+{
+    return mVertices.GetCapacity();
+}
+
+std::size_t GeometryArena::GetUsedIndices() const
+{
+    return mIndices.GetUsed();
+}
+
+std::size_t GeometryArena::GetIndexCapacity() const
+{
+    return mIndices.GetCapacity();
+}
+
+//--------------------------------------------------
+// Private functions
+//--------------------------------------------------
+void GeometryArena::ResizeBuffer(GLuint buffer, std::size_t oldSize, std::size_t newSize)
+{
+    // Park the contents in a scratch buffer while the storage is reallocated
+    GLuint scratch;
+    glGenBuffers(1, &scratch);
+    GLState().BindBuffer(GL_COPY_WRITE_BUFFER, scratch);
+    glBufferData(GL_COPY_WRITE_BUFFER, oldSize, nullptr, GL_STREAM_COPY);
+    GLState().BindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldSize);
+
+    GLState().BindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, newSize, nullptr, GL_STATIC_DRAW);
+    GLState().BindBuffer(GL_COPY_READ_BUFFER, scratch);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldSize);
+
+    GLState().BindBuffer(GL_COPY_READ_BUFFER, 0);
+    GLState().BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    GLState().DeleteBuffers(1, &scratch);
+}
+
+void GeometryArena::GrowToFit(RangeAllocator& allocator, GLuint buffer, std::size_t elementSize, std::size_t size)
+{
+    // Double the capacity, or more for a mesh larger than the free space at the end
+    const std::size_t oldCapacity = allocator.GetCapacity();
+    const std::size_t newCapacity = std::max(oldCapacity * 2, oldCapacity + size);
+    ResizeBuffer(buffer, oldCapacity * elementSize, newCapacity * elementSize);
+    allocator.Grow(newCapacity);
+}
@@ -0,0 +1,109 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _GEOMETRY_ARENA_HPP_
+#define _GEOMETRY_ARENA_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+#include "../../Asset/Geometry/Geometry.hpp"
+#include "../../Util/RangeAllocator.hpp"
+
+// Packs the vertices and indices of many meshes into one vertex and one index buffer, described by a single VAO.
+// Meshes are drawn through their base vertex and first index, so switching between them needs no rebinding.
+// The buffers grow in place, keeping their names, so the VAO and the buffer ids handed out stay valid
+class GeometryArena
+{
+    public:
+        // The part of the buffers holding a mesh, indices are relative to its base vertex
+        struct Range
+        {
+            GLint   baseVertex;
+            GLsizei numVertices;
+            GLuint  firstIndex;
+            GLsizei numIndices;
+        };
+
+        // Constructor
+        GeometryArena();
+
+        // Creates the buffers with room for the given number of vertices and indices, and the VAO describing them
+        void Init(std::size_t vertexCapacity, std::size_t indexCapacity);
+
+        // Deletes the buffers and the VAO
+        void Shutdown();
+
+        // True between Init and Shutdown
+        bool IsInitialized() const;
+
+        // Uploads a mesh, growing the buffers when it does not fit
+        Range Upload(const std::vector<VertexData>& vertices, const std::vector<std::uint32_t>& indices);
+
+        // Returns the space of a mesh
+        void Free(const Range& range);
+
+        // Moves the given meshes, which must be all the live ones, to the start of the buffers and updates their ranges.
+        // Stalls on the copies, and invalidates the ranges held elsewhere
+        void Defragment(const std::vector<Range*>& ranges);
+
+        // The VAO describing the vertex format, with the index buffer bound
+        GLuint GetVao() const;
+
+        // The vertex and index buffers
+        GLuint GetVbo() const;
+        GLuint GetEbo() const;
+
+        // Space taken by the meshes and total space, in vertices and indices
+        std::size_t GetUsedVertices() const;
+        std::size_t GetVertexCapacity() const;
+        std::size_t GetUsedIndices() const;
+        std::size_t GetIndexCapacity() const;
+
+    private:
+        //--------------------------------------------------
+        // Private functions
+        //--------------------------------------------------
+        // Reallocates the storage of a buffer keeping its name and its first bytes
+        static void ResizeBuffer(GLuint buffer, std::size_t oldSize, std::size_t newSize);
+
+        // Grows the given allocator and its buffer to fit a range of the given size
+        static void GrowToFit(RangeAllocator& allocator, GLuint buffer, std::size_t elementSize, std::size_t size);
+
+        GLuint mVao;
+        GLuint mVbo;
+        GLuint mEbo;
+
+        // Allocators of the vertex and index buffers, in elements
+        RangeAllocator mVertices;
+        RangeAllocator mIndices;
+};
+
+#endif // ! _GEOMETRY_ARENA_HPP_
@@ -1,4 +1,5 @@
 #include "MaterialStore.hpp"
+#include "../Renderer/GLStateCache.hpp"
 
 MaterialStore::MaterialStore()
   : mUBO(0)
@@ -13,7 +14,7 @@ MaterialStore::~MaterialStore()
 void MaterialStore::Clear()
 {
     if (mUBO != 0) {
-        glDeleteBuffers(1, &mUBO);
+        GLState().DeleteBuffers(1, &mUBO);
         mUBO = 0;
     }
     mMaterials.clear();
@@ -72,14 +73,14 @@ void MaterialStore::Load(const std::string& name, const Material& material)
     }
 
     // Reupload all materials to the GPU
-    glBindBuffer(GL_UNIFORM_BUFFER, mUBO);
+    GLState().BindBuffer(GL_UNIFORM_BUFFER, mUBO);
     glBufferData(
         GL_UNIFORM_BUFFER,
         matData.size() * sizeof(MatData),
         matData.data(),
         GL_DYNAMIC_DRAW
     );
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    GLState().BindBuffer(GL_UNIFORM_BUFFER, 0);
 
     // Store material description to relational map
     mMaterials.insert({name, mMaterialDescs.size() - 1});
@@ -1,6 +1,15 @@
 #include "ModelStore.hpp"
+#include "../../Core/Profiler.hpp"
+
+namespace
+{
+// Initial size of the geometry arena, in vertices and indices
+const std::size_t InitialVertexCapacity = 1 << 16;
+const std::size_t InitialIndexCapacity = 1 << 18;
+}
 
 ModelStore::ModelStore()
+    : mGeometryVersion(0)
 {
 }
 
@@ -11,78 +20,29 @@ ModelStore::~ModelStore()
 
 void ModelStore::Clear()
 {
-    for (auto& p : mModels)
-    {
-        auto& modelDesc = p.second;
-        for (auto& meshDesc : modelDesc.meshes)
-        {
-            glDeleteBuffers(1, &meshDesc.eboId);
-            glDeleteBuffers(1, &meshDesc.vboId);
-            glDeleteVertexArrays(1, &meshDesc.vaoId);
-        }
-        modelDesc.meshes.clear();
-    }
     mModels.clear();
+
+    // Nothing is left in the arena
+    mArena.Shutdown();
 }
 
 void ModelStore::Load(const std::string& name, const ModelData& data)
 {
+    PROFILE_SCOPE("UploadModel");
+
+    // Room for a few average models, the arena grows as needed
+    if (!mArena.IsInitialized())
+        mArena.Init(InitialVertexCapacity, InitialIndexCapacity);
+
     ModelDescription modelDesc = {};
 
     for (const auto& mesh : data.meshes)
     {
         MeshDescription meshDesc;
         meshDesc.meshIndex = mesh.meshIndex;
-        auto& vaoId = meshDesc.vaoId;
-        auto& vboId = meshDesc.vboId;
-        auto& eboId = meshDesc.eboId;
-        auto& numIndices = meshDesc.numIndices;
-
-        glGenVertexArrays(1, &vaoId);
-        glGenBuffers(1, &vboId);
-        glGenBuffers(1, &eboId);
-
-        glBindVertexArray(vaoId);
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, vboId);
-            {
-                glBufferData(GL_ARRAY_BUFFER,
-                    mesh.data.size() * sizeof(VertexData),
-                    mesh.data.data(),
-                    GL_STATIC_DRAW
-                );
-
-                // Vertices
-                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (GLvoid*)(offsetof(VertexData, vx)));
-                glEnableVertexAttribArray(0);
-
-                // Normals
-                glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (GLvoid*)(offsetof(VertexData, nx)));
-                glEnableVertexAttribArray(1);
-
-                // TexCoords
-                glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VertexData), (GLvoid*)(offsetof(VertexData, tx)));
-                glEnableVertexAttribArray(2);
-
-                // Tangent
-                glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (GLvoid*)(offsetof(VertexData, tnx)));
-                glEnableVertexAttribArray(3);
-            }
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboId);
-            {
-                glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                    mesh.indices.size() * sizeof(GLuint),
-                    mesh.indices.data(),
-                    GL_STATIC_DRAW
-                );
-            }
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-        }
-        glBindVertexArray(0);
-        numIndices = static_cast<GLsizei>(mesh.indices.size());
-
+        meshDesc.range = mArena.Upload(mesh.data, mesh.indices);
+        meshDesc.vaoId = mArena.GetVao();
+        meshDesc.eboId = mArena.GetEbo();
         modelDesc.meshes.push_back(meshDesc);
     }
 
@@ -99,3 +59,34 @@ ModelDescription* ModelStore::operator[](const std::string& name)
         return &(it->second);
 }
 
+
+void ModelStore::Unload(const std::string& name)
+{
+    auto it = mModels.find(name);
+    if (it == std::end(mModels))
+        return;
+
+    for (const auto& meshDesc : it->second.meshes)
+        mArena.Free(meshDesc.range);
+    mModels.erase(it);
+}
+
+void ModelStore::Defragment()
+{
+    std::vector<GeometryArena::Range*> ranges;
+    for (auto& p : mModels)
+        for (auto& meshDesc : p.second.meshes)
+            ranges.push_back(&meshDesc.range);
+    mArena.Defragment(ranges);
+    ++mGeometryVersion;
+}
+
+std::uint32_t ModelStore::GetGeometryVersion() const
+{
+    return mGeometryVersion;
+}
+
+const GeometryArena& ModelStore::GetArena() const
+{
+    return mArena;
+}
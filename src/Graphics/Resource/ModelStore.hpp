@@ -36,14 +36,14 @@
 #include <unordered_map>
 #include <glad/glad.h>
 #include "../../Asset/Geometry/Geometry.hpp"
+#include "GeometryArena.hpp"
 
 // MeshDescription
 struct MeshDescription
 {
-    GLuint vaoId;
-    GLuint vboId;
+    GLuint vaoId;                // Shared by all the meshes of the store
     GLuint eboId;
-    GLsizei numIndices;
+    GeometryArena::Range range;  // Base vertex and first index of the mesh in the shared buffers
     GLuint meshIndex;
 };
 
@@ -78,11 +78,30 @@ class ModelStore
         // Retrieves pointer a loaded model object
         ModelDescription* operator[](const std::string& name);
 
+        // Unloads a single model, returning its space to the geometry arena
+        void Unload(const std::string& name);
+
         // Unloads the stored models in the store
         void Clear();
 
+        // Packs the geometry of the loaded models together. Their descriptions are updated and the geometry
+        // version is bumped, so that render lists copying their ranges know to refresh them
+        void Defragment();
+
+        // Retrieves the number of times the meshes' ranges have moved
+        std::uint32_t GetGeometryVersion() const;
+
+        // Retrieves the geometry arena holding the meshes
+        const GeometryArena& GetArena() const;
+
     private:
         std::unordered_map<std::string, ModelDescription> mModels;
+
+        // The shared vertex and index buffers
+        GeometryArena mArena;
+
+        // Bumped on every defragmentation
+        std::uint32_t mGeometryVersion;
 };
 
 #endif // ! _MODELSTORE_HPP_
@@ -1,4 +1,6 @@
 #include "TextureStore.hpp"
+#include "../../Core/Profiler.hpp"
+#include "../Renderer/GLStateCache.hpp"
 
 TextureStore::TextureStore()
 {
@@ -12,18 +14,20 @@ TextureStore::~TextureStore()
 void TextureStore::Clear()
 {
     for (const auto& p : mTextures)
-        glDeleteTextures(1, &p.second.texId);
+        GLState().DeleteTextures(1, &p.second.texId);
     mTextures.clear();
 }
 
 void TextureStore::Load(const std::string& name, const RawImage& img)
 {
+    PROFILE_SCOPE("UploadTexture");
+
     // Gen texture
     GLuint id;
     glGenTextures(1, &id);
 
     // Load data
-    glBindTexture(GL_TEXTURE_2D, id);
+    GLState().BindTexture(GL_TEXTURE_2D, id);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
@@ -35,7 +39,7 @@ void TextureStore::Load(const std::string& name, const RawImage& img)
     glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
 
     glGenerateMipmap(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState().BindTexture(GL_TEXTURE_2D, 0);
 
     // Store
     TextureDescription td;
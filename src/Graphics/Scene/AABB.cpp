@@ -1,9 +1,5 @@
 #include "AABB.hpp"
-
-WARN_GUARD_ON
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtx/rotate_vector.hpp>
-WARN_GUARD_OFF
+#include <cmath>
 
 AABB::AABB()
 {
@@ -36,49 +32,9 @@ glm::vec3 AABB::Size() const
     );
 }
 
-void AABB::Update(const glm::vec3& transl, const glm::vec3& scale, const glm::vec3& rotation)
+void AABB::Update(const glm::mat4& transform)
 {
-    glm::vec3 aabbPoints[] = {
-        {localMin.x, localMin.y, localMin.z},
-        {localMin.x, localMin.y, localMax.z},
-        {localMin.x, localMax.y, localMin.z},
-        {localMin.x, localMax.y, localMax.z},
-        {localMax.x, localMin.y, localMin.z},
-        {localMax.x, localMin.y, localMax.z},
-        {localMax.x, localMax.y, localMin.z},
-        {localMax.x, localMax.y, localMax.z},
-    };
-
-    auto newMin = localMin;
-    auto newMax = localMax;
-    for (int i = 0; i < 8; ++i)
-    {
-        aabbPoints[i] = glm::rotateX(aabbPoints[i], rotation.x);
-        aabbPoints[i] = glm::rotateY(aabbPoints[i], rotation.y);
-        aabbPoints[i] = glm::rotateZ(aabbPoints[i], rotation.z);
-
-        if (aabbPoints[i].x < newMin.x)
-            newMin.x = aabbPoints[i].x;
-        if (aabbPoints[i].x > newMax.x)
-            newMax.x = aabbPoints[i].x;
-        if (aabbPoints[i].y < newMin.y)
-            newMin.y = aabbPoints[i].y;
-        if (aabbPoints[i].y > newMax.y)
-            newMax.y = aabbPoints[i].y;
-        if (aabbPoints[i].z < newMin.z)
-            newMin.z = aabbPoints[i].z;
-        if (aabbPoints[i].z > newMax.z)
-            newMax.z = aabbPoints[i].z;
-    }
-
-    cachedMin = newMin;
-    cachedMax = newMax;
-
-    glm::mat4 transform = glm::mat4();
-    transform = glm::translate(transform, transl);
-    transform = glm::scale(transform, scale);
-    cachedMin = glm::vec3(transform * glm::vec4(cachedMin, 1.0f));
-    cachedMax = glm::vec3(transform * glm::vec4(cachedMax, 1.0f));
+    TransformAABBs(&transform, this, this, 1);
 }
 
 bool Intersects(const glm::vec3& p, const AABB& box)
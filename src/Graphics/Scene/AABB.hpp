@@ -31,6 +31,7 @@
 #ifndef _AABB_HPP_
 #define _AABB_HPP_
 
+#include <cstddef>
 #include "../../Util/WarnGuard.hpp"
 WARN_GUARD_ON
 #include <glm/glm.hpp>
@@ -56,13 +57,27 @@ class AABB
         glm::vec3 Center() const;
         glm::vec3 Size() const;
 
-        void Update(const glm::vec3& transl, const glm::vec3& scale, const glm::vec3& rotation);
+        // Recomputes the world box enclosing the local box transformed by the given world matrix
+        void Update(const glm::mat4& transform);
 
     private:
         glm::vec3 localMin, cachedMin;
         glm::vec3 localMax, cachedMax;
+
+        friend struct AABBKernels;
 };
 
+// Batched AABB::Update: out[i] receives the local box of local[i] and its world box under world[i].
+// The arrays may alias. Runs on the widest SIMD instruction set the CPU supports
+void TransformAABBs(const glm::mat4* world, const AABB* local, AABB* out, std::size_t n);
+
+// Name of the instruction set TransformAABBs runs on
+const char* TransformAABBsPath();
+
+// TransformAABBs on the named instruction set, "Scalar", "SSE2" or "AVX2", to compare them against each other.
+// Returns false, leaving out untouched, if the CPU lacks it
+bool TransformAABBs(const char* path, const glm::mat4* world, const AABB* local, AABB* out, std::size_t n);
+
 bool Intersects(const glm::vec3&, const AABB& aabb);
 bool Intersects(const AABB& aabb1, const AABB& aabb2);
 glm::vec3 CalcCollisionResponce(const AABB& aabb1, const AABB& aabb2);
@@ -0,0 +1,356 @@
+#include "AABB.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+
+// Arvo's method in center / extent form: the world center is the transformed local center,
+// and the world extent is the local extent transformed by the absolute values of the 3x3 part.
+// All paths evaluate the same expressions in the same order, so they produce identical boxes.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AABB_TRANSFORM_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_SSE2
+#define TARGET_AVX2
+#else
+// 32-bit builds may leave SSE2 disabled, the kernel is only selected when the CPU has it
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// Befriended by AABB to reach its boxes
+struct AABBKernels
+{
+    static void Scalar(const glm::mat4* world, const AABB* local, AABB* out, std::size_t n);
+#ifdef AABB_TRANSFORM_X86
+    TARGET_SSE2 static void SSE2(const glm::mat4* world, const AABB* local, AABB* out, std::size_t n);
+    TARGET_AVX2 static void AVX2(const glm::mat4* world, const AABB* local, AABB* out, std::size_t n);
+#endif
+};
+
+void AABBKernels::Scalar(const glm::mat4* world, const AABB* local, AABB* out, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const glm::mat4& m = world[i];
+        const glm::vec3 lMin = local[i].localMin;
+        const glm::vec3 lMax = local[i].localMax;
+        const glm::vec3 c = (lMax + lMin) * 0.5f;
+        const glm::vec3 e = (lMax - lMin) * 0.5f;
+
+        glm::vec3 wc = glm::vec3(m[0]) * c.x + glm::vec3(m[1]) * c.y + glm::vec3(m[2]) * c.z + glm::vec3(m[3]);
+        glm::vec3 we = glm::abs(glm::vec3(m[0])) * e.x + glm::abs(glm::vec3(m[1])) * e.y + glm::abs(glm::vec3(m[2])) * e.z;
+
+        out[i].localMin  = lMin;
+        out[i].localMax  = lMax;
+        out[i].cachedMin = wc - we;
+        out[i].cachedMax = wc + we;
+    }
+}
+
+#ifdef AABB_TRANSFORM_X86
+// Four boxes per iteration, one in each lane: the boxes and the matrices are transposed so that
+// every register holds the same component of the four, and each axis of the result is computed apart
+TARGET_SSE2
+void AABBKernels::SSE2(const glm::mat4* world, const AABB* local, AABB* out, std::size_t n)
+{
+    // The local corners are loaded four floats at a time, the fourth being the next member
+    static_assert(offsetof(AABB, cachedMin) == offsetof(AABB, localMin) + sizeof(glm::vec3)
+               && offsetof(AABB, cachedMax) == offsetof(AABB, localMax) + sizeof(glm::vec3),
+                  "AABB corners must be followed by another member");
+
+    const __m128 half    = _mm_set1_ps(0.5f);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+    alignas(16) float wMin[4][4];
+    alignas(16) float wMax[4][4];
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        // Local corners, x, y and z of the four boxes
+        __m128 minX = _mm_loadu_ps(&local[i + 0].localMin.x);
+        __m128 minY = _mm_loadu_ps(&local[i + 1].localMin.x);
+        __m128 minZ = _mm_loadu_ps(&local[i + 2].localMin.x);
+        __m128 minW = _mm_loadu_ps(&local[i + 3].localMin.x);
+        _MM_TRANSPOSE4_PS(minX, minY, minZ, minW);
+        __m128 maxX = _mm_loadu_ps(&local[i + 0].localMax.x);
+        __m128 maxY = _mm_loadu_ps(&local[i + 1].localMax.x);
+        __m128 maxZ = _mm_loadu_ps(&local[i + 2].localMax.x);
+        __m128 maxW = _mm_loadu_ps(&local[i + 3].localMax.x);
+        _MM_TRANSPOSE4_PS(maxX, maxY, maxZ, maxW);
+
+        const __m128 cX = _mm_mul_ps(_mm_add_ps(maxX, minX), half);
+        const __m128 cY = _mm_mul_ps(_mm_add_ps(maxY, minY), half);
+        const __m128 cZ = _mm_mul_ps(_mm_add_ps(maxZ, minZ), half);
+        const __m128 eX = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+        const __m128 eY = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+        const __m128 eZ = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+        // Matrix columns of the four boxes, m[col][row] holds that element of each matrix
+        __m128 m[4][4];
+        for (int col = 0; col < 4; ++col)
+        {
+            m[col][0] = _mm_loadu_ps(&world[i + 0][col][0]);
+            m[col][1] = _mm_loadu_ps(&world[i + 1][col][0]);
+            m[col][2] = _mm_loadu_ps(&world[i + 2][col][0]);
+            m[col][3] = _mm_loadu_ps(&world[i + 3][col][0]);
+            _MM_TRANSPOSE4_PS(m[col][0], m[col][1], m[col][2], m[col][3]);
+        }
+
+        // World corners per axis
+        __m128 outMin[4], outMax[4];
+        for (int row = 0; row < 3; ++row)
+        {
+            __m128 wc = _mm_mul_ps(m[0][row], cX);
+            wc = _mm_add_ps(wc, _mm_mul_ps(m[1][row], cY));
+            wc = _mm_add_ps(wc, _mm_mul_ps(m[2][row], cZ));
+            wc = _mm_add_ps(wc, m[3][row]);
+
+            __m128 we = _mm_mul_ps(_mm_and_ps(m[0][row], absMask), eX);
+            we = _mm_add_ps(we, _mm_mul_ps(_mm_and_ps(m[1][row], absMask), eY));
+            we = _mm_add_ps(we, _mm_mul_ps(_mm_and_ps(m[2][row], absMask), eZ));
+
+            outMin[row] = _mm_sub_ps(wc, we);
+            outMax[row] = _mm_add_ps(wc, we);
+        }
+
+        // Back to one box per register
+        outMin[3] = outMax[3] = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(outMin[0], outMin[1], outMin[2], outMin[3]);
+        _MM_TRANSPOSE4_PS(outMax[0], outMax[1], outMax[2], outMax[3]);
+        for (int k = 0; k < 4; ++k)
+        {
+            _mm_store_ps(wMin[k], outMin[k]);
+            _mm_store_ps(wMax[k], outMax[k]);
+        }
+
+        for (int k = 0; k < 4; ++k)
+        {
+            const AABB& box = local[i + k];
+            out[i + k].localMin  = box.localMin;
+            out[i + k].localMax  = box.localMax;
+            out[i + k].cachedMin = glm::vec3(wMin[k][0], wMin[k][1], wMin[k][2]);
+            out[i + k].cachedMax = glm::vec3(wMax[k][0], wMax[k][1], wMax[k][2]);
+        }
+    }
+
+    // The last few boxes
+    if (i < n)
+        Scalar(world + i, local + i, out + i, n - i);
+}
+
+namespace
+{
+// Two rows of four floats, the first in the low 128-bit lane and the second in the high one
+TARGET_AVX2 inline __m256 LoadLanes(const float* lo, const float* hi)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(lo)), _mm_loadu_ps(hi), 1);
+}
+
+// _MM_TRANSPOSE4_PS applied to both 128-bit lanes at once
+TARGET_AVX2 inline void TransposeLanes(__m256& r0, __m256& r1, __m256& r2, __m256& r3)
+{
+    const __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    const __m256 t1 = _mm256_unpacklo_ps(r2, r3);
+    const __m256 t2 = _mm256_unpackhi_ps(r0, r1);
+    const __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+    r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+    r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+} // namespace
+
+// Eight boxes per iteration, laid out as the SSE2 kernel does: boxes 0-3 go through the low 128-bit lane
+// and boxes 4-7 through the high one, so the per lane transposes leave one box in each of the eight floats
+TARGET_AVX2
+void AABBKernels::AVX2(const glm::mat4* world, const AABB* local, AABB* out, std::size_t n)
+{
+    const __m256 half    = _mm256_set1_ps(0.5f);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+
+    alignas(32) float wMin[4][8];
+    alignas(32) float wMax[4][8];
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        // Local corners, x, y and z of the eight boxes
+        __m256 minX = LoadLanes(&local[i + 0].localMin.x, &local[i + 4].localMin.x);
+        __m256 minY = LoadLanes(&local[i + 1].localMin.x, &local[i + 5].localMin.x);
+        __m256 minZ = LoadLanes(&local[i + 2].localMin.x, &local[i + 6].localMin.x);
+        __m256 minW = LoadLanes(&local[i + 3].localMin.x, &local[i + 7].localMin.x);
+        TransposeLanes(minX, minY, minZ, minW);
+        __m256 maxX = LoadLanes(&local[i + 0].localMax.x, &local[i + 4].localMax.x);
+        __m256 maxY = LoadLanes(&local[i + 1].localMax.x, &local[i + 5].localMax.x);
+        __m256 maxZ = LoadLanes(&local[i + 2].localMax.x, &local[i + 6].localMax.x);
+        __m256 maxW = LoadLanes(&local[i + 3].localMax.x, &local[i + 7].localMax.x);
+        TransposeLanes(maxX, maxY, maxZ, maxW);
+
+        const __m256 cX = _mm256_mul_ps(_mm256_add_ps(maxX, minX), half);
+        const __m256 cY = _mm256_mul_ps(_mm256_add_ps(maxY, minY), half);
+        const __m256 cZ = _mm256_mul_ps(_mm256_add_ps(maxZ, minZ), half);
+        const __m256 eX = _mm256_mul_ps(_mm256_sub_ps(maxX, minX), half);
+        const __m256 eY = _mm256_mul_ps(_mm256_sub_ps(maxY, minY), half);
+        const __m256 eZ = _mm256_mul_ps(_mm256_sub_ps(maxZ, minZ), half);
+
+        // Matrix columns of the eight boxes, m[col][row] holds that element of each matrix
+        __m256 m[4][4];
+        for (int col = 0; col < 4; ++col)
+        {
+            m[col][0] = LoadLanes(&world[i + 0][col][0], &world[i + 4][col][0]);
+            m[col][1] = LoadLanes(&world[i + 1][col][0], &world[i + 5][col][0]);
+            m[col][2] = LoadLanes(&world[i + 2][col][0], &world[i + 6][col][0]);
+            m[col][3] = LoadLanes(&world[i + 3][col][0], &world[i + 7][col][0]);
+            TransposeLanes(m[col][0], m[col][1], m[col][2], m[col][3]);
+        }
+
+        // World corners per axis
+        __m256 outMin[4], outMax[4];
+        for (int row = 0; row < 3; ++row)
+        {
+            __m256 wc = _mm256_mul_ps(m[0][row], cX);
+            wc = _mm256_add_ps(wc, _mm256_mul_ps(m[1][row], cY));
+            wc = _mm256_add_ps(wc, _mm256_mul_ps(m[2][row], cZ));
+            wc = _mm256_add_ps(wc, m[3][row]);
+
+            __m256 we = _mm256_mul_ps(_mm256_and_ps(m[0][row], absMask), eX);
+            we = _mm256_add_ps(we, _mm256_mul_ps(_mm256_and_ps(m[1][row], absMask), eY));
+            we = _mm256_add_ps(we, _mm256_mul_ps(_mm256_and_ps(m[2][row], absMask), eZ));
+
+            outMin[row] = _mm256_sub_ps(wc, we);
+            outMax[row] = _mm256_add_ps(wc, we);
+        }
+
+        // Back to one box per 128-bit lane, register k holding boxes k and k + 4
+        outMin[3] = outMax[3] = _mm256_setzero_ps();
+        TransposeLanes(outMin[0], outMin[1], outMin[2], outMin[3]);
+        TransposeLanes(outMax[0], outMax[1], outMax[2], outMax[3]);
+        for (int k = 0; k < 4; ++k)
+        {
+            _mm256_store_ps(wMin[k], outMin[k]);
+            _mm256_store_ps(wMax[k], outMax[k]);
+        }
+
+        for (int k = 0; k < 8; ++k)
+        {
+            const float* bMin = &wMin[k % 4][(k / 4) * 4];
+            const float* bMax = &wMax[k % 4][(k / 4) * 4];
+            const AABB& box = local[i + k];
+            out[i + k].localMin  = box.localMin;
+            out[i + k].localMax  = box.localMax;
+            out[i + k].cachedMin = glm::vec3(bMin[0], bMin[1], bMin[2]);
+            out[i + k].cachedMax = glm::vec3(bMax[0], bMax[1], bMax[2]);
+        }
+    }
+
+    // The last few boxes
+    if (i < n)
+        SSE2(world + i, local + i, out + i, n - i);
+}
+#endif
+
+namespace
+{
+
+#ifdef AABB_TRANSFORM_X86
+bool CpuSupportsSSE2()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return true;
+#elif defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 1);
+    return (regs[3] & (1 << 26)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2") != 0;
+#endif
+}
+
+bool CpuSupportsAVX2()
+{
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7)
+        return false;
+
+    // The OS must save the YMM registers too
+    __cpuid(regs, 1);
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const bool avx     = (regs[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+
+using TransformAABBsFn = void (*)(const glm::mat4*, const AABB*, AABB*, std::size_t);
+
+struct TransformAABBsImpl
+{
+    TransformAABBsFn fn;
+    const char* name;
+};
+
+// The kernel of the named instruction set, or a null one if the CPU lacks it
+TransformAABBsImpl FindTransformAABBs(const char* path)
+{
+#ifdef AABB_TRANSFORM_X86
+    if (std::strcmp(path, "AVX2") == 0 && CpuSupportsAVX2())
+        return {AABBKernels::AVX2, "AVX2"};
+    if (std::strcmp(path, "SSE2") == 0 && CpuSupportsSSE2())
+        return {AABBKernels::SSE2, "SSE2"};
+#endif
+    if (std::strcmp(path, "Scalar") == 0)
+        return {AABBKernels::Scalar, "Scalar"};
+    return {nullptr, nullptr};
+}
+
+TransformAABBsImpl SelectTransformAABBs()
+{
+    for (const char* path : { "AVX2", "SSE2" })
+    {
+        TransformAABBsImpl impl = FindTransformAABBs(path);
+        if (impl.fn != nullptr)
+            return impl;
+    }
+    return FindTransformAABBs("Scalar");
+}
+
+const TransformAABBsImpl& GetTransformAABBs()
+{
+    static const TransformAABBsImpl impl = SelectTransformAABBs();
+    return impl;
+}
+
+} // namespace
+
+void TransformAABBs(const glm::mat4* world, const AABB* local, AABB* out, std::size_t n)
+{
+    GetTransformAABBs().fn(world, local, out, n);
+}
+
+const char* TransformAABBsPath()
+{
+    return GetTransformAABBs().name;
+}
+
+bool TransformAABBs(const char* path, const glm::mat4* world, const AABB* local, AABB* out, std::size_t n)
+{
+    TransformAABBsImpl impl = FindTransformAABBs(path);
+    if (impl.fn == nullptr)
+        return false;
+    impl.fn(world, local, out, n);
+    return true;
+}
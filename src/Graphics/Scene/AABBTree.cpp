@@ -0,0 +1,307 @@
+#include "AABBTree.hpp"
+#include <algorithm>
+#include <cassert>
+
+const float AABBTree::Margin = 0.2f;
+
+AABBTree::AABBTree()
+    : mRoot(Null),
+      mFreeList(Null)
+{
+}
+
+//--------------------------------------------------
+// Proxies
+//--------------------------------------------------
+int AABBTree::CreateProxy(const glm::vec3& minPoint, const glm::vec3& maxPoint, SceneNode* node)
+{
+    int proxy = AllocateNode();
+    Node& leaf = mNodes[proxy];
+    leaf.minPoint = minPoint - glm::vec3(Margin);
+    leaf.maxPoint = maxPoint + glm::vec3(Margin);
+    leaf.node = node;
+    leaf.height = 0;
+
+    InsertLeaf(proxy);
+    return proxy;
+}
+
+void AABBTree::DestroyProxy(int proxy)
+{
+    assert(mNodes[proxy].IsLeaf());
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+}
+
+bool AABBTree::MoveProxy(int proxy, const glm::vec3& minPoint, const glm::vec3& maxPoint)
+{
+    Node& leaf = mNodes[proxy];
+
+    // Nothing to do while the tight bounds stay inside the fat ones
+    if (glm::all(glm::greaterThanEqual(minPoint, leaf.minPoint)) &&
+        glm::all(glm::lessThanEqual(maxPoint, leaf.maxPoint)))
+        return false;
+
+    // Reinsert the leaf with fresh fat bounds
+    RemoveLeaf(proxy);
+    leaf.minPoint = minPoint - glm::vec3(Margin);
+    leaf.maxPoint = maxPoint + glm::vec3(Margin);
+    InsertLeaf(proxy);
+    return true;
+}
+
+SceneNode* AABBTree::GetNode(int proxy) const
+{
+    return mNodes[proxy].node;
+}
+
+int AABBTree::GetHeight() const
+{
+    return mRoot == Null ? 0 : mNodes[mRoot].height;
+}
+
+//--------------------------------------------------
+// Node pool
+//--------------------------------------------------
+int AABBTree::AllocateNode()
+{
+    int index;
+    if (mFreeList != Null)
+    {
+        index = mFreeList;
+        mFreeList = mNodes[index].parent;
+    }
+    else
+    {
+        index = static_cast<int>(mNodes.size());
+        mNodes.emplace_back();
+    }
+
+    Node& node = mNodes[index];
+    node.node = nullptr;
+    node.parent = Null;
+    node.child1 = Null;
+    node.child2 = Null;
+    node.height = 0;
+    return index;
+}
+
+void AABBTree::FreeNode(int index)
+{
+    mNodes[index].parent = mFreeList;
+    mNodes[index].height = -1;
+    mFreeList = index;
+}
+
+//--------------------------------------------------
+// Tree structure
+//--------------------------------------------------
+void AABBTree::InsertLeaf(int leaf)
+{
+    if (mRoot == Null)
+    {
+        mRoot = leaf;
+        mNodes[leaf].parent = Null;
+        return;
+    }
+
+    // Find the best sibling by descending along the cheapest surface area increase
+    const glm::vec3 leafMin = mNodes[leaf].minPoint;
+    const glm::vec3 leafMax = mNodes[leaf].maxPoint;
+    int index = mRoot;
+    while (!mNodes[index].IsLeaf())
+    {
+        const Node& node = mNodes[index];
+        const float area = SurfaceArea(node.minPoint, node.maxPoint);
+        const float combinedArea = SurfaceArea(glm::min(node.minPoint, leafMin), glm::max(node.maxPoint, leafMax));
+
+        // Cost of creating a new parent for this node and the new leaf
+        const float cost = 2.0f * combinedArea;
+        // Minimum cost of pushing the leaf further down the tree
+        const float inheritanceCost = 2.0f * (combinedArea - area);
+
+        // Cost of descending into each child
+        float childCosts[2];
+        const int children[2] = { node.child1, node.child2 };
+        for (int i = 0; i < 2; ++i)
+        {
+            const Node& child = mNodes[children[i]];
+            const float newArea = SurfaceArea(glm::min(child.minPoint, leafMin), glm::max(child.maxPoint, leafMax));
+            if (child.IsLeaf())
+                childCosts[i] = newArea + inheritanceCost;
+            else
+                childCosts[i] = (newArea - SurfaceArea(child.minPoint, child.maxPoint)) + inheritanceCost;
+        }
+
+        if (cost < childCosts[0] && cost < childCosts[1])
+            break;
+
+        index = childCosts[0] < childCosts[1] ? node.child1 : node.child2;
+    }
+    const int sibling = index;
+
+    // Create a new parent for the sibling and the leaf
+    const int oldParent = mNodes[sibling].parent;
+    const int newParent = AllocateNode();
+    mNodes[newParent].parent = oldParent;
+    mNodes[newParent].minPoint = glm::min(leafMin, mNodes[sibling].minPoint);
+    mNodes[newParent].maxPoint = glm::max(leafMax, mNodes[sibling].maxPoint);
+    mNodes[newParent].height = mNodes[sibling].height + 1;
+    mNodes[newParent].child1 = sibling;
+    mNodes[newParent].child2 = leaf;
+    mNodes[sibling].parent = newParent;
+    mNodes[leaf].parent = newParent;
+
+    if (oldParent != Null)
+    {
+        if (mNodes[oldParent].child1 == sibling)
+            mNodes[oldParent].child1 = newParent;
+        else
+            mNodes[oldParent].child2 = newParent;
+    }
+    else
+        mRoot = newParent;
+
+    // Walk back up fixing heights and bounds
+    Refit(mNodes[leaf].parent);
+}
+
+void AABBTree::RemoveLeaf(int leaf)
+{
+    if (leaf == mRoot)
+    {
+        mRoot = Null;
+        return;
+    }
+
+    const int parent = mNodes[leaf].parent;
+    const int grandParent = mNodes[parent].parent;
+    const int sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+    if (grandParent != Null)
+    {
+        // Replace the parent with the sibling
+        if (mNodes[grandParent].child1 == parent)
+            mNodes[grandParent].child1 = sibling;
+        else
+            mNodes[grandParent].child2 = sibling;
+        mNodes[sibling].parent = grandParent;
+        FreeNode(parent);
+
+        Refit(grandParent);
+    }
+    else
+    {
+        mRoot = sibling;
+        mNodes[sibling].parent = Null;
+        FreeNode(parent);
+    }
+}
+
+void AABBTree::Refit(int index)
+{
+    while (index != Null)
+    {
+        index = Balance(index);
+
+        Node& node = mNodes[index];
+        const Node& child1 = mNodes[node.child1];
+        const Node& child2 = mNodes[node.child2];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.minPoint = glm::min(child1.minPoint, child2.minPoint);
+        node.maxPoint = glm::max(child1.maxPoint, child2.maxPoint);
+
+        index = node.parent;
+    }
+}
+
+int AABBTree::Balance(int iA)
+{
+    const Node& A = mNodes[iA];
+    if (A.IsLeaf() || A.height < 2)
+        return iA;
+
+    // Rotate the taller child up when the heights of the children differ by more than one
+    const int balance = mNodes[A.child2].height - mNodes[A.child1].height;
+    if (balance > 1)
+        return Rotate(iA, A.child2, A.child1);
+    if (balance < -1)
+        return Rotate(iA, A.child1, A.child2);
+    return iA;
+}
+
+int AABBTree::Rotate(int iA, int iUp, int iOther)
+{
+    Node& A = mNodes[iA];
+    Node& U = mNodes[iUp];
+    const Node& O = mNodes[iOther];
+
+    // Keep the taller grand child under U and move the other one under A
+    int iKeep = U.child1;
+    int iMove = U.child2;
+    if (mNodes[iKeep].height <= mNodes[iMove].height)
+        std::swap(iKeep, iMove);
+    const Node& K = mNodes[iKeep];
+    Node& M = mNodes[iMove];
+
+    // Swap A and U
+    U.child1 = iA;
+    U.child2 = iKeep;
+    U.parent = A.parent;
+    A.parent = iUp;
+
+    // A's old parent should point to U
+    if (U.parent != Null)
+    {
+        if (mNodes[U.parent].child1 == iA)
+            mNodes[U.parent].child1 = iUp;
+        else
+            mNodes[U.parent].child2 = iUp;
+    }
+    else
+        mRoot = iUp;
+
+    // The moved grand child takes U's place under A
+    if (A.child1 == iUp)
+        A.child1 = iMove;
+    else
+        A.child2 = iMove;
+    M.parent = iA;
+
+    // Refit both
+    A.minPoint = glm::min(O.minPoint, M.minPoint);
+    A.maxPoint = glm::max(O.maxPoint, M.maxPoint);
+    A.height = 1 + std::max(O.height, M.height);
+    U.minPoint = glm::min(A.minPoint, K.minPoint);
+    U.maxPoint = glm::max(A.maxPoint, K.maxPoint);
+    U.height = 1 + std::max(A.height, K.height);
+    return iUp;
+}
+
+//--------------------------------------------------
+// Box helpers
+//--------------------------------------------------
+float AABBTree::SurfaceArea(const glm::vec3& minPoint, const glm::vec3& maxPoint)
+{
+    const glm::vec3 d = maxPoint - minPoint;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+bool AABBTree::Overlaps(const Node& node, const glm::vec3& minPoint, const glm::vec3& maxPoint)
+{
+    return glm::all(glm::lessThanEqual(node.minPoint, maxPoint)) &&
+           glm::all(glm::greaterThanEqual(node.maxPoint, minPoint));
+}
+
+bool AABBTree::RayHit(const Node& node, const glm::vec3& origin, const glm::vec3& invDir, float maxDist, float& entry)
+{
+    // Slab test
+    const glm::vec3 t1 = (node.minPoint - origin) * invDir;
+    const glm::vec3 t2 = (node.maxPoint - origin) * invDir;
+    const glm::vec3 tMin = glm::min(t1, t2);
+    const glm::vec3 tMax = glm::max(t1, t2);
+    const float tEnter = std::max(std::max(tMin.x, tMin.y), std::max(tMin.z, 0.0f));
+    const float tExit = std::min(std::min(tMax.x, tMax.y), std::min(tMax.z, maxDist));
+    entry = tEnter;
+    return tEnter <= tExit;
+}
@@ -0,0 +1,203 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _AABB_TREE_HPP_
+#define _AABB_TREE_HPP_
+
+#include <array>
+#include <vector>
+#include "Frustum.hpp"
+
+#include "../../Util/WarnGuard.hpp"
+WARN_GUARD_ON
+#include <glm/glm.hpp>
+WARN_GUARD_OFF
+
+class SceneNode;
+
+/// Dynamic bounding volume hierarchy over the scene nodes.
+/// Leaves hold fat AABBs, so that small movements do not change the tree,
+/// and the tree is kept balanced with AVL style rotations.
+class AABBTree
+{
+    public:
+        /// Id of an invalid proxy
+        static const int Null = -1;
+
+        /// Distance the leaf AABBs are enlarged by on every side
+        static const float Margin;
+
+        /// Constructor
+        AABBTree();
+
+        /// Creates a leaf for the given node with the given bounds, returning its proxy id
+        int CreateProxy(const glm::vec3& minPoint, const glm::vec3& maxPoint, SceneNode* node);
+
+        /// Removes the leaf with the given proxy id
+        void DestroyProxy(int proxy);
+
+        /// Updates the bounds of the given proxy.
+        /// The tree only changes when the new bounds escape the fat AABB of the leaf, in which case true is returned.
+        bool MoveProxy(int proxy, const glm::vec3& minPoint, const glm::vec3& maxPoint);
+
+        /// Retrieves the node of the given proxy
+        SceneNode* GetNode(int proxy) const;
+
+        /// Retrieves the height of the tree, 0 for a single leaf
+        int GetHeight() const;
+
+        /// Calls fn(SceneNode*) for every leaf whose fat AABB overlaps the given box
+        template <typename Fn>
+        void QueryOverlaps(const glm::vec3& minPoint, const glm::vec3& maxPoint, Fn&& fn) const;
+
+        /// Calls fn(SceneNode*) for every leaf whose fat AABB intersects the given frustum
+        template <typename Fn>
+        void QueryFrustum(const Frustum& frustum, Fn&& fn) const;
+
+        /// Calls fn(SceneNode*, float entryDist) for every leaf whose fat AABB the given ray enters before maxDist.
+        /// fn returns the new maximum distance, so it can clip the ray to the closest hit found so far.
+        template <typename Fn>
+        void RayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDist, Fn&& fn) const;
+
+    private:
+        struct Node
+        {
+            glm::vec3 minPoint, maxPoint;
+            SceneNode* node;
+            int parent;   /// Parent index, or next free node while in the free list
+            int child1;
+            int child2;
+            int height;   /// 0 for leaves, -1 for free nodes
+
+            bool IsLeaf() const { return child1 == Null; }
+        };
+
+        /// Maximum depth of the traversal stack
+        static const std::size_t StackSize = 256;
+
+        /// Node pool management
+        int AllocateNode();
+        void FreeNode(int index);
+
+        /// Tree structure management
+        void InsertLeaf(int leaf);
+        void RemoveLeaf(int leaf);
+        int Balance(int index);
+        int Rotate(int index, int up, int other);
+        void Refit(int index);
+
+        /// Box helpers
+        static float SurfaceArea(const glm::vec3& minPoint, const glm::vec3& maxPoint);
+        static bool Overlaps(const Node& node, const glm::vec3& minPoint, const glm::vec3& maxPoint);
+        static bool RayHit(const Node& node, const glm::vec3& origin, const glm::vec3& invDir, float maxDist, float& entry);
+
+        std::vector<Node> mNodes; /// Node pool
+        int mRoot;                /// Root node index
+        int mFreeList;            /// First free node index
+};
+
+template <typename Fn>
+void AABBTree::QueryOverlaps(const glm::vec3& minPoint, const glm::vec3& maxPoint, Fn&& fn) const
+{
+    if (mRoot == Null)
+        return;
+
+    std::array<int, StackSize> stack;
+    std::size_t top = 0;
+    stack[top++] = mRoot;
+    while (top > 0)
+    {
+        const Node& node = mNodes[stack[--top]];
+        if (!Overlaps(node, minPoint, maxPoint))
+            continue;
+
+        if (node.IsLeaf())
+            fn(node.node);
+        else
+        {
+            stack[top++] = node.child1;
+            stack[top++] = node.child2;
+        }
+    }
+}
+
+template <typename Fn>
+void AABBTree::QueryFrustum(const Frustum& frustum, Fn&& fn) const
+{
+    if (mRoot == Null)
+        return;
+
+    std::array<int, StackSize> stack;
+    std::size_t top = 0;
+    stack[top++] = mRoot;
+    while (top > 0)
+    {
+        const Node& node = mNodes[stack[--top]];
+        if (!Intersects(frustum, node.minPoint, node.maxPoint))
+            continue;
+
+        if (node.IsLeaf())
+            fn(node.node);
+        else
+        {
+            stack[top++] = node.child1;
+            stack[top++] = node.child2;
+        }
+    }
+}
+
+template <typename Fn>
+void AABBTree::RayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDist, Fn&& fn) const
+{
+    if (mRoot == Null)
+        return;
+
+    const glm::vec3 invDir = 1.0f / dir;
+    std::array<int, StackSize> stack;
+    std::size_t top = 0;
+    stack[top++] = mRoot;
+    while (top > 0)
+    {
+        const Node& node = mNodes[stack[--top]];
+        float entry;
+        if (!RayHit(node, origin, invDir, maxDist, entry))
+            continue;
+
+        if (node.IsLeaf())
+            maxDist = fn(node.node, entry);
+        else
+        {
+            stack[top++] = node.child1;
+            stack[top++] = node.child2;
+        }
+    }
+}
+
+#endif // ! _AABB_TREE_HPP_
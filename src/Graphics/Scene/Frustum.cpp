@@ -0,0 +1,55 @@
+#include "Frustum.hpp"
+
+Frustum::Frustum()
+{
+}
+
+Frustum::Frustum(const glm::mat4& viewProj)
+{
+    // Gribb-Hartmann plane extraction, glm matrices are column major
+    glm::vec4 row0(viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0]);
+    glm::vec4 row1(viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1]);
+    glm::vec4 row2(viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2]);
+    glm::vec4 row3(viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]);
+
+    mPlanes[Left]   = row3 + row0;
+    mPlanes[Right]  = row3 - row0;
+    mPlanes[Bottom] = row3 + row1;
+    mPlanes[Top]    = row3 - row1;
+    mPlanes[Near]   = row3 + row2;
+    mPlanes[Far]    = row3 - row2;
+
+    // Normalize planes
+    for (auto& plane : mPlanes)
+        plane /= glm::length(glm::vec3(plane));
+}
+
+const glm::vec4& Frustum::Plane(Side side) const
+{
+    return mPlanes[side];
+}
+
+bool Intersects(const Frustum& frustum, const AABB& aabb)
+{
+    return Intersects(frustum, aabb.MinPoint(), aabb.MaxPoint());
+}
+
+bool Intersects(const Frustum& frustum, const glm::vec3& minPoint, const glm::vec3& maxPoint)
+{
+    for (int i = Frustum::Left; i <= Frustum::Far; ++i)
+    {
+        const glm::vec4& plane = frustum.Plane(static_cast<Frustum::Side>(i));
+
+        // Pick the box corner that lies furthest along the plane normal
+        glm::vec3 pVertex(
+            plane.x >= 0.0f ? maxPoint.x : minPoint.x,
+            plane.y >= 0.0f ? maxPoint.y : minPoint.y,
+            plane.z >= 0.0f ? maxPoint.z : minPoint.z
+        );
+
+        // If even that corner is behind the plane the box is outside
+        if (glm::dot(glm::vec3(plane), pVertex) + plane.w < 0.0f)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,54 @@
+#include "RenderSnapshot.hpp"
+#include "../../Core/Profiler.hpp"
+
+void CaptureSnapshot(RenderSnapshot& snapshot, const RenderformCreator& creator, const Scene& scene)
+{
+    PROFILE_SCOPE("CaptureSnapshot");
+
+    // Render lists, assigned in place so the buffers keep their capacity from the previous captures
+    snapshot.materials = creator.GetMaterials();
+    for (auto& material : snapshot.materials)
+        for (auto& mesh : material.second)
+            mesh.aabb = nullptr;
+
+    // The shadow pass culls the casters by their AABB, so point them to copies the simulation does not touch
+    const auto& casters = creator.GetShadowCasters();
+    snapshot.shadowCasters = casters;
+    snapshot.casterBounds.resize(casters.size());
+    for (std::size_t i = 0; i < casters.size(); ++i)
+    {
+        snapshot.casterBounds[i] = *casters[i].aabb;
+        snapshot.shadowCasters[i].aabb = &snapshot.casterBounds[i];
+    }
+
+    // World matrices of the tick and the one before
+    const TransformHierarchy& transforms = scene.GetTransforms();
+    snapshot.world = transforms.GetWorld();
+    snapshot.prevWorld = transforms.GetPreviousWorld();
+
+    // Statistics
+    snapshot.cullStats = creator.GetCullStats();
+    snapshot.updatedNodes = scene.GetChangedNodes().size();
+    snapshot.totalNodes = scene.GetNodes().Size();
+}
+
+void CaptureNodeBounds(RenderSnapshot& snapshot, const Scene& scene)
+{
+    snapshot.nodeBounds.clear();
+    for (const SceneNode& node : scene.GetNodes())
+    {
+        const AABB& aabb = node.GetAABB();
+        snapshot.nodeBounds.push_back(aabb.MinPoint());
+        snapshot.nodeBounds.push_back(aabb.MaxPoint());
+    }
+}
+
+Renderer::IntForm bakeIntForm(const RenderSnapshot& snapshot)
+{
+    Renderer::IntForm rVal;
+    rVal.materials           = &snapshot.materials;
+    rVal.shadowCasters       = &snapshot.shadowCasters;
+    rVal.transforms.current  = snapshot.world.data();
+    rVal.transforms.previous = snapshot.prevWorld.data();
+    return rVal;
+}
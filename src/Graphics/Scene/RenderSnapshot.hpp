@@ -0,0 +1,76 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _RENDER_SNAPSHOT_HPP_
+#define _RENDER_SNAPSHOT_HPP_
+
+#include <vector>
+#include "RenderformCreator.hpp"
+#include "../Renderer/Light.hpp"
+#include "../Util/Camera.hpp"
+
+// Everything a frame needs from the simulation, captured at the end of a tick.
+// The render path reads only from it, so the simulation is free to change the scene meanwhile
+struct RenderSnapshot
+{
+    // Render lists with the culling of the tick applied.
+    // The meshes' AABB pointers are cleared, the casters' ones point to casterBounds
+    RenderformCreator::MaterialList     materials;
+    RenderformCreator::ShadowCasterList shadowCasters;
+    std::vector<AABB>                   casterBounds;
+
+    // World matrices of the tick and the one before, indexed by the render lists
+    std::vector<glm::mat4> world;
+    std::vector<glm::mat4> prevWorld;
+
+    // The view and the lights
+    Camera camera;
+    Lights lights;
+
+    // Bounds of every node's AABB as min / max pairs, only captured when asked for
+    std::vector<glm::vec3> nodeBounds;
+
+    // Statistics of the tick
+    RenderformCreator::CullStats cullStats = {0, 0};
+    std::size_t updatedNodes = 0;
+    std::size_t totalNodes = 0;
+};
+
+// Copies the render lists, the world matrices and the statistics of the tick into the snapshot,
+// reusing its storage. Camera, lights and node bounds are left to the caller
+void CaptureSnapshot(RenderSnapshot& snapshot, const RenderformCreator& creator, const Scene& scene);
+
+// Copies the bounds of every node's AABB into the snapshot
+void CaptureNodeBounds(RenderSnapshot& snapshot, const Scene& scene);
+
+// Creates a Renderer::IntForm view over the snapshot's render lists
+Renderer::IntForm bakeIntForm(const RenderSnapshot& snapshot);
+
+#endif // ! _RENDER_SNAPSHOT_HPP_
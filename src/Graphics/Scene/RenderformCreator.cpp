@@ -1,73 +1,114 @@
 #include "RenderformCreator.hpp"
 #include <algorithm>
+#include <atomic>
+#include "../../Core/JobSystem.hpp"
+#include "../../Core/Profiler.hpp"
 
-Renderer::IntForm bakeIntForm(const RenderformCreator& creator)
+RenderformCreator::RenderformCreator(ModelStore* modelStore, MaterialStore* matStore)
+    : mMaterialStore(matStore)
+    , mModelStore(modelStore)
+    , mCullStats{0, 0}
+    , mTransformOrder(0)
+    , mGeometryVersion(modelStore->GetGeometryVersion())
+{
+}
+
+void RenderformCreator::Update(const Scene& scene, const Scene::Updates& sceneUpdates)
 {
-    Renderer::IntForm rVal;
-    RenderformCreator::Renderform form = creator.GetRenderform();
+    ParseAddNodeUpdates(scene, sceneUpdates.newNodes);
+    ParseDeleteNodeUpdates(sceneUpdates.deletedNodes);
 
-    for (const auto& p : form)
+    // Re-resolve every mesh's transform index when the scene has reordered its transforms
+    const TransformHierarchy& transforms = scene.GetTransforms();
+    if (transforms.GetOrderVersion() != mTransformOrder)
     {
-        // Create new element
-        Renderer::IntMaterial im;
-        std::vector<Renderer::IntMesh> vec;
-        rVal.materials.push_back({ im, vec });
-
-        // Retrieve newly added element
-        auto& newEntry = rVal.materials[rVal.materials.size() - 1];
-
-        const auto& rformMat    = p.second;
-        const auto& rformMeshes = p.second.meshes;
-        std::vector<Renderer::IntMesh>& meshes = newEntry.second;
-
-        newEntry.first =
-        { rformMat.diffTexId
-        , rformMat.specTexId
-        , rformMat.nmapTexId
-        , rformMat.matIndex
-        , rformMat.useNormalMap
-        };
-
-        for (const auto& rformMesh : rformMeshes)
-        {
-            Renderer::IntMesh newMesh;
-            newMesh.transformation = *rformMesh.transformation;
-            newMesh.vaoId          = rformMesh.vaoId;
-            newMesh.eboId          = rformMesh.eboId;
-            newMesh.numIndices     = rformMesh.numIndices;
-            meshes.push_back(newMesh);
-        }
+        RefreshTransformIndices(scene);
+        mTransformOrder = transforms.GetOrderVersion();
     }
 
-    return rVal;
+    // Re-read every mesh's place in the geometry buffers when the model store has moved them
+    if (mModelStore->GetGeometryVersion() != mGeometryVersion)
+    {
+        RefreshGeometryRanges(scene);
+        mGeometryVersion = mModelStore->GetGeometryVersion();
+    }
 }
 
-RenderformCreator::RenderformCreator(ModelStore* modelStore, MaterialStore* matStore)
-    : mMaterialStore(matStore)
-    , mModelStore(modelStore)
+void RenderformCreator::Cull(Scene& scene, const glm::mat4& viewProj, const glm::mat4& prevViewProj, JobSystem* jobs)
+{
+    PROFILE_SCOPE("Cull");
+    mCullStats = {0, 0};
+
+    // Assume everything is culled, then let the tree reveal the visible nodes
+    for (const auto& entry : mNodeEntries)
+        scene.GetNode(entry.first)->SetCulled(true);
+    auto reveal = [](SceneNode* node) { node->SetCulled(false); };
+    scene.QueryFrustum(Frustum(viewProj), reveal);
+    if (prevViewProj != viewProj)
+        scene.QueryFrustum(Frustum(prevViewProj), reveal);
+
+    // Flag the meshes of each material, one job per material
+    std::atomic<std::size_t> visibleCount(0);
+    std::atomic<std::size_t> totalCount(0);
+    ParallelFor(jobs, mMaterials.size(), 1,
+        [&](std::size_t begin, std::size_t end)
+        {
+            std::size_t visibleMeshes = 0;
+            std::size_t totalMeshes = 0;
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                auto& meshes = mMaterials[i].second;
+                for (std::size_t j = 0; j < meshes.size(); ++j)
+                {
+                    bool visible = !scene.GetNode(mMeshNodes[i][j])->IsCulled();
+                    meshes[j].culled = !visible;
+
+                    if (visible)
+                        ++visibleMeshes;
+                    ++totalMeshes;
+                }
+            }
+            visibleCount += visibleMeshes;
+            totalCount += totalMeshes;
+        }
+    );
+    mCullStats.visible = visibleCount;
+    mCullStats.total = totalCount;
+}
+
+const RenderformCreator::MaterialList& RenderformCreator::GetMaterials() const
 {
+    return mMaterials;
 }
 
-void RenderformCreator::Update(const Scene::Updates& sceneUpdates)
+const RenderformCreator::ShadowCasterList& RenderformCreator::GetShadowCasters() const
 {
-    ParseAddNodeUpdates(sceneUpdates.newNodes);
-    ParseDeleteNodeUpdates(sceneUpdates.deletedNodes);
+    return mShadowCasters;
 }
 
-const RenderformCreator::Renderform& RenderformCreator::GetRenderform() const
+const RenderformCreator::CullStats& RenderformCreator::GetCullStats() const
 {
-    return mRenderform; 
+    return mCullStats;
 }
 
 //--------------------------------------------------
 // Private functions
 //--------------------------------------------------
-void RenderformCreator::ParseAddNodeUpdates(const std::vector<SceneNode*>& added)
+void RenderformCreator::ParseAddNodeUpdates(const Scene& scene, const std::vector<NodeHandle>& added)
 {
-    for (SceneNode* node : added)
+    for (NodeHandle handle : added)
     {
-        // Get the transformation
-        Transform& transformation = node->GetTransformation();
+        // Skip nodes deleted before their addition got parsed
+        const SceneNode* node = scene.GetNode(handle);
+        if (node == nullptr)
+            continue;
+
+        // Get node's back-references
+        NodeEntry& entry = mNodeEntries[handle];
+
+        // Get the transformation and the AABB
+        const std::uint32_t transformation = node->GetTransformIndex();
+        const AABB* aabb = &node->GetAABB();
 
         // Get the model
         const std::string& modelName = node->GetModel();
@@ -79,19 +120,19 @@ void RenderformCreator::ParseAddNodeUpdates(const std::vector<SceneNode*>& added
         for (const auto& mesh : mdl->meshes)
         {
             // Get material name
-            std::string matName = materials[mesh.meshIndex];
+            const std::string& matName = materials[mesh.meshIndex];
 
-            // Find if material already exists in renderform
-            auto matIt = mRenderform.find(matName);
+            // Find if material already exists in the render lists
+            auto matIt = mMaterialIndices.find(matName);
 
             // Set its parameters if it doesn't exist
-            if (matIt == std::end(mRenderform))
+            if (matIt == std::end(mMaterialIndices))
             {
                 // Get the material description
                 MaterialDescription* matDesc = (*mMaterialStore)[matName];
 
                 // Create new material
-                auto& material = mRenderform[matName];
+                Renderer::IntMaterial material;
 
                 // Material idnex
                 material.matIndex = matDesc->matIndex;
@@ -105,42 +146,176 @@ void RenderformCreator::ParseAddNodeUpdates(const std::vector<SceneNode*>& added
                 // Normal map
                 material.useNormalMap = matDesc->material.UsesNormalMapTexture();
                 material.nmapTexId = material.useNormalMap ? matDesc->material.GetNormalMapTexture() : 0;
+
+                matIt = mMaterialIndices.emplace(matName, mMaterials.size()).first;
+                mMaterials.push_back({material, {}});
+                mMaterialNames.push_back(matName);
+                mMeshNodes.emplace_back();
             }
 
-            // Create new renderform mesh and append it to material
-            mRenderform[matName].meshes.push_back(
-            { node
-            , modelName
-            , &transformation
+            // Create new render list mesh and append it to material
+            const std::size_t matIndex = matIt->second;
+            mMaterials[matIndex].second.push_back(
+            { transformation
+            , aabb
+            , mesh.vaoId
+            , mesh.eboId
+            , static_cast<GLuint>(mesh.range.numIndices)
+            , mesh.range.baseVertex
+            , mesh.range.firstIndex
+            , false
+            });
+            mMeshNodes[matIndex].push_back(handle);
+            entry.meshes.push_back({matIndex, mMaterials[matIndex].second.size() - 1});
+
+            // Register it as a shadow caster too
+            mShadowCasters.push_back(
+            { transformation
+            , aabb
             , mesh.vaoId
             , mesh.eboId
-            , mesh.numIndices
+            , static_cast<GLuint>(mesh.range.numIndices)
+            , mesh.range.baseVertex
+            , mesh.range.firstIndex
             });
+            mCasterNodes.push_back(handle);
+            entry.casters.push_back(mShadowCasters.size() - 1);
         }
     }
 }
 
-void RenderformCreator::ParseDeleteNodeUpdates(const std::vector<std::unique_ptr<SceneNode>>& deleted)
+void RenderformCreator::ParseDeleteNodeUpdates(const std::vector<NodeHandle>& deleted)
 {
-    for (auto& uptr : deleted)
+    for (NodeHandle handle : deleted)
     {
-        SceneNode* node = uptr.get();
+        // Find node's back-references
+        auto entryIt = mNodeEntries.find(handle);
+        if (entryIt == std::end(mNodeEntries))
+            continue;
+        NodeEntry& entry = entryIt->second;
 
-        // Get model name
-        const std::string& modelName = node->GetModel();
+        // Erase this node's meshes from the material lists
+        while (!entry.meshes.empty())
+        {
+            MeshLocation loc = entry.meshes.back();
+            entry.meshes.pop_back();
+            RemoveMesh(loc);
+        }
 
-        // Erase this model's meshes from renderform
-        for (auto& p : mRenderform)
+        // Erase this node's meshes from the shadow caster list
+        while (!entry.casters.empty())
         {
-            auto& meshes = p.second.meshes;
-            const auto meshIt = std::find_if(std::begin(meshes), std::end(meshes),
-                [&modelName](const Mesh& mesh) -> bool
-                {
-                    return modelName == mesh.modelName; 
-                });
+            std::size_t index = entry.casters.back();
+            entry.casters.pop_back();
+            RemoveShadowCaster(index);
+        }
+
+        mNodeEntries.erase(entryIt);
+    }
+}
+
+void RenderformCreator::RemoveMesh(MeshLocation loc)
+{
+    auto& meshes = mMaterials[loc.material].second;
+    auto& nodes  = mMeshNodes[loc.material];
+    const std::size_t last = meshes.size() - 1;
+
+    // Move the last mesh in the removed one's place and fix its owner's back-reference
+    if (loc.index != last)
+    {
+        meshes[loc.index] = meshes[last];
+        nodes[loc.index]  = nodes[last];
+        for (auto& ownerLoc : mNodeEntries[nodes[loc.index]].meshes)
+        {
+            if (ownerLoc.material == loc.material && ownerLoc.index == last)
+            {
+                ownerLoc.index = loc.index;
+                break;
+            }
+        }
+    }
+    meshes.pop_back();
+    nodes.pop_back();
+
+    // Evict materials left without meshes
+    if (meshes.empty())
+        RemoveMaterial(loc.material);
+}
+
+void RenderformCreator::RemoveMaterial(std::size_t index)
+{
+    const std::size_t last = mMaterials.size() - 1;
+    mMaterialIndices.erase(mMaterialNames[index]);
+
+    // Move the last material in the removed one's place and fix its meshes' back-references
+    if (index != last)
+    {
+        mMaterials[index]     = std::move(mMaterials[last]);
+        mMeshNodes[index]     = std::move(mMeshNodes[last]);
+        mMaterialNames[index] = std::move(mMaterialNames[last]);
+        mMaterialIndices[mMaterialNames[index]] = index;
+        for (NodeHandle owner : mMeshNodes[index])
+            for (auto& ownerLoc : mNodeEntries[owner].meshes)
+                if (ownerLoc.material == last)
+                    ownerLoc.material = index;
+    }
+    mMaterials.pop_back();
+    mMeshNodes.pop_back();
+    mMaterialNames.pop_back();
+}
+
+void RenderformCreator::RemoveShadowCaster(std::size_t index)
+{
+    const std::size_t last = mShadowCasters.size() - 1;
+
+    // Move the last caster in the removed one's place and fix its owner's back-reference
+    if (index != last)
+    {
+        mShadowCasters[index] = mShadowCasters[last];
+        mCasterNodes[index]   = mCasterNodes[last];
+        for (auto& ownerIndex : mNodeEntries[mCasterNodes[index]].casters)
+        {
+            if (ownerIndex == last)
+            {
+                ownerIndex = index;
+                break;
+            }
+        }
+    }
+    mShadowCasters.pop_back();
+    mCasterNodes.pop_back();
+}
+
+void RenderformCreator::RefreshTransformIndices(const Scene& scene)
+{
+    for (std::size_t i = 0; i < mMaterials.size(); ++i)
+    {
+        auto& meshes = mMaterials[i].second;
+        for (std::size_t j = 0; j < meshes.size(); ++j)
+            meshes[j].transform = scene.GetNode(mMeshNodes[i][j])->GetTransformIndex();
+    }
+
+    for (std::size_t i = 0; i < mShadowCasters.size(); ++i)
+        mShadowCasters[i].transform = scene.GetNode(mCasterNodes[i])->GetTransformIndex();
+}
+
+void RenderformCreator::RefreshGeometryRanges(const Scene& scene)
+{
+    for (const auto& p : mNodeEntries)
+    {
+        const NodeEntry& entry = p.second;
+        const ModelDescription* mdl = (*mModelStore)[scene.GetNode(p.first)->GetModel()];
+        for (std::size_t k = 0; k < mdl->meshes.size(); ++k)
+        {
+            const GeometryArena::Range& range = mdl->meshes[k].range;
+
+            auto& mesh = mMaterials[entry.meshes[k].material].second[entry.meshes[k].index];
+            mesh.baseVertex = range.baseVertex;
+            mesh.firstIndex = range.firstIndex;
 
-            if (meshIt != std::end(meshes))
-                meshes.erase(meshIt);
+            auto& caster = mShadowCasters[entry.casters[k]];
+            caster.baseVertex = range.baseVertex;
+            caster.firstIndex = range.firstIndex;
         }
     }
 }
@@ -35,60 +35,101 @@
 #include <memory>
 #include <unordered_map>
 #include "Scene.hpp"
+#include "Frustum.hpp"
 #include "../Resource/ModelStore.hpp"
 #include "../Resource/MaterialStore.hpp"
 #include "../Renderer/Renderer.hpp"
 
-// Forward declaration of RenderformCreator
-class RenderformCreator;
-
-// Converts a RenderformCreator::Renderform to a Renderer::IntForm
-Renderer::IntForm bakeIntForm(const RenderformCreator& creator);
-
 class RenderformCreator
 {
     public:
-        struct Mesh
-        {
-            SceneNode*  node;
-            std::string modelName;
-            Transform* transformation;
-            GLuint    vaoId,
-                      eboId;
-            GLsizei   numIndices;
-        };
+        // Render lists sorted by material
+        using MaterialList = std::vector<Renderer::MaterialVecEntry>;
+
+        // Flat list of every mesh used by the shadow pass
+        using ShadowCasterList = std::vector<ShadowRenderer::IntMesh>;
 
-        struct Material
+        struct CullStats
         {
-            GLuint diffTexId,
-                   specTexId,
-                   nmapTexId,
-                   matIndex;
-            bool   useNormalMap;
-            std::vector<Mesh> meshes;
+            std::size_t visible;
+            std::size_t total;
         };
 
-        using Renderform = std::unordered_map<std::string, Material>;
-
         // Constructor
         RenderformCreator(ModelStore* modelStore, MaterialStore* matStore);
 
-        // Update the render form using scene's updates
-        void Update(const Scene::Updates& sceneUpdates);
+        // Update the render lists using scene's updates
+        void Update(const Scene& scene, const Scene::Updates& sceneUpdates);
 
-        // Retrieve the renderform
-        const Renderform& GetRenderform() const;
+        // Marks the nodes whose world AABB lies outside both the given view projection's frustum and
+        // the previous one as culled, so nothing pops while the view is interpolated in between.
+        // Uses the scene's AABB tree to find the visible ones. The render lists are flagged in parallel
+        // on the given job system, if any
+        void Cull(Scene& scene, const glm::mat4& viewProj, const glm::mat4& prevViewProj, JobSystem* jobs = nullptr);
+
+        // Retrieve the render lists sorted by material
+        const MaterialList& GetMaterials() const;
+
+        // Retrieve the shadow caster list
+        const ShadowCasterList& GetShadowCasters() const;
+
+        // Retrieve the visible / total mesh counts of the last culling stage
+        const CullStats& GetCullStats() const;
 
     private:
-        Renderform     mRenderform;    // The scene's element sorted to a render friendly way
-        MaterialStore* mMaterialStore; // Material Store
-        ModelStore*    mModelStore;    // Model Store
+        MaterialList     mMaterials;       // The scene's elements sorted to a render friendly way
+        ShadowCasterList mShadowCasters;   // The scene's elements as shadow casters
+        MaterialStore*   mMaterialStore;   // Material Store
+        ModelStore*      mModelStore;      // Model Store
+        CullStats        mCullStats;       // Results of the last culling stage
+        std::uint32_t    mTransformOrder;  // Scene's transform order the render lists' indices refer to
+        std::uint32_t    mGeometryVersion; // Model store's geometry version the render lists' ranges refer to
+
+        // Location of a mesh in the material list
+        struct MeshLocation
+        {
+            std::size_t material;
+            std::size_t index;
+        };
+
+        // Back-references of a node into the render lists, in the order of its model's meshes
+        struct NodeEntry
+        {
+            std::vector<MeshLocation> meshes;
+            std::vector<std::size_t>  casters;
+        };
+
+        // Material name to index in the material list and its reverse
+        std::unordered_map<std::string, std::size_t> mMaterialIndices;
+        std::vector<std::string> mMaterialNames;
+
+        // Owner nodes of the meshes, parallel to the material list's meshes and the shadow caster list
+        std::vector<std::vector<NodeHandle>> mMeshNodes;
+        std::vector<NodeHandle> mCasterNodes;
+
+        // Back-references of every node in the render lists
+        std::unordered_map<NodeHandle, NodeEntry> mNodeEntries;
+
+        // Removes the mesh at the given location by swapping it with the last one of its material
+        void RemoveMesh(MeshLocation loc);
+
+        // Removes the material at the given index by swapping it with the last one
+        void RemoveMaterial(std::size_t index);
+
+        // Removes the shadow caster at the given index by swapping it with the last one
+        void RemoveShadowCaster(std::size_t index);
 
         // Parse added-node updates
-        void ParseAddNodeUpdates(const std::vector<SceneNode*>& added);
+        void ParseAddNodeUpdates(const Scene& scene, const std::vector<NodeHandle>& added);
 
         // Parse deleted-node updates
-        void ParseDeleteNodeUpdates(const std::vector<std::unique_ptr<SceneNode>>& deleted);
+        void ParseDeleteNodeUpdates(const std::vector<NodeHandle>& deleted);
+
+        // Resolves the transform index of every mesh from its owner node
+        void RefreshTransformIndices(const Scene& scene);
+
+        // Copies the base vertex and first index of every mesh from its model
+        void RefreshGeometryRanges(const Scene& scene);
 };
 
 #endif // ! _RENDERFORM_CREATOR_HPP_
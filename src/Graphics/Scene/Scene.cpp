@@ -1,5 +1,7 @@
 #include "Scene.hpp"
 #include <algorithm>
+#include "../../Core/JobSystem.hpp"
+#include "../../Core/Profiler.hpp"
 
 //--------------------------------------------------
 // Public functions
@@ -12,7 +14,7 @@ Scene::Scene()
     //mNodes[""] = std::make_unique<SceneNode>("", "", "", SceneNodeCategory::Invalid, AABB());
 }
 
-SceneNode* Scene::CreateNode(
+NodeHandle Scene::CreateNode(
     const std::string& model,
     const std::vector<std::string>& material,
     const std::string& uuid,
@@ -20,15 +22,18 @@ SceneNode* Scene::CreateNode(
     const AABB& initAABB,
     bool isCulled /* = false */)
 {
-    // Create node
-    std::unique_ptr<SceneNode> ptr =
-        std::make_unique<SceneNode>(model, material, uuid, category, initAABB, isCulled);
+    // Create node in the node bank
+    NodeHandle rVal = mNodes.Emplace(model, material, uuid, category, initAABB, isCulled);
+    SceneNode* node = mNodes.Get(rVal);
+    node->SetHandle(rVal);
+    node->SetTransformIndex(mTransforms.Add(rVal));
 
-    // Save the pointer
-    SceneNode* rVal = ptr.get();
+    // Index it by its uuid
+    mUuidIndex[uuid] = rVal;
 
-    // Move the unique pointer to node bank
-    mNodes[rVal->GetUUID()] = std::move(ptr);
+    // Index it in the AABB tree
+    const AABB& aabb = node->GetAABB();
+    node->SetTreeProxy(mTree.CreateProxy(aabb.MinPoint(), aabb.MaxPoint(), node));
 
     // If it is light, add it to lights
     if(category == Category::Light)
@@ -40,79 +45,92 @@ SceneNode* Scene::CreateNode(
     return rVal;
 }
 
-void Scene::DeleteNode(const std::string& uuid, bool deleteChildren /* = false */)
+void Scene::DeleteNode(NodeHandle handle, bool deleteChildren /* = false */)
 {
-    SceneNode* node = FindNodeByUuid(uuid);
+    SceneNode* node = mNodes.Get(handle);
 
     // If node doesn't exist, do nothing
     if(node == nullptr)
         return;
-    else
-        DeleteNode(node, deleteChildren);
-}
 
-void Scene::DeleteNode(SceneNode* const node, bool deleteChildren /* = false */)
-{
     // Erase it from lights vector if it is a light
     if(node->GetCategory() == Category::Light)
     {
-        auto light = std::find_if(std::begin(mLights), std::end(mLights),
-        [&node](SceneNode* lightNode) -> bool
-        {
-            return node->GetUUID().compare(lightNode->GetUUID()) == 0;
-        });
-
+        auto light = std::find(std::begin(mLights), std::end(mLights), handle);
         if(light != std::end(mLights))
             mLights.erase(light);
     }
 
-    // Delete children if necessary
-    if(deleteChildren)
-        for(SceneNode* child : node->GetChildren())
+    // Delete children if necessary, otherwise make them orphans
+    // (copy the list first, as deleting a child removes it from this node)
+    const std::vector<NodeHandle> children = node->GetChildren();
+    for(NodeHandle child : children)
+    {
+        if(deleteChildren)
             DeleteNode(child, deleteChildren);
+        else if(SceneNode* childNode = mNodes.Get(child))
+        {
+            childNode->SetParent(NullSlotHandle);
+            mTransforms.SetParent(childNode->GetTransformIndex(), TransformHierarchy::Null);
+        }
+    }
+
+    // Remove it from its parent
+    if(SceneNode* parent = mNodes.Get(node->GetParent()))
+        parent->RemoveChild(handle);
 
+    // Remove it from the AABB tree and the transform hierarchy
+    mTree.DestroyProxy(node->GetTreeProxy());
+    mTransforms.Remove(node->GetTransformIndex());
 
     // Erase node and add it to updates
-    auto nodeIt = mNodes.find(node->GetUUID());
-    mUpdates.deletedNodes.push_back(std::move(nodeIt->second));
-    mNodes.erase(nodeIt);
+    mUuidIndex.erase(node->GetUUID());
+    mNodes.Erase(handle);
+    mUpdates.deletedNodes.push_back(handle);
 }
 
-void Scene::AttachToParent(SceneNode* child, const std::string& parentUuid)
+void Scene::AttachToParent(NodeHandle child, NodeHandle parent)
 {
-    auto parent = FindNodeByUuid(parentUuid);
+    SceneNode* childNode  = mNodes.Get(child);
+    SceneNode* parentNode = mNodes.Get(parent);
 
-    // Do nothing if parent doesn't exist
-    if(parent == nullptr)
+    // Do nothing if either of them doesn't exist
+    if(childNode == nullptr || parentNode == nullptr)
         return;
 
+    // Do nothing if the parent is the child itself or one of its descendants
+    for(NodeHandle p = parent; p != NullSlotHandle; p = mNodes.Get(p)->GetParent())
+        if(p == child)
+            return;
+
+    // Leave the old parent
+    DetachFromParent(child);
+
     // Add child to parent
-    parent->AddChild(child);
+    parentNode->AddChild(child);
+    childNode->SetParent(parent);
+    mTransforms.SetParent(childNode->GetTransformIndex(), parentNode->GetTransformIndex());
 }
 
-void Scene::DetachFromParent(const std::string& childUuid, const std::string& parentUuid)
+void Scene::DetachFromParent(NodeHandle child)
 {
-    SceneNode* parent = FindNodeByUuid(parentUuid);
+    SceneNode* childNode = mNodes.Get(child);
 
-    // Do nothing if parent doesn't exist
-    if(parent == nullptr)
+    // Do nothing if child doesn't exist
+    if(childNode == nullptr)
         return;
 
     // Remove child from parent
-    parent->RemoveChild(childUuid);
+    if(SceneNode* parentNode = mNodes.Get(childNode->GetParent()))
+        parentNode->RemoveChild(child);
+    childNode->SetParent(NullSlotHandle);
+    mTransforms.SetParent(childNode->GetTransformIndex(), TransformHierarchy::Null);
 }
 
 Scene::Updates Scene::PullUpdates()
 {
-    // Create an update bundle to return
-    Updates rVal;
-
-    // Copy new nodes
-    rVal.newNodes = mUpdates.newNodes;
-
-    // Move deleted nodes unique pointers
-    for (auto& uptr : mUpdates.deletedNodes)
-        rVal.deletedNodes.push_back(std::move(uptr));
+    // Copy the updates, keeping the update vectors' storage for the next ones
+    Updates rVal = mUpdates;
 
     // Clear old update state
     ClearUpdates();
@@ -120,43 +138,115 @@ Scene::Updates Scene::PullUpdates()
     return rVal;
 }
 
-void Scene::Move(const std::string& uuid, const glm::vec3& pos, bool moveChildren /* = false */)
+void Scene::Move(NodeHandle node, const glm::vec3& pos)
 {
-    Move(FindNodeByUuid(uuid), pos, moveChildren);
+    Move(mNodes.Get(node), pos);
 }
 
-void Scene::Move(SceneNode* const node, const glm::vec3& pos, bool moveChildren /* = false */)
+void Scene::Move(SceneNode* const node, const glm::vec3& pos)
 {
     if(node == nullptr)
         return;
     else
-        node->Move(pos, moveChildren);
+        mTransforms.Move(node->GetTransformIndex(), pos);
 }
 
-void Scene::Rotate(const std::string& uuid, RotationAxis axis, float angle, bool rotateChildren /* = false */)
+void Scene::Rotate(NodeHandle node, RotationAxis axis, float angle)
 {
-    Rotate(FindNodeByUuid(uuid), axis, angle, rotateChildren);
+    Rotate(mNodes.Get(node), axis, angle);
 }
 
-void Scene::Rotate(SceneNode* const node, RotationAxis axis, float angle, bool rotateChildren /* = false */)
+void Scene::Rotate(SceneNode* const node, RotationAxis axis, float angle)
 {
     if(node == nullptr)
         return;
-    else
-        node->Rotate(axis, angle, rotateChildren);
+
+    glm::vec3 axisVec;
+    switch(axis)
+    {
+        case RotationAxis::X:
+            axisVec = glm::vec3(1, 0, 0);
+            break;
+        case RotationAxis::Y:
+            axisVec = glm::vec3(0, 1, 0);
+            break;
+        case RotationAxis::Z:
+            axisVec = glm::vec3(0, 0, 1);
+            break;
+    }
+    mTransforms.Rotate(node->GetTransformIndex(), axisVec, angle);
 }
 
-void Scene::Scale(const std::string& uuid, const glm::vec3& scale, bool scaleChildren /* = false */)
+void Scene::Scale(NodeHandle node, const glm::vec3& scale)
 {
-    Scale(FindNodeByUuid(uuid), scale, scaleChildren);
+    Scale(mNodes.Get(node), scale);
 }
 
-void Scene::Scale(SceneNode* const node, const glm::vec3& scale, bool scaleChildren /* = false */)
+void Scene::Scale(SceneNode* const node, const glm::vec3& scale)
 {
     if(node == nullptr)
         return;
     else
-        node->Scale(scale, scaleChildren);
+        mTransforms.Scale(node->GetTransformIndex(), scale);
+}
+
+void Scene::Update(JobSystem* jobs)
+{
+    PROFILE_SCOPE("SceneUpdate");
+
+    // Recompute all world matrices in a single pass, and fix the nodes' indices if they got reordered
+    if (mTransforms.Update(jobs))
+    {
+        for (std::uint32_t i = 0; i < mTransforms.Size(); ++i)
+            mNodes.Get(mTransforms.GetOwner(i))->SetTransformIndex(i);
+    }
+
+    // Only the nodes whose world matrix changed need their AABB and tree leaf updated
+    const std::vector<glm::mat4>& world = mTransforms.GetWorld();
+    const std::vector<std::uint32_t>& changed = mTransforms.GetChanged();
+    mChangedNodes.resize(changed.size());
+    mAABBScratch.resize(changed.size());
+    mWorldScratch.resize(changed.size());
+
+    // Gather the boxes and transform them in batches, one per job
+    ParallelFor(jobs, changed.size(), 1024,
+        [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t k = begin; k < end; ++k)
+            {
+                const std::uint32_t i = changed[k];
+                const SceneNode* node = mNodes.Get(mTransforms.GetOwner(i));
+                mChangedNodes[k] = node->GetHandle();
+                mAABBScratch[k]  = node->GetAABB();
+                mWorldScratch[k] = world[i];
+            }
+            TransformAABBs(mWorldScratch.data() + begin, mAABBScratch.data() + begin, mAABBScratch.data() + begin, end - begin);
+        }
+    );
+
+    // Scatter the world AABBs back and refit the tree, which is not thread safe
+    for (std::size_t i = 0; i < mChangedNodes.size(); ++i)
+    {
+        SceneNode* node = mNodes.Get(mChangedNodes[i]);
+        AABB& aabb = node->GetAABB();
+        aabb = mAABBScratch[i];
+        mTree.MoveProxy(node->GetTreeProxy(), aabb.MinPoint(), aabb.MaxPoint());
+    }
+}
+
+const std::vector<NodeHandle>& Scene::GetChangedNodes() const
+{
+    return mChangedNodes;
+}
+
+const TransformHierarchy& Scene::GetTransforms() const
+{
+    return mTransforms;
+}
+
+glm::mat4 Scene::ComputeWorldTransform(const SceneNode* node) const
+{
+    return mTransforms.ComputeWorld(node->GetTransformIndex());
 }
 
 const Scene::NodeBank& Scene::GetNodes() const
@@ -164,15 +254,61 @@ const Scene::NodeBank& Scene::GetNodes() const
     return mNodes;
 }
 
+SceneNode* Scene::GetNode(NodeHandle node)
+{
+    return mNodes.Get(node);
+}
+
+const SceneNode* Scene::GetNode(NodeHandle node) const
+{
+    return mNodes.Get(node);
+}
+
+SceneNode* Scene::RayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDist, float* hitDist /* = nullptr */) const
+{
+    SceneNode* closest = nullptr;
+    float closestDist = maxDist;
+    const glm::vec3 invDir = 1.0f / dir;
+
+    mTree.RayCast(origin, dir, maxDist,
+        [&](SceneNode* node, float) -> float
+        {
+            // Slab test against the exact AABB
+            AABB& aabb = node->GetAABB();
+            const glm::vec3 t1 = (aabb.MinPoint() - origin) * invDir;
+            const glm::vec3 t2 = (aabb.MaxPoint() - origin) * invDir;
+            const glm::vec3 tMin = glm::min(t1, t2);
+            const glm::vec3 tMax = glm::max(t1, t2);
+            const float tEnter = std::max(std::max(tMin.x, tMin.y), std::max(tMin.z, 0.0f));
+            const float tExit = std::min(std::min(tMax.x, tMax.y), tMax.z);
+            if (tEnter <= tExit && tEnter < closestDist)
+            {
+                closest = node;
+                closestDist = tEnter;
+            }
+            return closestDist;
+        }
+    );
+
+    if (closest != nullptr && hitDist != nullptr)
+        *hitDist = closestDist;
+    return closest;
+}
+
+const AABBTree& Scene::GetTree() const
+{
+    return mTree;
+}
+
 const Scene::PointLights& Scene::GetLights() const
 {
     return mLights;
 }
 
-SceneNode* Scene::FindNodeByUuid(const std::string& uuid)
+NodeHandle Scene::FindNodeByUuid(const std::string& uuid) const
 {
-    auto it = mNodes.find(uuid);
-    return (it == std::end(mNodes)) ? nullptr : it->second.get();
+    auto it = mUuidIndex.find(uuid);
+    return (it == std::end(mUuidIndex)) ? NullSlotHandle : it->second;
 }
 
 //==================================================
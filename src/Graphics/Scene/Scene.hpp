@@ -32,28 +32,33 @@
 #define _SCENE_HPP_
 
 #include <string>
-#include <map>
+#include <unordered_map>
 #include <memory>
 #include "SceneNode.hpp"
+#include "AABBTree.hpp"
+#include "TransformHierarchy.hpp"
+#include "Frustum.hpp"
+#include "../../Util/SlotMap.hpp"
 
 class Scene
 {
-    //                           UUID               Unique Ptr to node
-    using NodeBank    = std::map<std::string,       std::unique_ptr<SceneNode>>;
-    using PointLights = std::vector<SceneNode*>;
+    using NodeBank    = SlotMap<SceneNode>;
+    //                                     UUID         Handle to node
+    using UuidIndex   = std::unordered_map<std::string, NodeHandle>;
+    using PointLights = std::vector<NodeHandle>;
 
     public:
         struct Updates
         {
-            std::vector<SceneNode*> newNodes;
-            std::vector<std::unique_ptr<SceneNode>> deletedNodes;
+            std::vector<NodeHandle> newNodes;
+            std::vector<NodeHandle> deletedNodes;
         };
 
         /// Constructor
         Scene();
 
         /// Creates node and adds it to NodeBank
-        SceneNode* CreateNode(
+        NodeHandle CreateNode(
             const std::string& model,
             const std::vector<std::string>& material,
             const std::string& uuid,
@@ -62,48 +67,109 @@ class Scene
             bool isCulled = false);
 
         /// Deletes a node
-        void DeleteNode(const std::string& uuid, bool deleteChildren = false);
-        void DeleteNode(SceneNode* const node, bool deleteChildren = false);
+        void DeleteNode(NodeHandle node, bool deleteChildren = false);
 
         /// Attach child to parent
-        void AttachToParent(SceneNode* child, const std::string& parentUuid);
+        void AttachToParent(NodeHandle child, NodeHandle parent);
 
-        /// Detach child from parent
-        void DetachFromParent(const std::string& childUuid, const std::string& parentUuid);
+        /// Detach child from its parent
+        void DetachFromParent(NodeHandle child);
 
         /// Retrieves the updates and clears the update vectors
         Updates PullUpdates();
 
-        /// Move the node and optionally its children too
-        void Move(const std::string& uuid, const glm::vec3& pos, bool moveChildren = false);
-        void Move(SceneNode* const node, const glm::vec3& pos, bool moveChildren = false);
+        /// Move the node (its children follow it)
+        void Move(NodeHandle node, const glm::vec3& pos);
+        void Move(SceneNode* const node, const glm::vec3& pos);
 
-        /// Rotate the node and optionally its children
-        void Rotate(const std::string& uuid, RotationAxis axis, float angle, bool rotateChildren = false);
-        void Rotate(SceneNode* const node, RotationAxis axis, float angle, bool rotateChildren = false);
+        /// Rotate the node (its children follow it)
+        void Rotate(NodeHandle node, RotationAxis axis, float angle);
+        void Rotate(SceneNode* const node, RotationAxis axis, float angle);
 
-        /// Scale the node and optionally its children too
-        void Scale(const std::string& uuid, const glm::vec3& scale, bool scaleChildren = false);
-        void Scale(SceneNode* const node, const glm::vec3& scale, bool scaleChildren = false);
+        /// Scale the node (its children follow it)
+        void Scale(NodeHandle node, const glm::vec3& scale);
+        void Scale(SceneNode* const node, const glm::vec3& scale);
+
+        /// Recomputes the world transformations and the AABBs of the nodes changed since the last update
+        /// and refits the AABB tree. The per node work is split over the given job system, if any
+        void Update(JobSystem* jobs = nullptr);
+
+        /// Get the nodes whose world transformation changed in the last update
+        const std::vector<NodeHandle>& GetChangedNodes() const;
+
+        /// Get the transform hierarchy of the nodes
+        const TransformHierarchy& GetTransforms() const;
+
+        /// Composes the current world transformation of a node, reflecting the changes made since the last update
+        glm::mat4 ComputeWorldTransform(const SceneNode* node) const;
 
         /// Get all nodes in their container
         const NodeBank& GetNodes() const;
 
+        /// Retrieves the node of the given handle, or nullptr if it has been deleted
+        SceneNode* GetNode(NodeHandle node);
+        const SceneNode* GetNode(NodeHandle node) const;
+
+        /// Calls fn(SceneNode*) for every node whose AABB overlaps the given one
+        template <typename Fn>
+        void QueryOverlaps(const AABB& aabb, Fn&& fn) const;
+
+        /// Calls fn(SceneNode*) for every node whose AABB intersects the given frustum
+        template <typename Fn>
+        void QueryFrustum(const Frustum& frustum, Fn&& fn) const;
+
+        /// Finds the closest node whose AABB is hit by the given ray, or nullptr
+        SceneNode* RayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDist, float* hitDist = nullptr) const;
+
+        /// Get the spatial index of the nodes
+        const AABBTree& GetTree() const;
+
         /// Get all scene's lights
         const PointLights& GetLights() const;
 
-        /// Finds the node with the given uuid
-        SceneNode* FindNodeByUuid(const std::string& uuid);
+        /// Finds the handle of the node with the given uuid (meant for loading and scripting, not per frame use)
+        NodeHandle FindNodeByUuid(const std::string& uuid) const;
 
     private:
-        SceneNode*  mRootNode; /// Scene's root node
-        NodeBank    mNodes;    /// All nodes
-        PointLights mLights;   /// Scene's point lights
-        Updates     mUpdates;  /// Scene's updates (basically a diff)
+        NodeBank                mNodes;        /// All nodes
+        UuidIndex               mUuidIndex;    /// Uuid lookup of the nodes
+        PointLights             mLights;       /// Scene's point lights
+        Updates                 mUpdates;      /// Scene's updates (basically a diff)
+        AABBTree                mTree;         /// Spatial index of all nodes
+        TransformHierarchy      mTransforms;   /// Local and world transformations of all nodes
+        std::vector<NodeHandle> mChangedNodes; /// Nodes changed in the last update
+        std::vector<AABB>       mAABBScratch;  /// Changed nodes' AABBs, batched for transformation
+        std::vector<glm::mat4>  mWorldScratch; /// Changed nodes' world matrices, batched for transformation
 
         /// Clear updates
         void ClearUpdates();
 
 }; // ! Scene
 
+template <typename Fn>
+void Scene::QueryOverlaps(const AABB& aabb, Fn&& fn) const
+{
+    // The tree works on fat AABBs, so refine its results with the exact ones
+    mTree.QueryOverlaps(aabb.MinPoint(), aabb.MaxPoint(),
+        [&aabb, &fn](SceneNode* node)
+        {
+            if (Intersects(aabb, node->GetAABB()))
+                fn(node);
+        }
+    );
+}
+
+template <typename Fn>
+void Scene::QueryFrustum(const Frustum& frustum, Fn&& fn) const
+{
+    // The tree works on fat AABBs, so refine its results with the exact ones
+    mTree.QueryFrustum(frustum,
+        [&frustum, &fn](SceneNode* node)
+        {
+            if (Intersects(frustum, node->GetAABB()))
+                fn(node);
+        }
+    );
+}
+
 #endif // ! _SCENE_HPP_
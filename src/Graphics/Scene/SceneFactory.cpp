@@ -139,15 +139,14 @@ void SceneFactory::LoadSceneNode(
     std::vector<std::string> materials;
     for (const auto& m : modelIt->materials)
         materials.push_back(m.data);
-    scene->CreateNode(modelIt->geometry.data, materials, node.id.data, category, initAABB);
+    NodeHandle handle = scene->CreateNode(modelIt->geometry.data, materials, node.id.data, category, initAABB);
 
     // Set initial transformation
-    SceneNode* sceneNode = scene->FindNodeByUuid(node.id.data);
-    sceneNode->Move(node.transform.position);
-    sceneNode->Scale(node.transform.scale);
-    sceneNode->Rotate(RotationAxis::X, node.transform.rotation.x);
-    sceneNode->Rotate(RotationAxis::Y, node.transform.rotation.y);
-    sceneNode->Rotate(RotationAxis::Z, node.transform.rotation.z);
+    scene->Move(handle, node.transform.position);
+    scene->Scale(handle, node.transform.scale);
+    scene->Rotate(handle, RotationAxis::X, node.transform.rotation.x);
+    scene->Rotate(handle, RotationAxis::Y, node.transform.rotation.y);
+    scene->Rotate(handle, RotationAxis::Z, node.transform.rotation.z);
 
     // Load children
     for (const auto& c : node.children)
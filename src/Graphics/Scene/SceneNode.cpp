@@ -11,34 +11,34 @@ SceneNode::SceneNode(
     Category category,
     AABB localAABB,
     bool isCulled /* = false */,
-    SceneNode* parent /* = nullptr */)
+    NodeHandle parent /* = NullSlotHandle */)
     : mModel(model)
     , mMaterials(materials)
+    , mTransformIndex(0xFFFFFFFF)
     , mCategory(category)
     , mUuid(uuid)
     , mAABB(localAABB)
     , mCulled(isCulled)
+    , mTreeProxy(-1)
+    , mHandle(NullSlotHandle)
     , mParent(parent)
 {
 }
 
-void SceneNode::AddChild(SceneNode* const child)
+void SceneNode::AddChild(NodeHandle child)
 {
     // If child exists don't do anything
-    if(FindChildByUuid(child->mUuid) != std::end(mChildren))
+    if(std::find(std::begin(mChildren), std::end(mChildren), child) != std::end(mChildren))
         return;
 
     // Add child to list
     mChildren.push_back(child);
-
-    // Add a parent to newly added child
-    child->mParent = this;
 }
 
-void SceneNode::RemoveChild(const std::string& uuid)
+void SceneNode::RemoveChild(NodeHandle child)
 {
-    // Find the child with the given uuid
-    auto it = FindChildByUuid(uuid);
+    // Find the given child
+    auto it = std::find(std::begin(mChildren), std::end(mChildren), child);
 
     // Return if child doesn't exist
     if(it == std::end(mChildren))
@@ -46,50 +46,6 @@ void SceneNode::RemoveChild(const std::string& uuid)
 
     // Remove child
     mChildren.erase(it);
-
-    // Make the child orphan
-    (*it)->mParent = nullptr;
-}
-
-void SceneNode::Move(const glm::vec3& pos, bool moveChildren /* = false */)
-{
-    // Move this node
-    mTransform.Move(pos);
-
-    // Move children (if necessary)
-    if(moveChildren)
-        MoveChildren(pos);
-}
-
-void SceneNode::Rotate(RotationAxis axis, float angle, bool rotateChildren /* = false */)
-{
-    // Rotate this node
-    switch(axis)
-    {
-        case RotationAxis::X:
-            mTransform.RotateX(angle);
-            break;
-        case  RotationAxis::Y:
-            mTransform.RotateY(angle);
-            break;
-        case RotationAxis::Z:
-            mTransform.RotateZ(angle);
-            break;
-    }
-
-    // Rotate children (if necessary)
-    if(rotateChildren)
-        RotateChildren(axis, angle);
-}
-
-void SceneNode::Scale(const glm::vec3& scale, bool scaleChildren /* = false */)
-{
-    // Scale this node
-    mTransform.Scale(scale);
-
-    // Scale children (if necessary)
-    if(scaleChildren)
-        ScaleChildren(scale);
 }
 
 const std::string& SceneNode::GetModel() const
@@ -102,9 +58,14 @@ const std::vector<std::string>& SceneNode::GetMaterials() const
     return mMaterials;
 }
 
-Transform& SceneNode::GetTransformation()
+std::uint32_t SceneNode::GetTransformIndex() const
 {
-    return mTransform;
+    return mTransformIndex;
+}
+
+void SceneNode::SetTransformIndex(std::uint32_t index)
+{
+    mTransformIndex = index;
 }
 
 Category SceneNode::GetCategory() const
@@ -122,47 +83,52 @@ AABB& SceneNode::GetAABB()
     return mAABB;
 }
 
+const AABB& SceneNode::GetAABB() const
+{
+    return mAABB;
+}
+
 bool SceneNode::IsCulled() const
 {
     return mCulled;
 }
 
+void SceneNode::SetCulled(bool culled)
+{
+    mCulled = culled;
+}
+
 const SceneNode::ChildrenList& SceneNode::GetChildren() const
 {
     return mChildren;
 }
 
-//--------------------------------------------------
-// Private functions
-//--------------------------------------------------
-void SceneNode::MoveChildren(const glm::vec3& pos)
+int SceneNode::GetTreeProxy() const
 {
-    for(SceneNode* child : mChildren)
-        child->Move(pos, true);
+    return mTreeProxy;
 }
 
-void SceneNode::RotateChildren(RotationAxis axis, float angle)
+void SceneNode::SetTreeProxy(int proxy)
 {
-    for(SceneNode* child : mChildren)
-        child->Rotate(axis, angle, true);
+    mTreeProxy = proxy;
 }
 
-void SceneNode::ScaleChildren(const glm::vec3& scale)
+NodeHandle SceneNode::GetParent() const
 {
-    for(SceneNode* child : mChildren)
-        child->Scale(scale, true);
+    return mParent;
 }
 
-SceneNode::ChildrenList::iterator SceneNode::FindChildByUuid(const std::string& uuid)
+void SceneNode::SetParent(NodeHandle parent)
 {
-    return std::find_if(std::begin(mChildren),
-              std::end(mChildren),
-              [&uuid](SceneNode* child) -> bool
-              {
-                  if(child == nullptr)
-                      return false;
+    mParent = parent;
+}
 
-                  return child->mUuid.compare(uuid) == 0;
-              }
-    );
+NodeHandle SceneNode::GetHandle() const
+{
+    return mHandle;
+}
+
+void SceneNode::SetHandle(NodeHandle handle)
+{
+    mHandle = handle;
 }
@@ -32,9 +32,10 @@
 #define _SCENENODE_HPP_
 
 #include <string>
+#include <cstdint>
 #include <vector>
-#include "Transform.hpp"
 #include "AABB.hpp"
+#include "../../Util/SlotMap.hpp"
 
 #include "../../Util/WarnGuard.hpp"
 WARN_GUARD_ON
@@ -49,6 +50,9 @@ enum class Category
     Invalid
 };
 
+/// Generational handle to a node in its scene
+using NodeHandle = SlotHandle;
+
 enum class RotationAxis
 {
     X,
@@ -58,7 +62,7 @@ enum class RotationAxis
 
 class SceneNode
 {
-    using ChildrenList = std::vector<SceneNode*>;
+    using ChildrenList = std::vector<NodeHandle>;
 
     public:
         /// Constructor
@@ -69,22 +73,13 @@ class SceneNode
             Category category,
             AABB localAABB,
             bool isCulled = false,
-            SceneNode* parent = nullptr);
+            NodeHandle parent = NullSlotHandle);
 
         /// Adds given child to children list
-        void AddChild(SceneNode* const child);
-
-        /// Removes the child with the given uuid from children
-        void RemoveChild(const std::string& uuid);
-
-        /// Move this node and optionally its children too
-        void Move(const glm::vec3& pos, bool moveChildren = false);
-
-        /// Rotate this node and optionally its children
-        void Rotate(RotationAxis axis, float angle, bool rotateChildren = false);
+        void AddChild(NodeHandle child);
 
-        /// Scale this node and optionally its children too
-        void Scale(const glm::vec3& scale, bool scaleChildren = false);
+        /// Removes the given child from children
+        void RemoveChild(NodeHandle child);
 
         /// Get model
         const std::string& GetModel() const;
@@ -92,8 +87,11 @@ class SceneNode
         /// Get material
         const std::vector<std::string>& GetMaterials() const;
 
-        /// Get transformation
-        Transform& GetTransformation();
+        /// Get the node's index in the scene's transform hierarchy
+        std::uint32_t GetTransformIndex() const;
+
+        /// Set the node's index in the scene's transform hierarchy
+        void SetTransformIndex(std::uint32_t index);
 
         /// Get category
         Category GetCategory() const;
@@ -103,36 +101,48 @@ class SceneNode
 
         /// Get AABB
         AABB& GetAABB();
+        const AABB& GetAABB() const;
 
         /// Get culled
         bool IsCulled() const;
 
+        /// Set culled
+        void SetCulled(bool culled);
+
         /// Get a list with children nodes
         const ChildrenList& GetChildren() const;
 
+        /// Get the parent node
+        NodeHandle GetParent() const;
+
+        /// Set the parent node
+        void SetParent(NodeHandle parent);
+
+        /// Get the node's handle in its scene
+        NodeHandle GetHandle() const;
+
+        /// Set the node's handle in its scene
+        void SetHandle(NodeHandle handle);
+
+        /// Get the node's proxy in the scene's AABB tree
+        int GetTreeProxy() const;
+
+        /// Set the node's proxy in the scene's AABB tree
+        void SetTreeProxy(int proxy);
+
     private:
         std::string mModel;                  /// Node's model name
         std::vector<std::string> mMaterials; /// Node's materials name (per mesh)
-        Transform mTransform;                /// Node's current transformation
+        std::uint32_t mTransformIndex;       /// Node's transform in the scene's hierarchy
         Category mCategory;                  /// Node's category
         std::string mUuid;                   /// Node's unique id
         AABB mAABB;                          /// Node's AABB
         bool mCulled;                        /// Is the node culled?
+        int mTreeProxy;                      /// Node's leaf in the scene's AABB tree
+        NodeHandle mHandle;                  /// Node's handle in its scene
 
-        SceneNode* mParent;                  /// Node's parent object
+        NodeHandle mParent;                  /// Node's parent object
         ChildrenList mChildren;              /// Node's children objects
-
-        /// Moves all children of this node
-        void MoveChildren(const glm::vec3& pos);
-
-        /// Rotates all children of this node
-        void RotateChildren(RotationAxis axis, float angle);
-
-        /// Scales all children of this node
-        void ScaleChildren(const glm::vec3& scale);
-
-        /// Find if there is a child with the given uuid
-        ChildrenList::iterator FindChildByUuid(const std::string& uuid);
 }; // ! SceneNode
 
 #endif // ! _SCENENODE_HPP_
@@ -0,0 +1,331 @@
+#include "TransformHierarchy.hpp"
+#include "../../Core/JobSystem.hpp"
+#include "../../Core/Profiler.hpp"
+#include <algorithm>
+#include <type_traits>
+
+const std::uint32_t TransformHierarchy::Null;
+
+TransformHierarchy::TransformHierarchy()
+    : mParentedCount(0)
+    , mNeedsReorder(false)
+    , mOrderVersion(0)
+{
+}
+
+std::uint32_t TransformHierarchy::Add(std::uint32_t owner)
+{
+    const std::uint32_t index = static_cast<std::uint32_t>(mParents.size());
+    mParents.push_back(Null);
+    mOwners.push_back(owner);
+    mPositions.push_back(glm::vec3(0.0f));
+    mRotations.push_back(glm::quat());
+    mScales.push_back(glm::vec3(1.0f));
+    mWorld.push_back(glm::mat4());
+    mPrevWorld.push_back(glm::mat4());
+    mFresh.push_back(1);
+    mDirty.push_back(0);
+    MarkDirty(index);
+    return index;
+}
+
+void TransformHierarchy::Remove(std::uint32_t index)
+{
+    if (mParents[index] != Null)
+        --mParentedCount;
+    mOwners[index] = Null;
+    mParents[index] = Null;
+    mNeedsReorder = true;
+}
+
+void TransformHierarchy::SetParent(std::uint32_t index, std::uint32_t parent)
+{
+    // Refuse to parent a transform under itself or one of its descendants
+    for (std::uint32_t p = parent; p != Null; p = mParents[p])
+        if (p == index)
+            return;
+
+    if (mParents[index] == Null && parent != Null)
+        ++mParentedCount;
+    else if (mParents[index] != Null && parent == Null)
+        --mParentedCount;
+
+    mParents[index] = parent;
+    MarkDirty(index);
+    if (parent != Null && parent > index)
+        mNeedsReorder = true;
+}
+
+void TransformHierarchy::Move(std::uint32_t index, const glm::vec3& pos)
+{
+    mPositions[index] += mRotations[index] * (mScales[index] * pos);
+    MarkDirty(index);
+}
+
+void TransformHierarchy::Rotate(std::uint32_t index, const glm::vec3& axis, float angle)
+{
+    mRotations[index] = glm::normalize(mRotations[index] * glm::angleAxis(angle, axis));
+    MarkDirty(index);
+}
+
+void TransformHierarchy::Scale(std::uint32_t index, const glm::vec3& scale)
+{
+    mScales[index] *= scale;
+    MarkDirty(index);
+}
+
+std::uint32_t TransformHierarchy::GetParent(std::uint32_t index) const
+{
+    return mParents[index];
+}
+
+std::uint32_t TransformHierarchy::GetOwner(std::uint32_t index) const
+{
+    return mOwners[index];
+}
+
+const glm::vec3& TransformHierarchy::GetPosition(std::uint32_t index) const
+{
+    return mPositions[index];
+}
+
+const glm::quat& TransformHierarchy::GetRotation(std::uint32_t index) const
+{
+    return mRotations[index];
+}
+
+const glm::vec3& TransformHierarchy::GetScale(std::uint32_t index) const
+{
+    return mScales[index];
+}
+
+bool TransformHierarchy::Update(JobSystem* jobs)
+{
+    PROFILE_SCOPE("TransformUpdate");
+    const bool reordered = mNeedsReorder;
+    if (mNeedsReorder)
+        Reorder();
+
+    // Transforms changed by the last update stop interpolating
+    for (std::uint32_t i : mChanged)
+        mPrevWorld[i] = mWorld[i];
+    mChanged.clear();
+
+    if (mDirtyList.empty())
+        return reordered;
+
+    if (mParentedCount == 0)
+    {
+        // Without parents only the modified transforms change
+        std::sort(std::begin(mDirtyList), std::end(mDirtyList));
+        mChanged.swap(mDirtyList);
+    }
+    else
+    {
+        // Propagate the dirty flags down the hierarchy, parents precede their children
+        const std::size_t count = mParents.size();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const std::uint32_t parent = mParents[i];
+            if (!mDirty[i] && parent != Null && mDirty[parent])
+                mDirty[i] = 1;
+            if (mDirty[i])
+                mChanged.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    mDirtyList.clear();
+
+    // Local matrices do not depend on each other, so they are computed in parallel.
+    // Roots are done at this point, children are composed with their parents below
+    ParallelFor(jobs, mChanged.size(), 1024,
+        [this](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t k = begin; k < end; ++k)
+            {
+                const std::uint32_t i = mChanged[k];
+                mPrevWorld[i] = mWorld[i];
+                mWorld[i] = LocalMatrix(i);
+                mDirty[i] = 0;
+                if (mParents[i] == Null)
+                    Settle(i);
+            }
+        }
+    );
+
+    // Parents precede their children, so their world matrices are always ready
+    if (mParentedCount != 0)
+    {
+        for (std::uint32_t i : mChanged)
+        {
+            const std::uint32_t parent = mParents[i];
+            if (parent == Null)
+                continue;
+            mWorld[i] = mWorld[parent] * mWorld[i];
+            Settle(i);
+        }
+    }
+
+    return reordered;
+}
+
+const std::vector<std::uint32_t>& TransformHierarchy::GetChanged() const
+{
+    return mChanged;
+}
+
+const std::vector<glm::mat4>& TransformHierarchy::GetWorld() const
+{
+    return mWorld;
+}
+
+const std::vector<glm::mat4>& TransformHierarchy::GetPreviousWorld() const
+{
+    return mPrevWorld;
+}
+
+WorldTransforms TransformHierarchy::GetWorldTransforms() const
+{
+    WorldTransforms rVal;
+    rVal.current  = mWorld.data();
+    rVal.previous = mPrevWorld.data();
+    return rVal;
+}
+
+glm::mat4 TransformHierarchy::ComputeWorld(std::uint32_t index) const
+{
+    glm::mat4 world = LocalMatrix(index);
+    for (std::uint32_t p = mParents[index]; p != Null; p = mParents[p])
+        world = LocalMatrix(p) * world;
+    return world;
+}
+
+std::size_t TransformHierarchy::Size() const
+{
+    return mParents.size();
+}
+
+std::uint32_t TransformHierarchy::GetOrderVersion() const
+{
+    return mOrderVersion;
+}
+
+//--------------------------------------------------
+// Private functions
+//--------------------------------------------------
+glm::mat4 TransformHierarchy::LocalMatrix(std::uint32_t index) const
+{
+    // Translation x Rotation x Scale
+    glm::mat4 local = glm::mat4_cast(mRotations[index]);
+    local[0] *= mScales[index].x;
+    local[1] *= mScales[index].y;
+    local[2] *= mScales[index].z;
+    local[3] = glm::vec4(mPositions[index], 1.0f);
+    return local;
+}
+
+void TransformHierarchy::Reorder()
+{
+    const std::uint32_t count = static_cast<std::uint32_t>(mParents.size());
+
+    // Find the depth of every live transform, reusing the depths found along each parent chain
+    std::vector<std::uint32_t> depths(count, Null);
+    std::vector<std::uint32_t> chain;
+    std::uint32_t maxDepth = 0;
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        if (mOwners[i] == Null || depths[i] != Null)
+            continue;
+
+        std::uint32_t cur = i;
+        while (cur != Null && depths[cur] == Null)
+        {
+            chain.push_back(cur);
+            cur = mParents[cur];
+        }
+
+        std::uint32_t depth = (cur == Null) ? 0 : depths[cur] + 1;
+        while (!chain.empty())
+        {
+            depths[chain.back()] = depth++;
+            chain.pop_back();
+        }
+        maxDepth = std::max(maxDepth, depth);
+    }
+
+    // Stable counting sort by depth, which keeps the current order within each level
+    std::vector<std::uint32_t> offsets(maxDepth + 1, 0);
+    for (std::uint32_t i = 0; i < count; ++i)
+        if (mOwners[i] != Null)
+            ++offsets[depths[i] + 1];
+    for (std::size_t d = 1; d < offsets.size(); ++d)
+        offsets[d] += offsets[d - 1];
+
+    std::vector<std::uint32_t> remap(count, Null);
+    std::vector<std::uint32_t> order(offsets.back());
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        if (mOwners[i] == Null)
+            continue;
+        const std::uint32_t slot = offsets[depths[i]]++;
+        remap[i] = slot;
+        order[slot] = i;
+    }
+
+    // Gather every array in the new order
+    auto permute = [&order](auto& values)
+    {
+        typename std::decay<decltype(values)>::type sorted;
+        sorted.reserve(order.size());
+        for (std::uint32_t from : order)
+            sorted.push_back(values[from]);
+        values.swap(sorted);
+    };
+    permute(mParents);
+    permute(mOwners);
+    permute(mPositions);
+    permute(mRotations);
+    permute(mScales);
+    permute(mWorld);
+    permute(mPrevWorld);
+    permute(mFresh);
+    permute(mDirty);
+
+    for (auto& parent : mParents)
+        if (parent != Null)
+            parent = remap[parent];
+
+    // Carry the modified and the last changed transforms over to their new indices
+    mDirtyList.clear();
+    for (std::uint32_t i = 0; i < mDirty.size(); ++i)
+        if (mDirty[i])
+            mDirtyList.push_back(i);
+
+    std::vector<std::uint32_t> changed;
+    for (std::uint32_t i : mChanged)
+        if (remap[i] != Null)
+            changed.push_back(remap[i]);
+    std::sort(std::begin(changed), std::end(changed));
+    mChanged.swap(changed);
+
+    mNeedsReorder = false;
+    ++mOrderVersion;
+}
+
+void TransformHierarchy::Settle(std::uint32_t index)
+{
+    // Transforms added since the last update have no history to interpolate from
+    if (mFresh[index])
+    {
+        mPrevWorld[index] = mWorld[index];
+        mFresh[index] = 0;
+    }
+}
+
+void TransformHierarchy::MarkDirty(std::uint32_t index)
+{
+    if (!mDirty[index])
+    {
+        mDirty[index] = 1;
+        mDirtyList.push_back(index);
+    }
+}
@@ -0,0 +1,152 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _TRANSFORM_HIERARCHY_HPP_
+#define _TRANSFORM_HIERARCHY_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "../../Util/WarnGuard.hpp"
+WARN_GUARD_ON
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+WARN_GUARD_OFF
+
+class JobSystem;
+
+// Non owning view of the world matrices of the current and the previous tick
+struct WorldTransforms
+{
+    const glm::mat4* current  = nullptr;
+    const glm::mat4* previous = nullptr;
+
+    // Interpolates between the previous and the current world matrix of the given transform
+    glm::mat4 Interpolated(std::uint32_t index, float interpolation) const
+    {
+        return previous[index] + (current[index] - previous[index]) * interpolation;
+    }
+};
+
+// Local translation / rotation / scale of every transform stored as structure of arrays.
+// Transforms are kept sorted parent before child, so that a single linear pass
+// computes all world matrices as parent world x local. Only transforms modified since
+// the last update, and their descendants, get recomputed.
+class TransformHierarchy
+{
+    public:
+        static const std::uint32_t Null = 0xFFFFFFFF;
+
+        // Constructor
+        TransformHierarchy();
+
+        // Adds a root transform with identity local state, returns its index.
+        // The owner tag is kept along to find the owner of an index after a reorder.
+        std::uint32_t Add(std::uint32_t owner);
+
+        // Removes a transform, its slot is compacted away on the next update
+        void Remove(std::uint32_t index);
+
+        // Sets the parent of a transform (Null makes it a root). Ignored if it would create a cycle
+        void SetParent(std::uint32_t index, std::uint32_t parent);
+
+        // Moves relatively to the current position, along the local axes
+        void Move(std::uint32_t index, const glm::vec3& pos);
+
+        // Rotates relatively to the current rotation, around the given local axis
+        void Rotate(std::uint32_t index, const glm::vec3& axis, float angle);
+
+        // Scales relatively to the current scale
+        void Scale(std::uint32_t index, const glm::vec3& scale);
+
+        // Local state getters
+        std::uint32_t GetParent(std::uint32_t index) const;
+        std::uint32_t GetOwner(std::uint32_t index) const;
+        const glm::vec3& GetPosition(std::uint32_t index) const;
+        const glm::quat& GetRotation(std::uint32_t index) const;
+        const glm::vec3& GetScale(std::uint32_t index) const;
+
+        // Recomputes the world matrices of the modified transforms and their descendants,
+        // keeping their current world matrices as the previous ones.
+        // Local matrices are computed in parallel on the given job system, if any.
+        // Returns true when the transforms were reordered, in which case owners must refresh their indices
+        bool Update(JobSystem* jobs = nullptr);
+
+        // Indices of the transforms whose world matrix changed in the last update, in ascending order
+        const std::vector<std::uint32_t>& GetChanged() const;
+
+        // World matrices computed by the last update, contiguous and ready to be uploaded
+        const std::vector<glm::mat4>& GetWorld() const;
+
+        // World matrices of the update before the last one
+        const std::vector<glm::mat4>& GetPreviousWorld() const;
+
+        // View over the world matrices for interpolation, valid until the next update or addition
+        WorldTransforms GetWorldTransforms() const;
+
+        // Composes the world matrix of a transform from its current local state, walking its parent chain
+        glm::mat4 ComputeWorld(std::uint32_t index) const;
+
+        // Number of slots, including removed ones not yet compacted
+        std::size_t Size() const;
+
+        // Counter bumped every time the transforms get reordered
+        std::uint32_t GetOrderVersion() const;
+
+    private:
+        std::vector<std::uint32_t> mParents;   // Parent index, always less than the child's
+        std::vector<std::uint32_t> mOwners;    // Owner tag, Null for removed transforms
+        std::vector<glm::vec3>     mPositions; // Local translations
+        std::vector<glm::quat>     mRotations; // Local rotations
+        std::vector<glm::vec3>     mScales;    // Local scales
+        std::vector<glm::mat4>     mWorld;     // World matrices of the last update
+        std::vector<glm::mat4>     mPrevWorld; // World matrices of the update before
+        std::vector<std::uint8_t>  mFresh;     // Transforms added since the last update
+        std::vector<std::uint8_t>  mDirty;     // Transforms modified since the last update
+        std::vector<std::uint32_t> mDirtyList; // Indices of the modified transforms
+        std::vector<std::uint32_t> mChanged;   // Indices of the transforms changed by the last update
+        std::uint32_t mParentedCount;          // Number of transforms that have a parent
+        bool mNeedsReorder;                    // Set by removals and parents placed after their children
+        std::uint32_t mOrderVersion;           // Number of reorders so far
+
+        // Flags a transform for recomputation in the next update
+        void MarkDirty(std::uint32_t index);
+
+        // Builds the local matrix of a transform
+        glm::mat4 LocalMatrix(std::uint32_t index) const;
+
+        // Called once the world matrix of a transform is final
+        void Settle(std::uint32_t index);
+
+        // Drops removed transforms and restores the parent before child order
+        void Reorder();
+};
+
+#endif // ! _TRANSFORM_HIERARCHY_HPP_
@@ -1,6 +1,15 @@
 #include "Shader.hpp"
 #include <stdexcept>
+#include <vector>
 #include "../Util/GLUtils.hpp"
+#include "../Renderer/RenderStats.hpp"
+
+WARN_GUARD_ON
+#include <glm/gtc/type_ptr.hpp>
+WARN_GUARD_OFF
+
+// Total glGetUniformLocation calls made by all programs
+static std::uint64_t sUniformQueryCount = 0;
 
 Shader::Shader(const std::string& source, Type type)
 {
@@ -60,6 +69,9 @@ ShaderProgram::ShaderProgram(GLuint vertShId, GLuint fragShId)
         glDeleteProgram(mId);
         throw std::runtime_error(err);
     }
+
+    // Cache the active uniforms
+    Reflect();
 }
 
 ShaderProgram::ShaderProgram(GLuint vertShId, GLuint geomShId, GLuint fragShId)
@@ -78,17 +90,24 @@ ShaderProgram::ShaderProgram(GLuint vertShId, GLuint geomShId, GLuint fragShId)
         glDeleteProgram(mId);
         throw std::runtime_error(err);
     }
+
+    // Cache the active uniforms
+    Reflect();
 }
 
 ShaderProgram::ShaderProgram(ShaderProgram&& other)
 {
     this->mId = other.mId;
+    this->mUniforms = std::move(other.mUniforms);
+    this->mUniformBlocks = std::move(other.mUniformBlocks);
     other.mId = 0;
 }
 
 ShaderProgram& ShaderProgram::operator=(ShaderProgram&& other)
 {
     this->mId = other.mId;
+    this->mUniforms = std::move(other.mUniforms);
+    this->mUniformBlocks = std::move(other.mUniformBlocks);
     other.mId = 0;
     return *this;
 }
@@ -103,3 +122,134 @@ GLuint ShaderProgram::Id() const
 {
     return mId;
 }
+
+GLint ShaderProgram::GetUniformLocation(const std::string& name) const
+{
+    auto it = mUniforms.find(name);
+    return it != std::end(mUniforms) ? it->second : -1;
+}
+
+GLuint ShaderProgram::GetUniformBlockIndex(const std::string& name) const
+{
+    auto it = mUniformBlocks.find(name);
+    return it != std::end(mUniformBlocks) ? it->second : GL_INVALID_INDEX;
+}
+
+std::uint64_t ShaderProgram::GetUniformQueryCount()
+{
+    return sUniformQueryCount;
+}
+
+void ShaderProgram::Reflect()
+{
+    mUniforms.clear();
+    mUniformBlocks.clear();
+
+    // Active uniforms
+    GLint numUniforms = 0, maxNameLength = 0;
+    glGetProgramiv(mId, GL_ACTIVE_UNIFORMS, &numUniforms);
+    glGetProgramiv(mId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+    std::vector<GLchar> nameBuf(maxNameLength + 1);
+    for (GLint i = 0; i < numUniforms; ++i)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(mId, i, static_cast<GLsizei>(nameBuf.size()), &length, &size, &type, nameBuf.data());
+        std::string name(nameBuf.data(), length);
+
+        // Uniform block members have no location
+        GLint location = glGetUniformLocation(mId, name.c_str());
+        ++sUniformQueryCount;
+        if (location == -1)
+            continue;
+        mUniforms[name] = location;
+
+        // Arrays are reported by their first element, make them reachable by their plain name too
+        const std::string arraySuffix = "[0]";
+        if (name.size() > arraySuffix.size()
+         && name.compare(name.size() - arraySuffix.size(), arraySuffix.size(), arraySuffix) == 0)
+            mUniforms[name.substr(0, name.size() - arraySuffix.size())] = location;
+    }
+
+    // Active uniform blocks
+    GLint numBlocks = 0, maxBlockNameLength = 0;
+    glGetProgramiv(mId, GL_ACTIVE_UNIFORM_BLOCKS, &numBlocks);
+    glGetProgramiv(mId, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxBlockNameLength);
+    nameBuf.resize(maxBlockNameLength + 1);
+    for (GLint i = 0; i < numBlocks; ++i)
+    {
+        GLsizei length = 0;
+        glGetActiveUniformBlockName(mId, i, static_cast<GLsizei>(nameBuf.size()), &length, nameBuf.data());
+        mUniformBlocks[std::string(nameBuf.data(), length)] = i;
+    }
+}
+
+//--------------------------------------------------
+// Uniform setters
+//--------------------------------------------------
+template <> void Uniform<GLint>::Set(const GLint& value) const
+{
+    glUniform1i(mLocation, value);
+    RenderStats().CountUniformUpload();
+}
+
+template <> void Uniform<GLuint>::Set(const GLuint& value) const
+{
+    glUniform1ui(mLocation, value);
+    RenderStats().CountUniformUpload();
+}
+
+template <> void Uniform<GLfloat>::Set(const GLfloat& value) const
+{
+    glUniform1f(mLocation, value);
+    RenderStats().CountUniformUpload();
+}
+
+template <> void Uniform<GLfloat>::Set(const GLfloat* values, GLsizei count) const
+{
+    glUniform1fv(mLocation, count, values);
+    RenderStats().CountUniformUpload();
+}
+
+template <> void Uniform<glm::ivec2>::Set(const glm::ivec2& value) const
+{
+    glUniform2i(mLocation, value.x, value.y);
+    RenderStats().CountUniformUpload();
+}
+
+template <> void Uniform<glm::ivec3>::Set(const glm::ivec3& value) const
+{
+    glUniform3i(mLocation, value.x, value.y, value.z);
+    RenderStats().CountUniformUpload();
+}
+
+template <> void Uniform<glm::vec2>::Set(const glm::vec2& value) const
+{
+    glUniform2f(mLocation, value.x, value.y);
+    RenderStats().CountUniformUpload();
+}
+
+template <> void Uniform<glm::vec2>::Set(const glm::vec2* values, GLsizei count) const
+{
+    glUniform2fv(mLocation, count, glm::value_ptr(*values));
+    RenderStats().CountUniformUpload();
+}
+
+template <> void Uniform<glm::vec3>::Set(const glm::vec3& value) const
+{
+    glUniform3fv(mLocation, 1, glm::value_ptr(value));
+    RenderStats().CountUniformUpload();
+}
+
+template <> void Uniform<glm::mat4>::Set(const glm::mat4& value) const
+{
+    glUniformMatrix4fv(mLocation, 1, GL_FALSE, glm::value_ptr(value));
+    RenderStats().CountUniformUpload();
+}
+
+template <> void Uniform<glm::mat4>::Set(const glm::mat4* values, GLsizei count) const
+{
+    glUniformMatrix4fv(mLocation, count, GL_FALSE, glm::value_ptr(*values));
+    RenderStats().CountUniformUpload();
+}
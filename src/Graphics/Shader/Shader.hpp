@@ -31,9 +31,16 @@
 #ifndef _SHADER_HPP_
 #define _SHADER_HPP_
 
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <glad/glad.h>
 
+#include "../../Util/WarnGuard.hpp"
+WARN_GUARD_ON
+#include <glm/glm.hpp>
+WARN_GUARD_OFF
+
 class Shader
 {
     public:
@@ -66,6 +73,40 @@ class Shader
         GLuint mId;
 };
 
+// Pre-resolved typed handle to a program uniform
+template <typename T>
+class Uniform
+{
+    public:
+        // Constructors
+        Uniform() : mLocation(-1) {}
+        explicit Uniform(GLint location) : mLocation(location) {}
+
+        // Retrieves the uniform location
+        GLint Location() const { return mLocation; }
+
+        // Sets the uniform value on the currently bound program
+        void Set(const T& value) const;
+
+        // Sets count consecutive values of an uniform array on the currently bound program
+        void Set(const T* values, GLsizei count) const;
+
+    private:
+        GLint mLocation;
+};
+
+template <> void Uniform<GLint>::Set(const GLint& value) const;
+template <> void Uniform<GLuint>::Set(const GLuint& value) const;
+template <> void Uniform<GLfloat>::Set(const GLfloat& value) const;
+template <> void Uniform<GLfloat>::Set(const GLfloat* values, GLsizei count) const;
+template <> void Uniform<glm::ivec2>::Set(const glm::ivec2& value) const;
+template <> void Uniform<glm::ivec3>::Set(const glm::ivec3& value) const;
+template <> void Uniform<glm::vec2>::Set(const glm::vec2& value) const;
+template <> void Uniform<glm::vec2>::Set(const glm::vec2* values, GLsizei count) const;
+template <> void Uniform<glm::vec3>::Set(const glm::vec3& value) const;
+template <> void Uniform<glm::mat4>::Set(const glm::mat4& value) const;
+template <> void Uniform<glm::mat4>::Set(const glm::mat4* values, GLsizei count) const;
+
 class ShaderProgram
 {
     public:
@@ -87,8 +128,28 @@ class ShaderProgram
         // Retrieves internal id
         GLuint Id() const;
 
+        // Retrieves the location of the given active uniform, or -1 if it is not active
+        GLint GetUniformLocation(const std::string& name) const;
+
+        // Retrieves the index of the given active uniform block, or GL_INVALID_INDEX if it is not active
+        GLuint GetUniformBlockIndex(const std::string& name) const;
+
+        // Retrieves a typed handle to the given uniform
+        template <typename T>
+        Uniform<T> GetUniform(const std::string& name) const { return Uniform<T>(GetUniformLocation(name)); }
+
+        // Retrieves the total number of glGetUniformLocation calls made by all programs
+        static std::uint64_t GetUniformQueryCount();
+
     private:
         GLuint mId;
+
+        // Active uniform locations and uniform block indexes, reflected after link
+        std::unordered_map<std::string, GLint> mUniforms;
+        std::unordered_map<std::string, GLuint> mUniformBlocks;
+
+        // Reflects all the active uniforms and uniform blocks of the linked program
+        void Reflect();
 };
 
 #endif // ! _SHADER_HPP_
@@ -224,3 +224,31 @@ auto ShaderPreprocessor::Preprocess(const std::string& source, const std::vector
     std::string output = PreprocessModules(source, deps, loadedModules);
     return PreprocessSource(output, loadedModules);
 }
+
+auto ShaderPreprocessor::InjectDefines(const std::string& source, const std::vector<std::string>& defines) -> std::string
+{
+    if (defines.empty())
+        return source;
+
+    std::string defineLines;
+    for (const auto& define : defines)
+        defineLines += "#define " + define + "\n";
+
+    // The version directive must come first, so the defines follow it when present
+    const std::string versionPragma = "#version";
+    std::size_t pos = 0;
+    if (source.compare(0, versionPragma.size(), versionPragma) == 0)
+    {
+        pos = source.find('\n');
+        pos = (pos == std::string::npos) ? source.size() : pos + 1;
+    }
+
+    std::string result(source);
+    if (pos == result.size() && !result.empty() && result.back() != '\n')
+    {
+        result += '\n';
+        ++pos;
+    }
+    result.insert(pos, defineLines);
+    return result;
+}
@@ -38,6 +38,9 @@ class ShaderPreprocessor
 {
     public:
         std::string Preprocess(const std::string& source, const std::vector<std::string>& dependencies);
+
+        // Inserts a define directive for each of the given names after the version directive of the source
+        std::string InjectDefines(const std::string& source, const std::vector<std::string>& defines);
 };
 
 #endif // ! _SHADER_PREPROCESSOR_HPP_
@@ -0,0 +1,47 @@
+#include "ShaderVariants.hpp"
+#include "ShaderPreprocessor.hpp"
+
+ShaderVariants::ShaderVariants(std::string vertSource, std::string fragSource,
+                               std::vector<std::string> featureDefines, std::vector<std::string> commonDefines)
+    : mVertSource(std::move(vertSource))
+    , mFragSource(std::move(fragSource))
+    , mFeatureDefines(std::move(featureDefines))
+    , mCommonDefines(std::move(commonDefines))
+{
+}
+
+const ShaderProgram& ShaderVariants::Get(Key key)
+{
+    auto it = mPrograms.find(key);
+    if (it == std::end(mPrograms))
+        it = mPrograms.emplace(key, Build(key)).first;
+    return it->second;
+}
+
+void ShaderVariants::Warm(const std::vector<Key>& keys)
+{
+    for (Key key : keys)
+        Get(key);
+}
+
+std::size_t ShaderVariants::Size() const
+{
+    return mPrograms.size();
+}
+
+//--------------------------------------------------
+// Private functions
+//--------------------------------------------------
+ShaderProgram ShaderVariants::Build(Key key) const
+{
+    // Gather the defines of the key's features
+    std::vector<std::string> defines = mCommonDefines;
+    for (std::size_t bit = 0; bit < mFeatureDefines.size(); ++bit)
+        if (key & (Key(1) << bit))
+            defines.push_back(mFeatureDefines[bit]);
+
+    ShaderPreprocessor preprocessor;
+    Shader vert(preprocessor.InjectDefines(mVertSource, defines), Shader::Type::Vertex);
+    Shader frag(preprocessor.InjectDefines(mFragSource, defines), Shader::Type::Fragment);
+    return ShaderProgram(vert.Id(), frag.Id());
+}
@@ -0,0 +1,77 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _SHADER_VARIANTS_HPP_
+#define _SHADER_VARIANTS_HPP_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Shader.hpp"
+
+// Builds the variants of a shader program, each compiled with the defines of the feature bits in its key,
+// so that features are selected at compile time instead of branching on uniforms
+class ShaderVariants
+{
+    public:
+        // Feature bitmask identifying a variant
+        using Key = std::uint32_t;
+
+        // Constructor, takes the preprocessed stage sources, the define of each feature bit in bit order,
+        // and the defines all variants are compiled with
+        ShaderVariants(std::string vertSource, std::string fragSource,
+                       std::vector<std::string> featureDefines, std::vector<std::string> commonDefines);
+
+        // Retrieves the program of the given key, compiling it on first use.
+        // Throws std::runtime_error if it fails to compile or link
+        const ShaderProgram& Get(Key key);
+
+        // Compiles the given variants ahead of their first use
+        void Warm(const std::vector<Key>& keys);
+
+        // Retrieves the number of variants compiled so far
+        std::size_t Size() const;
+
+    private:
+        // Compiles and links the given variant
+        ShaderProgram Build(Key key) const;
+
+        // Preprocessed sources
+        std::string mVertSource, mFragSource;
+
+        // Defines of the feature bits and of all the variants
+        std::vector<std::string> mFeatureDefines, mCommonDefines;
+
+        // The compiled variants
+        std::unordered_map<Key, ShaderProgram> mPrograms;
+};
+
+#endif // ! _SHADER_VARIANTS_HPP_
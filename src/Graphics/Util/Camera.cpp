@@ -48,7 +48,7 @@ const glm::mat4& Camera::View()
     return mCurView;
 }
 
-glm::mat4 Camera::InterpolatedView(float interpolation)
+glm::mat4 Camera::InterpolatedView(float interpolation) const
 {
     return mPrevView + (mCurView - mPrevView) * interpolation;
 }
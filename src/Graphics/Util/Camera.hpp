@@ -97,7 +97,7 @@ class Camera
         const glm::mat4& View();
 
         /// Retrieves the camera view matrix interpolated
-        glm::mat4 InterpolatedView(float interpolation);
+        glm::mat4 InterpolatedView(float interpolation) const;
 
         /// Retrieves an interpolated copy of the camera state
         CameraState Interpolate(std::vector<MoveDirection> md, std::tuple<float, float> lookOffset, float interpolation);
@@ -29,37 +29,109 @@
 /*     '   '  `                                                                                                      */
 /*********************************************************************************************************************/
 #include <functional>
-#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
 #include "Core/HeartBeat.hpp"
+#include "Core/Profiler.hpp"
 #include "Window/GlfwContext.hpp"
 #include "Game/Game.hpp"
+#include "Game/Benchmark.hpp"
 #include "Util/MsgBox.hpp"
 
 int main(int argc, char* argv[])
 {
-    (void) argc;
-    (void) argv;
+    // Update on a dedicated simulation thread
+    bool threaded = false;
+    // Updates per second and render cap, zero leaves the renders uncapped
+    unsigned int tickRate = 25;
+    unsigned int maxFps = 0;
+    // Render offscreen, and exit after the given number of frames when non zero
+    bool headless = false;
+    unsigned long frames = 0;
+    // The first screen shown
+    std::string screen = "main";
+    // Measure the given number of frames of the first screen with scripted input, see Benchmark
+    bool bench = false;
+    Benchmark::Config benchConfig;
+    // The GBuffer layout, full or compact
+    GBuffer::Layout gbufferLayout = GBuffer::Layout::Full;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--threaded") == 0)
+            threaded = true;
+        else if (std::strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc)
+            tickRate = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--max-fps") == 0 && i + 1 < argc)
+            maxFps = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--headless") == 0)
+            headless = true;
+        else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--screen") == 0 && i + 1 < argc)
+            screen = argv[++i];
+        else if (std::strcmp(argv[i], "--gbuffer") == 0 && i + 1 < argc)
+            gbufferLayout = std::strcmp(argv[++i], "compact") == 0 ? GBuffer::Layout::Compact : GBuffer::Layout::Full;
+        else if (std::strcmp(argv[i], "--bench") == 0)
+            bench = true;
+        else if (std::strcmp(argv[i], "--bench-warmup") == 0 && i + 1 < argc)
+            benchConfig.warmupFrames = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--bench-seed") == 0 && i + 1 < argc)
+            benchConfig.seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--bench-path") == 0 && i + 1 < argc)
+            benchConfig.cameraPath = argv[++i];
+        else if (std::strcmp(argv[i], "--bench-out") == 0 && i + 1 < argc)
+            benchConfig.output = argv[++i];
+    }
+
+    Profiler::SetThreadName("Main");
 
     try
     {
         GlfwContext glfwContext;
         glfwContext.Init();
 
-        HeartBeat hb;
         Game game;
+        game.SetHeadless(headless);
+        game.SetGBufferLayout(gbufferLayout);
+        game.SetStartScreen(screen);
+
+        if (bench)
+        {
+            // Fixed ticks at the given rate, one per frame
+            benchConfig.screen = screen;
+            if (frames != 0)
+                benchConfig.frames = static_cast<unsigned int>(frames);
+            if (tickRate != 0)
+                benchConfig.dt = 1000.0f / static_cast<float>(tickRate);
 
-        hb.SetTimer([]
+            Benchmark benchmark(game, benchConfig);
+            game.SetExitHandler(std::bind(&Benchmark::Stop, &benchmark));
+            game.Init();
+            const bool written = benchmark.Run();
+            game.Shutdown();
+            glfwContext.Shutdown();
+            if (!written)
+                throw std::runtime_error("Couldn't write benchmark report (" + benchConfig.output + ")");
+            return 0;
+        }
+
+        HeartBeat hb;
+        hb.SetTickRate(tickRate);
+        hb.SetMaxFrameRate(maxFps);
+        hb.SetUpdate(std::bind(&Game::Update, &game, std::placeholders::_1));
+        unsigned long renderedFrames = 0;
+        hb.SetRender(
+            [&game, &hb, &renderedFrames, frames](float interpolation)
             {
-                return static_cast<double>(
-                    std::chrono::duration_cast<std::chrono::milliseconds>(
-                        std::chrono::system_clock::now().time_since_epoch()
-                    ).count()
-                );
+                game.Render(interpolation);
+                if (frames != 0 && ++renderedFrames >= frames)
+                    hb.SetRunning(false);
             }
         );
-        hb.SetUpdate(std::bind(&Game::Update, &game, std::placeholders::_1));
-        hb.SetRender(std::bind(&Game::Render, &game, std::placeholders::_1));
         game.SetExitHandler(std::bind(&HeartBeat::SetRunning, &hb, false));
+        hb.SetThreaded(threaded);
+        game.SetThreaded(threaded);
 
         game.Init();
         hb.Run();
@@ -70,6 +142,7 @@ int main(int argc, char* argv[])
     catch(std::exception& e)
     {
         MsgBox("Error", e.what()).Show();
+        return 1;
     }
 
     return 0;
@@ -0,0 +1,50 @@
+#include "AllocCounter.hpp"
+#include <cstdlib>
+#include <new>
+
+// Constant initialized, so operator new can count before the thread's dynamic initialization
+static thread_local std::uint64_t tAllocationCount = 0;
+
+// --------------------------------------------------
+// Global allocation function replacements
+// --------------------------------------------------
+void* operator new(std::size_t size)
+{
+    ++tAllocationCount;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+// --------------------------------------------------
+// Header implementations
+// --------------------------------------------------
+std::uint64_t GetThreadAllocationCount()
+{
+    return tAllocationCount;
+}
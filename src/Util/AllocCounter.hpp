@@ -28,18 +28,13 @@
 /*   ' ') '( (/                                                                                                      */
 /*     '   '  `                                                                                                      */
 /*********************************************************************************************************************/
-#ifndef _RENDER_UTILS_HPP_
-#define _RENDER_UTILS_HPP_
+#ifndef _ALLOC_COUNTER_HPP_
+#define _ALLOC_COUNTER_HPP_
 
-#include "../Scene/AABB.hpp"
+#include <cstdint>
 
-// Renders a 1x1 quad in NDC, used for framebuffer color targets
-void RenderQuad();
+// Retrieves the number of heap allocations the calling thread has made through the global operator new.
+// Counted per thread, so that a thread measuring itself is not disturbed by the simulation and job threads
+std::uint64_t GetThreadAllocationCount();
 
-// Renders a unit sphere
-void RenderSphere();
-
-// Renders a AABB in model space
-void RenderBox(const AABB& aabb);
-
-#endif // ! _RENDER_UTILS_HPP_
+#endif // ! _ALLOC_COUNTER_HPP_
@@ -0,0 +1,101 @@
+#include "RangeAllocator.hpp"
+#include <algorithm>
+#include <iterator>
+
+const std::size_t RangeAllocator::Invalid = ~std::size_t(0);
+
+RangeAllocator::RangeAllocator(std::size_t capacity)
+    : mCapacity(0)
+    , mUsed(0)
+{
+    Reset(capacity);
+}
+
+std::size_t RangeAllocator::Allocate(std::size_t size)
+{
+    if (size == 0)
+        return Invalid;
+
+    for (auto it = std::begin(mFree); it != std::end(mFree); ++it)
+    {
+        if (it->second < size)
+            continue;
+
+        // Carve the range from the start of the free one
+        const std::size_t offset = it->first;
+        const std::size_t rest = it->second - size;
+        mFree.erase(it);
+        if (rest != 0)
+            mFree.emplace(offset + size, rest);
+        mUsed += size;
+        return offset;
+    }
+    return Invalid;
+}
+
+void RangeAllocator::Free(std::size_t offset, std::size_t size)
+{
+    if (size == 0)
+        return;
+    mUsed -= size;
+
+    // Merge with the following free range
+    auto next = mFree.lower_bound(offset);
+    if (next != std::end(mFree) && offset + size == next->first)
+    {
+        size += next->second;
+        next = mFree.erase(next);
+    }
+
+    // Merge with the preceding free range
+    if (next != std::begin(mFree))
+    {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset)
+        {
+            prev->second += size;
+            return;
+        }
+    }
+    mFree.emplace_hint(next, offset, size);
+}
+
+void RangeAllocator::Grow(std::size_t capacity)
+{
+    if (capacity <= mCapacity)
+        return;
+
+    // Mark the new space as used and free it, merging it with a free range at the end
+    const std::size_t added = capacity - mCapacity;
+    const std::size_t offset = mCapacity;
+    mCapacity = capacity;
+    mUsed += added;
+    Free(offset, added);
+}
+
+void RangeAllocator::Reset(std::size_t capacity)
+{
+    mFree.clear();
+    mCapacity = capacity;
+    mUsed = 0;
+    if (capacity != 0)
+        mFree.emplace(0, capacity);
+}
+
+std::size_t RangeAllocator::GetCapacity() const
+{
+    return mCapacity;
+}
+
+std::size_t RangeAllocator::GetUsed() const
+{
+    return mUsed;
+}
+
+std::size_t RangeAllocator::GetLargestFree() const
+{
+    std::size_t largest = 0;
+    for (const auto& range : mFree)
+        largest = std::max(largest, range.second);
+    return largest;
+}
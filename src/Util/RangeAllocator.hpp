@@ -0,0 +1,72 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _RANGE_ALLOCATOR_HPP_
+#define _RANGE_ALLOCATOR_HPP_
+
+#include <cstddef>
+#include <map>
+
+// Hands out ranges of a linear space, like the elements of a large buffer, keeping its free ranges
+// sorted by offset so that freed neighbours merge back together
+class RangeAllocator
+{
+    public:
+        // Offset returned when there is no free range large enough
+        static const std::size_t Invalid;
+
+        // Constructor
+        explicit RangeAllocator(std::size_t capacity = 0);
+
+        // Takes the first free range that fits the given size, returns its offset or Invalid
+        std::size_t Allocate(std::size_t size);
+
+        // Returns an allocated range
+        void Free(std::size_t offset, std::size_t size);
+
+        // Appends free space to the end
+        void Grow(std::size_t capacity);
+
+        // Frees everything, resizing the space to the given capacity
+        void Reset(std::size_t capacity);
+
+        // Size of the space, of its allocated part and of its largest free range
+        std::size_t GetCapacity() const;
+        std::size_t GetUsed() const;
+        std::size_t GetLargestFree() const;
+
+    private:
+        // Free ranges, offset to size
+        std::map<std::size_t, std::size_t> mFree;
+        std::size_t mCapacity;
+        std::size_t mUsed;
+};
+
+#endif // ! _RANGE_ALLOCATOR_HPP_
@@ -0,0 +1,202 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _SLOT_MAP_HPP_
+#define _SLOT_MAP_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 32-bit generational handle, the low bits index a slot and the high bits hold the slot's generation
+using SlotHandle = std::uint32_t;
+
+// Handle that never refers to a live element
+const SlotHandle NullSlotHandle = 0xFFFFFFFF;
+
+// Container that addresses its elements by generational handles.
+// Elements live in fixed size pages, so they are laid out contiguously and never relocate:
+// pointers to an element stay valid until it is erased. Erased slots are recycled oldest first
+// with a bumped generation, so handles to the erased element are detected as stale. A slot whose
+// generation is exhausted is retired instead of wrapping around, so a stale handle never resolves.
+template <typename T>
+class SlotMap
+{
+    public:
+        static const std::uint32_t IndexBits = 22;
+        static const std::uint32_t IndexMask = (1u << IndexBits) - 1;
+        static const std::uint32_t GenerationMask = (1u << (32 - IndexBits)) - 1;
+        static const std::uint32_t PageSize = 1024;
+
+        template <typename Value>
+        class IteratorBase
+        {
+            public:
+                IteratorBase(const SlotMap* map, std::uint32_t index) : mMap(map), mIndex(index) { SkipDead(); }
+
+                Value& operator*() const { return *mMap->Slot(mIndex); }
+                Value* operator->() const { return mMap->Slot(mIndex); }
+                IteratorBase& operator++() { ++mIndex; SkipDead(); return *this; }
+                bool operator==(const IteratorBase& rhs) const { return mIndex == rhs.mIndex; }
+                bool operator!=(const IteratorBase& rhs) const { return mIndex != rhs.mIndex; }
+
+                // Handle of the element the iterator points to
+                SlotHandle GetHandle() const { return MakeHandle(mIndex, mMap->mGenerations[mIndex]); }
+
+            private:
+                const SlotMap* mMap;
+                std::uint32_t mIndex;
+
+                void SkipDead()
+                {
+                    while (mIndex < mMap->mAlive.size() && !mMap->mAlive[mIndex])
+                        ++mIndex;
+                }
+        };
+        using Iterator      = IteratorBase<T>;
+        using ConstIterator = IteratorBase<const T>;
+
+        SlotMap() : mSize(0) {}
+        ~SlotMap() { Clear(); }
+        SlotMap(const SlotMap&) = delete;
+        SlotMap& operator=(const SlotMap&) = delete;
+
+        // Constructs a new element in a free slot and returns its handle
+        template <typename... Args>
+        SlotHandle Emplace(Args&&... args)
+        {
+            std::uint32_t index;
+            if (!mFreeSlots.empty())
+            {
+                index = mFreeSlots.front();
+                mFreeSlots.pop_front();
+            }
+            else
+            {
+                index = static_cast<std::uint32_t>(mAlive.size());
+                if (index >= IndexMask)
+                    throw std::runtime_error("SlotMap: Out of slots");
+                if (index % PageSize == 0)
+                    mPages.emplace_back(new Storage[PageSize]);
+                mGenerations.push_back(0);
+                mAlive.push_back(0);
+            }
+
+            new (Slot(index)) T(std::forward<Args>(args)...);
+            mAlive[index] = 1;
+            ++mSize;
+            return MakeHandle(index, mGenerations[index]);
+        }
+
+        // Destroys the element of the given handle, returns false if the handle is stale
+        bool Erase(SlotHandle handle)
+        {
+            if (!Contains(handle))
+                return false;
+
+            const std::uint32_t index = handle & IndexMask;
+            Slot(index)->~T();
+            mAlive[index] = 0;
+            --mSize;
+
+            // Retire the slot rather than let its generation wrap
+            if (mGenerations[index] == GenerationMask)
+                return true;
+            ++mGenerations[index];
+            mFreeSlots.push_back(index);
+            return true;
+        }
+
+        // Destroys all the elements
+        void Clear()
+        {
+            for (std::uint32_t i = 0; i < mAlive.size(); ++i)
+                if (mAlive[i])
+                    Slot(i)->~T();
+            mPages.clear();
+            mGenerations.clear();
+            mAlive.clear();
+            mFreeSlots.clear();
+            mSize = 0;
+        }
+
+        // Checks if the given handle refers to a live element
+        bool Contains(SlotHandle handle) const
+        {
+            const std::uint32_t index = handle & IndexMask;
+            return index < mAlive.size()
+                && mAlive[index]
+                && mGenerations[index] == (handle >> IndexBits);
+        }
+
+        // Retrieves the element of the given handle, or nullptr if the handle is stale
+        T* Get(SlotHandle handle) { return Contains(handle) ? Slot(handle & IndexMask) : nullptr; }
+        const T* Get(SlotHandle handle) const { return Contains(handle) ? Slot(handle & IndexMask) : nullptr; }
+
+        // Number of live elements
+        std::size_t Size() const { return mSize; }
+
+        // Number of slots, live, free or retired
+        std::size_t Capacity() const { return mAlive.size(); }
+        bool Empty() const { return mSize == 0; }
+
+        // Iteration over the live elements in slot order
+        Iterator begin() { return Iterator(this, 0); }
+        Iterator end() { return Iterator(this, static_cast<std::uint32_t>(mAlive.size())); }
+        ConstIterator begin() const { return ConstIterator(this, 0); }
+        ConstIterator end() const { return ConstIterator(this, static_cast<std::uint32_t>(mAlive.size())); }
+
+    private:
+        using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+        std::vector<std::unique_ptr<Storage[]>> mPages;       // Element storage, PageSize slots each
+        std::vector<std::uint16_t>              mGenerations; // Current generation of every slot
+        std::vector<std::uint8_t>               mAlive;       // Whether every slot holds an element
+        std::deque<std::uint32_t>               mFreeSlots;   // Slots available for reuse, oldest first
+        std::size_t                             mSize;        // Number of live elements
+
+        static SlotHandle MakeHandle(std::uint32_t index, std::uint32_t generation)
+        {
+            return (generation << IndexBits) | index;
+        }
+
+        T* Slot(std::uint32_t index) const
+        {
+            return reinterpret_cast<T*>(&mPages[index / PageSize][index % PageSize]);
+        }
+};
+
+#endif // ! _SLOT_MAP_HPP_
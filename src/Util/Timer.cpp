@@ -3,15 +3,13 @@
 #if defined(_WIN32) || defined(_WIN64)
 #include <windows.h>
 #else
+#include <time.h>
 #endif
 
 // --------------------------------------------------
 // Helpers
 // --------------------------------------------------
-// Retrieves current time with high resolution
-static long long GetTimeNow();
-
-// OS specific implementations of GetTimeNow()
+// OS specific implementations of MonotonicTimeNs()
 #if defined(_WIN32) || defined(_WIN64)
 static long long WinGetTimeNow();
 #else
@@ -21,19 +19,28 @@ static long long UnixGetTimeNow();
 // --------------------------------------------------
 // Header implementations
 // --------------------------------------------------
+long long MonotonicTimeNs()
+{
+#if defined(_WIN32) || defined(_WIN64)
+    return WinGetTimeNow();
+#else
+    return UnixGetTimeNow();
+#endif
+}
+
 Timer::Timer() : mStartTime(0), mStarted(false)
 {
 }
 
 void Timer::Start()
 {
-    mStartTime = GetTimeNow();
+    mStartTime = MonotonicTimeNs();
     mStarted = true;
 }
 
 long long Timer::Now()
 {
-    return (mStarted) ? static_cast<long long>(GetTimeNow() - mStartTime) : 0;
+    return (mStarted) ? (MonotonicTimeNs() - mStartTime) / 1000 : 0;
 }
 
 long long Timer::Stop()
@@ -52,30 +59,33 @@ long long Timer::Stop()
 // --------------------------------------------------
 // Helpers
 // --------------------------------------------------
-static long long GetTimeNow()
-{
-#if defined(_WIN32) || defined(_WIN64)
-    return WinGetTimeNow();
-#else
-    return UnixGetTimeNow();
-#endif
-}
-
 #if defined(_WIN32) || defined(_WIN64)
 static long long WinGetTimeNow()
 {
-    LARGE_INTEGER time, frequency;
-    QueryPerformanceFrequency(&frequency);
+    static const long long frequency = []()
+    {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return f.QuadPart;
+    }();
+
+    LARGE_INTEGER time;
     QueryPerformanceCounter(&time);
 
-    long long usec = time.QuadPart * 1000000;
-    usec /= frequency.QuadPart;
-    return usec;
+    // Split the conversion so that the multiplication does not overflow
+    const long long seconds = time.QuadPart / frequency;
+    const long long remainder = time.QuadPart % frequency;
+    return seconds * 1000000000LL + remainder * 1000000000LL / frequency;
 }
 #else
 static long long UnixGetTimeNow()
 {
-    // TODO: Implement unix function to retrieve high resolution time
-    return 0;
+    // The raw clock is not slewed by NTP, fall back to the slewed one where it is missing
+    timespec ts;
+#if defined(CLOCK_MONOTONIC_RAW)
+    if (clock_gettime(CLOCK_MONOTONIC_RAW, &ts) != 0)
+#endif
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<long long>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
 }
 #endif
@@ -31,6 +31,9 @@
 #ifndef _TIMER_HPP_
 #define _TIMER_HPP_
 
+// Retrieves the time of a monotonic clock in nsec, unaffected by system clock adjustments
+long long MonotonicTimeNs();
+
 class Timer
 {
     public:
@@ -0,0 +1,82 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _TRIPLE_BUFFER_HPP_
+#define _TRIPLE_BUFFER_HPP_
+
+#include <atomic>
+
+// Lock free hand-off of values from one writer thread to one reader thread.
+// The writer fills its buffer and publishes it, the reader acquires the most recently published one.
+// Neither side ever waits for the other: the third buffer sits between them and is swapped atomically.
+template <typename T>
+class TripleBuffer
+{
+    public:
+        TripleBuffer() : mMiddle(1), mWrite(0), mRead(2) {}
+
+        // The buffer the writer fills, holds stale data from an older publish
+        T& Write() { return mBuffers[mWrite]; }
+
+        // Hands the written buffer over to the reader
+        void Publish()
+        {
+            const unsigned int prev = mMiddle.exchange(mWrite | FreshBit, std::memory_order_acq_rel);
+            mWrite = prev & IndexMask;
+        }
+
+        // Takes the most recently published buffer, returns false and keeps the current one if nothing new was published
+        bool Acquire()
+        {
+            if ((mMiddle.load(std::memory_order_relaxed) & FreshBit) == 0)
+                return false;
+            const unsigned int prev = mMiddle.exchange(mRead, std::memory_order_acq_rel);
+            mRead = prev & IndexMask;
+            return true;
+        }
+
+        // The buffer the reader holds
+        const T& Read() const { return mBuffers[mRead]; }
+
+    private:
+        static const unsigned int IndexMask = 0x3;
+        static const unsigned int FreshBit  = 0x4;
+
+        T mBuffers[3];
+
+        // Index of the buffer in between, flagged when it holds an unread publish
+        std::atomic<unsigned int> mMiddle;
+
+        // Owned by the writer and the reader respectively
+        unsigned int mWrite;
+        unsigned int mRead;
+};
+
+#endif // ! _TRIPLE_BUFFER_HPP_
@@ -8,6 +8,13 @@
 Window::Window() :
     mWindow(0),
     mTitle(""),
+    mMode(Mode::Windowed),
+    mOffscreenFbo(0),
+    mOffscreenColor(0),
+    mOffscreenDepth(0),
+    mInputScripted(false),
+    mPolledCursorX(0),
+    mPolledCursorY(0),
     mCursorX(0),
     mCursorY(0),
     mPrevCursorX(0),
@@ -60,6 +67,12 @@ bool Window::Create(int width, int height, const std::string& title, Mode mode)
             mon = glfwGetPrimaryMonitor();
             break;
         }
+        case Mode::Headless:
+        {
+            mon = 0;
+            glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+            break;
+        }
     }
 
     // Create the window
@@ -67,8 +80,9 @@ bool Window::Create(int width, int height, const std::string& title, Mode mode)
     if(!mWindow)
         return false;
 
-    // Store the given title
+    // Store the given title and mode
     mTitle = title;
+    mMode = mode;
 
     // Set it as the current opengl context
     glfwMakeContextCurrent(mWindow);
@@ -82,12 +96,39 @@ bool Window::Create(int width, int height, const std::string& title, Mode mode)
     // Load OpenGL extensions
     gladLoadGLLoader((GLADloadproc) glfwGetProcAddress);
 
+    // The contents of an invisible window are undefined, so render to a framebuffer of our own
+    if (mMode == Mode::Headless)
+    {
+        int fbWidth, fbHeight;
+        glfwGetFramebufferSize(mWindow, &fbWidth, &fbHeight);
+        glGenFramebuffers(1, &mOffscreenFbo);
+        glGenRenderbuffers(1, &mOffscreenColor);
+        glGenRenderbuffers(1, &mOffscreenDepth);
+        ResizeOffscreenTarget(fbWidth, fbHeight);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, mOffscreenFbo);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, mOffscreenColor);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, mOffscreenDepth);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            Destroy();
+            return false;
+        }
+    }
+
     // Window creation success
     return true;
 }
 
 void Window::Destroy()
 {
+    if (mOffscreenFbo != 0)
+    {
+        glDeleteFramebuffers(1, &mOffscreenFbo);
+        glDeleteRenderbuffers(1, &mOffscreenColor);
+        glDeleteRenderbuffers(1, &mOffscreenDepth);
+        mOffscreenFbo = mOffscreenColor = mOffscreenDepth = 0;
+    }
     glfwDestroyWindow(mWindow);
     mWindow = 0;
 }
@@ -155,6 +196,8 @@ void Window::SetFramebufferResizeHandler(ResizeCb cb)
     GLFWwindowsizefun f = [](GLFWwindow* w, int width, int height)
     {
         Window* wnd = static_cast<Window*>(glfwGetWindowUserPointer(w));
+        if (wnd->mMode == Mode::Headless)
+            wnd->ResizeOffscreenTarget(width, height);
         wnd->GetFramebufferResizeHandler()(width, height);
     };
     glfwSetFramebufferSizeCallback(mWindow, f);
@@ -266,7 +309,8 @@ void Window::SetKeyPressedHandler(KeyPressedCb cb)
                 return;
         }
         // Set key state
-        wnd->mKeyState[k] = ka;
+        if (!wnd->mInputScripted)
+            wnd->mKeyState[k] = ka;
 
         // Call actual callback
         wnd->GetKeyPressedHandler()(k, ka);
@@ -321,7 +365,8 @@ void Window::SetMouseGrabEnabled(bool on)
 
 bool Window::MouseGrabEnabled() const
 {
-    return glfwGetInputMode(mWindow, GLFW_CURSOR) == GLFW_CURSOR_DISABLED;
+    // Scripted cursor movement always drives the view
+    return mInputScripted || glfwGetInputMode(mWindow, GLFW_CURSOR) == GLFW_CURSOR_DISABLED;
 }
 
 std::tuple<double, double> Window::GetCursorDiff() const
@@ -329,6 +374,22 @@ std::tuple<double, double> Window::GetCursorDiff() const
     return std::make_tuple<double, double>(mCursorX - mPrevCursorX, mCursorY - mPrevCursorY);
 }
 
+void Window::SetInputScripted(bool scripted)
+{
+    mInputScripted = scripted;
+    SetScriptedInput(std::vector<Key>(), 0.0, 0.0);
+}
+
+void Window::SetScriptedInput(const std::vector<Key>& pressed, double dx, double dy)
+{
+    for (auto& keyState : mKeyState)
+        keyState.second = KeyAction::Release;
+    for (Key k : pressed)
+        mKeyState[k] = KeyAction::Press;
+    mPolledCursorX += dx;
+    mPolledCursorY += dy;
+}
+
 void Window::UpdateTitleStats()
 {
     double elapsedMs = (glfwGetTime() * 1000) - mPrevTimeTicks;
@@ -357,15 +418,45 @@ void Window::SwapBuffers()
     glfwSwapBuffers(mWindow);
 }
 
-void Window::Update()
+bool Window::IsHeadless() const
+{
+    return mMode == Mode::Headless;
+}
+
+GLuint Window::GetFramebuffer() const
+{
+    return mOffscreenFbo;
+}
+
+void Window::ResizeOffscreenTarget(int width, int height)
+{
+    if (width == 0 || height == 0)
+        return;
+
+    glBindRenderbuffer(GL_RENDERBUFFER, mOffscreenColor);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, mOffscreenDepth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+}
+
+void Window::PollEvents()
 {
     // Poll events from the event queue and call their callback handlers
     glfwPollEvents();
 
+    // Sample the cursor position
+    if (!mInputScripted)
+        glfwGetCursorPos(mWindow, &mPolledCursorX, &mPolledCursorY);
+}
+
+void Window::Update()
+{
     // Update the cursor position state
     mPrevCursorX = mCursorX;
     mPrevCursorY = mCursorY;
-    glfwGetCursorPos(mWindow, &mCursorX, &mCursorY);
+    mCursorX = mPolledCursorX;
+    mCursorY = mPolledCursorY;
 }
 
 void Window::AddKeyHook(KeyPressedHookCb cb, HookPos pos)
@@ -51,7 +51,8 @@ class Window
         {
             Windowed,
             BorderlessWindow,
-            Fullscreen
+            Fullscreen,
+            Headless // An invisible window rendering to an offscreen framebuffer, for machines without a display
         };
 
         /// Window event callback types
@@ -160,17 +161,35 @@ class Window
         /// Retrieves the value of the mouse grab option
         bool MouseGrabEnabled() const;
 
-        /// Retrieves the relative movement difference of the cursor from the last frame
+        /// Retrieves the relative movement difference of the cursor between the last two updates
         std::tuple<double, double> GetCursorDiff() const;
 
+        /// Replaces the polled key state and cursor movement with the ones given to SetScriptedInput,
+        /// for reproducible runs. Events are still dispatched to the callbacks
+        void SetInputScripted(bool scripted);
+
+        /// Sets the held keys and moves the cursor by the given offset while the input is scripted.
+        /// Like polled input, the cursor movement is latched by the next Update
+        void SetScriptedInput(const std::vector<Key>& pressed, double dx, double dy);
+
         /// Enables debug option that appends current fps and frame ms to the window title
         void SetShowStats(bool show);
 
         /// Swaps the back with the front frame buffer
         void SwapBuffers();
 
+        /// True when the window was created in Headless mode
+        bool IsHeadless() const;
+
+        /// Retrieves the framebuffer that stands for the default one, the offscreen target in Headless mode and 0 otherwise
+        GLuint GetFramebuffer() const;
+
         /// Peeks for the events of the current window and feeds them to the registered callbacks
-        /// Updates also the cursor state variables for making the Cursor Diff functions usable
+        /// and samples the cursor position. Must be called from the main thread
+        void PollEvents();
+
+        /// Latches the cursor position sampled by the last poll for making the Cursor Diff functions usable.
+        /// Called once per update, regardless of how many times the events were polled in between
         void Update();
 
         /// Hook insertion position (start or end of chain)
@@ -189,6 +208,10 @@ class Window
         // Main window properties
         GLFWwindow* mWindow;
         std::string mTitle;
+        Mode mMode;
+
+        // The offscreen target of the Headless mode
+        GLuint mOffscreenFbo, mOffscreenColor, mOffscreenDepth;
 
         // The stored callback handlers
         PositionChangedCb mPosCb;
@@ -205,6 +228,9 @@ class Window
         // Key state map
         std::map<Key, KeyAction> mKeyState;
 
+        // True while the key state and cursor come from SetScriptedInput
+        bool mInputScripted;
+
         // The stored hooks
         std::vector<KeyPressedHookCb> mKeyHooks;
         std::vector<CharEnterHookCb> mCharHooks;
@@ -212,8 +238,11 @@ class Window
         // Appends current statistics to the window title if flag is true
         void UpdateTitleStats();
 
-        // Stores the cursor position from the last two frames
-        double mCursorX, mCursorY, mPrevCursorX, mPrevCursorY;
+        // Creates or resizes the storage of the offscreen target
+        void ResizeOffscreenTarget(int width, int height);
+
+        // Stores the cursor position from the last poll and the last two updates
+        double mPolledCursorX, mPolledCursorY, mCursorX, mCursorY, mPrevCursorX, mPrevCursorY;
 
         // State variables used by the window title stats debugging feature
         bool mShowStats;
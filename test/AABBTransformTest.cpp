@@ -0,0 +1,174 @@
+#include <cstring>
+#include <random>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/rotate_vector.hpp>
+#include "Test.hpp"
+#include "../src/Graphics/Scene/AABB.hpp"
+#include "../src/Util/Timer.hpp"
+
+namespace
+{
+// The SIMD instruction sets compared against the scalar kernel
+const char* SimdPaths[] = { "SSE2", "AVX2" };
+
+// Random affine matrices, mixing rotations, negative scales and translations, and random boxes
+void MakeInput(std::size_t n, std::vector<glm::mat4>& world, std::vector<AABB>& local, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> value(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> scale(-4.0f, 4.0f);
+    std::uniform_real_distribution<float> angle(-3.1416f, 3.1416f);
+
+    world.resize(n);
+    local.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(value(rng), value(rng), value(rng)));
+        m = glm::rotate(m, angle(rng), glm::normalize(glm::vec3(value(rng), value(rng), value(rng)) + glm::vec3(0.01f)));
+        m = glm::scale(m, glm::vec3(scale(rng), scale(rng), scale(rng)));
+        world[i] = m;
+
+        const glm::vec3 a(value(rng), value(rng), value(rng));
+        const glm::vec3 b(value(rng), value(rng), value(rng));
+        local[i] = AABB(glm::min(a, b), glm::max(a, b));
+    }
+}
+
+// The AABB update the kernels replaced: the eight corners rotated about each axis in turn,
+// then their bounds scaled and translated
+void BaselineUpdate(const AABB& local, AABB& out, const glm::vec3& transl, const glm::vec3& scale, const glm::vec3& rotation)
+{
+    const glm::vec3 localMin = local.MinPoint(), localMax = local.MaxPoint();
+    glm::vec3 aabbPoints[] = {
+        {localMin.x, localMin.y, localMin.z},
+        {localMin.x, localMin.y, localMax.z},
+        {localMin.x, localMax.y, localMin.z},
+        {localMin.x, localMax.y, localMax.z},
+        {localMax.x, localMin.y, localMin.z},
+        {localMax.x, localMin.y, localMax.z},
+        {localMax.x, localMax.y, localMin.z},
+        {localMax.x, localMax.y, localMax.z},
+    };
+
+    auto newMin = localMin;
+    auto newMax = localMax;
+    for (int i = 0; i < 8; ++i)
+    {
+        aabbPoints[i] = glm::rotateX(aabbPoints[i], rotation.x);
+        aabbPoints[i] = glm::rotateY(aabbPoints[i], rotation.y);
+        aabbPoints[i] = glm::rotateZ(aabbPoints[i], rotation.z);
+        newMin = glm::min(newMin, aabbPoints[i]);
+        newMax = glm::max(newMax, aabbPoints[i]);
+    }
+
+    glm::mat4 transform = glm::mat4();
+    transform = glm::translate(transform, transl);
+    transform = glm::scale(transform, scale);
+    out = AABB(glm::vec3(transform * glm::vec4(newMin, 1.0f)), glm::vec3(transform * glm::vec4(newMax, 1.0f)));
+}
+
+// Exact comparison, every path evaluates the same operations in the same order
+bool SameBox(const AABB& a, const AABB& b)
+{
+    const glm::vec3 corners[] = { a.MinPoint(), a.MaxPoint(), b.MinPoint(), b.MaxPoint() };
+    return std::memcmp(&corners[0], &corners[2], 2 * sizeof(glm::vec3)) == 0;
+}
+}
+
+TEST_CASE(AABBTransformSimdMatchesScalar)
+{
+    std::vector<glm::mat4> world;
+    std::vector<AABB> local;
+
+    // Every remainder of the batched loops, and a long run
+    for (std::size_t n : { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 11, 12, 13, 15, 16, 17, 23, 1000, 4099 })
+    {
+        MakeInput(n, world, local, static_cast<std::uint32_t>(n) + 1);
+        std::vector<AABB> expected(n);
+        CHECK(TransformAABBs("Scalar", world.data(), local.data(), expected.data(), n));
+
+        for (const char* path : SimdPaths)
+        {
+            std::vector<AABB> out(n);
+            if (!TransformAABBs(path, world.data(), local.data(), out.data(), n))
+                continue;
+            for (std::size_t i = 0; i < n; ++i)
+                CHECK(SameBox(out[i], expected[i]));
+
+            // In place, as AABB::Update calls it
+            std::vector<AABB> inPlace = local;
+            TransformAABBs(path, world.data(), inPlace.data(), inPlace.data(), n);
+            for (std::size_t i = 0; i < n; ++i)
+                CHECK(SameBox(inPlace[i], expected[i]));
+        }
+    }
+}
+
+TEST_CASE(AABBTransformEnclosesTheTransformedCorners)
+{
+    std::vector<glm::mat4> world;
+    std::vector<AABB> local;
+    MakeInput(256, world, local, 7);
+
+    std::vector<AABB> out(local.size());
+    TransformAABBs(world.data(), local.data(), out.data(), out.size());
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+        const glm::vec3 lo = local[i].MinPoint(), hi = local[i].MaxPoint();
+        const glm::vec3 tolerance = glm::vec3(1e-3f) * (glm::abs(out[i].MinPoint()) + glm::abs(out[i].MaxPoint()) + 1.0f);
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            const glm::vec3 p(corner & 1 ? hi.x : lo.x, corner & 2 ? hi.y : lo.y, corner & 4 ? hi.z : lo.z);
+            const glm::vec3 w = glm::vec3(world[i] * glm::vec4(p, 1.0f));
+            CHECK(glm::all(glm::greaterThanEqual(w, out[i].MinPoint() - tolerance)));
+            CHECK(glm::all(glm::lessThanEqual(w, out[i].MaxPoint() + tolerance)));
+        }
+    }
+}
+
+BENCHMARK(AABBTransformThroughput)
+{
+    const std::size_t BoxCount = 100000;
+    const int Repeats = 50;
+
+    std::vector<glm::mat4> world;
+    std::vector<AABB> local;
+    MakeInput(BoxCount, world, local, 1);
+    std::vector<AABB> out(BoxCount);
+
+    // The per corner update of the baseline, fed with the translation, scale and angles the scene used to keep
+    {
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> value(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> angle(-3.1416f, 3.1416f);
+        std::vector<glm::vec3> transl(BoxCount), scale(BoxCount), rotation(BoxCount);
+        for (std::size_t i = 0; i < BoxCount; ++i)
+        {
+            transl[i] = glm::vec3(value(rng), value(rng), value(rng));
+            scale[i] = glm::vec3(value(rng), value(rng), value(rng)) * 0.04f;
+            rotation[i] = glm::vec3(angle(rng), angle(rng), angle(rng));
+        }
+
+        const long long start = MonotonicTimeNs();
+        for (int r = 0; r < Repeats; ++r)
+            for (std::size_t i = 0; i < BoxCount; ++i)
+                BaselineUpdate(local[i], out[i], transl[i], scale[i], rotation[i]);
+        const long long elapsed = MonotonicTimeNs() - start;
+
+        Test::Report("Baseline", static_cast<double>(elapsed) / (static_cast<double>(BoxCount) * Repeats), "ns/box");
+    }
+
+    for (const char* path : { "Scalar", "SSE2", "AVX2" })
+    {
+        if (!TransformAABBs(path, world.data(), local.data(), out.data(), BoxCount))
+            continue;
+
+        const long long start = MonotonicTimeNs();
+        for (int r = 0; r < Repeats; ++r)
+            TransformAABBs(path, world.data(), local.data(), out.data(), BoxCount);
+        const long long elapsed = MonotonicTimeNs() - start;
+
+        Test::Report(path, static_cast<double>(elapsed) / (static_cast<double>(BoxCount) * Repeats), "ns/box");
+    }
+}
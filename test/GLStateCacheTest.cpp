@@ -0,0 +1,34 @@
+#include "Test.hpp"
+#include "GLStub.hpp"
+#include "../src/Graphics/Renderer/GLStateCache.hpp"
+
+TEST_CASE(GLStateCacheCarriesStateAcrossFrames)
+{
+    InstallGLStub();
+    GLStateCache cache;
+    cache.Viewport(0, 0, 800, 600);
+    cache.ActiveTexture(GL_TEXTURE0);
+    cache.BindTexture(GL_TEXTURE_2D, 5);
+
+    // Steady state frames save and restore the viewport and rebind the same texture without reaching the driver
+    const std::size_t queries = GLQueryCount();
+    for (int i = 0; i < 3; ++i)
+    {
+        cache.NewFrame();
+        const std::array<GLint, 4> viewport = cache.GetViewport();
+        cache.Viewport(0, 0, 1024, 1024);
+        cache.Viewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        cache.ActiveTexture(GL_TEXTURE0);
+        cache.BindTexture(GL_TEXTURE_2D, 5);
+        CHECK(viewport[2] == 800 && viewport[3] == 600);
+        CHECK(cache.GetFrameStats().issued == 2);
+        CHECK(cache.GetFrameStats().skipped == 2);
+    }
+    CHECK(GLQueryCount() == queries);
+
+    // Only forgotten state is queried
+    cache.Invalidate();
+    cache.GetViewport();
+    cache.GetViewport();
+    CHECK(GLQueryCount() == queries + 1);
+}
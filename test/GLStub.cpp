@@ -0,0 +1,63 @@
+#include "GLStub.hpp"
+#include <glad/glad.h>
+
+namespace
+{
+// The last object name handed out
+GLuint lastName = 0;
+
+// The number of glGet calls made
+std::size_t queryCount = 0;
+
+void APIENTRY GenNames(GLsizei n, GLuint* names)
+{
+    for (GLsizei i = 0; i < n; ++i)
+        names[i] = ++lastName;
+}
+
+void APIENTRY DeleteNames(GLsizei, const GLuint*) {}
+void APIENTRY BindBuffer(GLenum, GLuint) {}
+void APIENTRY BindVertexArray(GLuint) {}
+void APIENTRY BufferData(GLenum, GLsizeiptr, const void*, GLenum) {}
+void APIENTRY BufferSubData(GLenum, GLintptr, GLsizeiptr, const void*) {}
+void APIENTRY CopyBufferSubData(GLenum, GLenum, GLintptr, GLintptr, GLsizeiptr) {}
+void APIENTRY VertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*) {}
+void APIENTRY EnableVertexAttribArray(GLuint) {}
+void APIENTRY ActiveTexture(GLenum) {}
+void APIENTRY BindTexture(GLenum, GLuint) {}
+void APIENTRY Viewport(GLint, GLint, GLsizei, GLsizei) {}
+
+void APIENTRY GetIntegerv(GLenum pname, GLint* data)
+{
+    ++queryCount;
+    const int count = pname == GL_VIEWPORT ? 4 : 1;
+    for (int i = 0; i < count; ++i)
+        data[i] = 0;
+}
+}
+
+void InstallGLStub()
+{
+    glad_glGenBuffers = GenNames;
+    glad_glGenVertexArrays = GenNames;
+    glad_glGenTextures = GenNames;
+    glad_glDeleteBuffers = DeleteNames;
+    glad_glDeleteVertexArrays = DeleteNames;
+    glad_glDeleteTextures = DeleteNames;
+    glad_glBindBuffer = BindBuffer;
+    glad_glBindVertexArray = BindVertexArray;
+    glad_glBufferData = BufferData;
+    glad_glBufferSubData = BufferSubData;
+    glad_glCopyBufferSubData = CopyBufferSubData;
+    glad_glVertexAttribPointer = VertexAttribPointer;
+    glad_glEnableVertexAttribArray = EnableVertexAttribArray;
+    glad_glActiveTexture = ActiveTexture;
+    glad_glBindTexture = BindTexture;
+    glad_glViewport = Viewport;
+    glad_glGetIntegerv = GetIntegerv;
+}
+
+std::size_t GLQueryCount()
+{
+    return queryCount;
+}
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Test.hpp"
+#include "../src/Core/JobSystem.hpp"
+#include "../src/Util/Timer.hpp"
+
+namespace
+{
+// Keeps the calling thread busy for the given time without yielding it
+void Spin(std::chrono::microseconds duration)
+{
+    const auto end = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end)
+        ;
+}
+}
+
+TEST_CASE(JobSystemCounterWaitsForAllJobs)
+{
+    JobSystem jobs;
+    jobs.Init(3);
+
+    std::atomic<int> done(0);
+    JobCounter counter;
+    CHECK(counter.IsDone());
+    for (int i = 0; i < 1000; ++i)
+        jobs.Run([&done]() { Spin(std::chrono::microseconds(10)); ++done; }, &counter);
+    jobs.Wait(counter);
+    CHECK(counter.IsDone());
+    CHECK(done == 1000);
+
+    jobs.Shutdown();
+}
+
+TEST_CASE(JobSystemContinuationsRunAfterTheirDependency)
+{
+    JobSystem jobs;
+    jobs.Init(3);
+
+    // Three stages, each started by the completion of the previous one
+    const int JobsPerStage = 64;
+    std::atomic<int> stageDone[3] = {};
+    std::atomic<int> earlyStarts(0);
+    JobCounter stages[3];
+
+    for (int i = 0; i < JobsPerStage; ++i)
+        jobs.Run([&]() { Spin(std::chrono::microseconds(50)); ++stageDone[0]; }, &stages[0]);
+    for (int s = 1; s < 3; ++s)
+    {
+        for (int i = 0; i < JobsPerStage; ++i)
+        {
+            jobs.RunAfter(stages[s - 1],
+                [&, s]()
+                {
+                    if (stageDone[s - 1] != JobsPerStage)
+                        ++earlyStarts;
+                    ++stageDone[s];
+                },
+                &stages[s]);
+        }
+    }
+
+    // The last stage can not be done before its continuations were even scheduled
+    jobs.Wait(stages[2]);
+    CHECK(earlyStarts == 0);
+    for (int s = 0; s < 3; ++s)
+    {
+        CHECK(stages[s].IsDone());
+        CHECK(stageDone[s] == JobsPerStage);
+    }
+
+    // A continuation of a finished counter starts right away
+    std::atomic<bool> ran(false);
+    JobCounter after;
+    jobs.RunAfter(stages[0], [&ran]() { ran = true; }, &after);
+    jobs.Wait(after);
+    CHECK(ran);
+
+    jobs.Shutdown();
+}
+
+TEST_CASE(JobSystemParallelForCoversEveryIndexOnce)
+{
+    JobSystem jobs;
+    jobs.Init(3);
+
+    for (std::size_t count : { 0, 1, 7, 1000, 100003 })
+    {
+        for (std::size_t grain : { 0, 1, 3, 64, 1000, 200000 })
+        {
+            std::unique_ptr<std::atomic<int>[]> hits(new std::atomic<int>[count + 1]);
+            for (std::size_t i = 0; i < count; ++i)
+                hits[i] = 0;
+            std::atomic<int> badRanges(0);
+
+            jobs.ParallelFor(count, grain,
+                [&](std::size_t begin, std::size_t end)
+                {
+                    if (begin >= end || end > count)
+                        ++badRanges;
+                    for (std::size_t i = begin; i < end && i < count; ++i)
+                        ++hits[i];
+                }
+            );
+
+            CHECK(badRanges == 0);
+            std::size_t wrong = 0;
+            for (std::size_t i = 0; i < count; ++i)
+                wrong += hits[i] != 1;
+            CHECK(wrong == 0);
+        }
+    }
+
+    jobs.Shutdown();
+}
+
+TEST_CASE(JobSystemStealsUnderImbalance)
+{
+    JobSystem jobs;
+    jobs.Init(3);
+    const std::uint64_t stealsBefore = jobs.GetStealCount();
+
+    // ParallelFor queues every range on the calling thread, which then stays busy on the first one,
+    // so the workers only get the others by stealing them
+    const std::size_t Count = 64;
+    std::vector<std::thread::id> ranOn(Count);
+    jobs.ParallelFor(Count, 1,
+        [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                Spin(std::chrono::microseconds(i == 0 ? 50000 : 200));
+                ranOn[i] = std::this_thread::get_id();
+            }
+        }
+    );
+
+    std::size_t onOthers = 0;
+    std::set<std::thread::id> threads;
+    for (std::size_t i = 1; i < Count; ++i)
+    {
+        onOthers += ranOn[i] != std::this_thread::get_id();
+        threads.insert(ranOn[i]);
+    }
+    CHECK(onOthers >= Count / 2);
+    CHECK(threads.size() > 1);
+    CHECK(jobs.GetStealCount() - stealsBefore >= onOthers);
+
+    jobs.Shutdown();
+}
+
+BENCHMARK(JobSystemScaling)
+{
+    // Independent arithmetic over a large range, split in ranges of a few microseconds
+    const std::size_t Count = 1 << 22;
+    const std::size_t Grain = 4096;
+    const int Repeats = 10;
+    std::vector<float> data(Count, 1.0f);
+
+    // Powers of two up to every hardware thread
+    const unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    double singleMs = 0.0;
+    for (unsigned int threads : threadCounts)
+    {
+        JobSystem jobs;
+        jobs.Init(threads - 1);
+
+        auto run = [&]()
+        {
+            jobs.ParallelFor(Count, Grain,
+                [&data](std::size_t begin, std::size_t end)
+                {
+                    for (std::size_t i = begin; i < end; ++i)
+                        data[i] = std::sqrt(data[i] * 1.0001f + 0.5f);
+                }
+            );
+        };
+        run();
+
+        const long long start = MonotonicTimeNs();
+        for (int r = 0; r < Repeats; ++r)
+            run();
+        const double ms = static_cast<double>(MonotonicTimeNs() - start) / Repeats / 1e6;
+        if (threads == 1)
+            singleMs = ms;
+
+        const std::string name = std::to_string(threads) + " threads";
+        Test::Report(name.c_str(), ms, "ms");
+        Test::Report((name + " speedup").c_str(), singleMs / ms, "x");
+        Test::Report((name + " steals").c_str(), static_cast<double>(jobs.GetStealCount()), "jobs");
+
+        jobs.Shutdown();
+    }
+}
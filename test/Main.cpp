@@ -0,0 +1,109 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#include <cstdio>
+#include <cstring>
+#include "Test.hpp"
+
+namespace
+{
+// Failed checks of the running case, only the first few get printed
+unsigned int failures = 0;
+const unsigned int MaxPrintedFailures = 10;
+}
+
+namespace Test
+{
+std::vector<Case>& Tests()
+{
+    static std::vector<Case> cases;
+    return cases;
+}
+
+std::vector<Case>& Benchmarks()
+{
+    static std::vector<Case> cases;
+    return cases;
+}
+
+Registrar::Registrar(std::vector<Case>& cases, const char* name, void (*fn)())
+{
+    cases.push_back({name, fn});
+}
+
+void Fail(const char* file, int line, const char* expr)
+{
+    if (failures++ < MaxPrintedFailures)
+        std::printf("    %s:%d: CHECK(%s) failed\n", file, line, expr);
+}
+
+void Report(const char* name, double value, const char* unit)
+{
+    std::printf("    %-40s %12.3f %s\n", name, value, unit);
+}
+}
+
+int main(int argc, char* argv[])
+{
+    // Run the benchmarks instead of the tests
+    bool bench = false;
+    // Only run the cases whose name contains the given string
+    const char* filter = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--bench") == 0)
+            bench = true;
+        else
+            filter = argv[i];
+    }
+
+    unsigned int run = 0, failed = 0;
+    for (const Test::Case& c : bench ? Test::Benchmarks() : Test::Tests())
+    {
+        if (filter != nullptr && std::strstr(c.name, filter) == nullptr)
+            continue;
+
+        std::printf("[ RUN  ] %s\n", c.name);
+        std::fflush(stdout);
+        failures = 0;
+        c.fn();
+        ++run;
+        if (failures != 0)
+        {
+            ++failed;
+            std::printf("[ FAIL ] %s, %u failed checks\n", c.name, failures);
+        }
+        else
+            std::printf("[  OK  ] %s\n", c.name);
+    }
+
+    std::printf("%u of %u %s passed\n", run - failed, run, bench ? "benchmarks" : "tests");
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,29 @@
+#include <string>
+#include "Test.hpp"
+#include "../src/Graphics/Renderer/RenderStats.hpp"
+
+TEST_CASE(RenderStatsAccountsShadowCascadesApart)
+{
+    RenderStatsTracker tracker;
+    tracker.SetPass(RenderPass::Shadow);
+    tracker.CountBufferUpload(64);
+    for (unsigned int cascade = 0; cascade < MaxShadowCascadePasses + 1; ++cascade)
+    {
+        tracker.SetPass(ShadowCascadePass(cascade));
+        for (unsigned int draw = 0; draw <= cascade; ++draw)
+            tracker.CountDraw(GL_TRIANGLES, 30);
+    }
+    tracker.NewFrame();
+
+    // Every cascade keeps its own draws, the extra one is accounted to the last
+    const FrameRenderStats& stats = tracker.GetLastFrameStats();
+    CHECK(stats[RenderPass::Shadow].drawCalls == 0);
+    CHECK(stats[RenderPass::Shadow].bufferBytes == 64);
+    CHECK(stats[RenderPass::ShadowCascade0].drawCalls == 1);
+    CHECK(stats[RenderPass::ShadowCascade1].drawCalls == 2);
+    CHECK(stats[RenderPass::ShadowCascade2].drawCalls == 3);
+    CHECK(stats[RenderPass::ShadowCascade3].drawCalls == 4 + 5);
+    CHECK(stats[RenderPass::ShadowCascade3].triangles == 9 * 10);
+    CHECK(stats.Total().drawCalls == 15);
+    CHECK(std::string(RenderPassName(RenderPass::ShadowCascade2)) == "Cascade 2");
+}
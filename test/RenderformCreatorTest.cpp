@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Test.hpp"
+#include "GLStub.hpp"
+#include "../src/Core/JobSystem.hpp"
+#include "../src/Graphics/Scene/RenderformCreator.hpp"
+
+namespace
+{
+// A model of the given number of single triangle meshes
+ModelData MakeModel(std::uint32_t meshCount)
+{
+    ModelData data;
+    for (std::uint32_t i = 0; i < meshCount; ++i)
+    {
+        MeshData mesh;
+        mesh.data.resize(3);
+        mesh.indices = { 0, 1, 2 };
+        mesh.meshIndex = i;
+        data.meshes.push_back(mesh);
+    }
+    data.boundingBox = AABB(glm::vec3(-0.5f), glm::vec3(0.5f));
+    return data;
+}
+
+// A model with one mesh, one with three and a few materials, on a stubbed GL
+struct Stores
+{
+    ModelStore models;
+    MaterialStore materials;
+
+    Stores()
+    {
+        InstallGLStub();
+        models.Load("single", MakeModel(1));
+        models.Load("triple", MakeModel(3));
+        for (const char* name : { "a", "b", "c", "d", "e", "f", "g", "h" })
+            materials.Load(name, Material());
+    }
+};
+
+// A mesh in the render lists by its transform, its geometry and its material
+using MeshKey = std::tuple<std::uint32_t, GLint, GLuint, GLuint>;
+
+// A mesh in the shadow caster list by its transform and its geometry
+using CasterKey = std::tuple<std::uint32_t, GLint, GLuint>;
+
+// Creates a node of the given model and materials
+NodeHandle AddNode(Scene& scene, const std::string& model, const std::vector<std::string>& materials)
+{
+    static unsigned int uuid = 0;
+    return scene.CreateNode(model, materials, std::to_string(uuid++), Category::Normal, AABB(glm::vec3(-0.5f), glm::vec3(0.5f)));
+}
+
+// Applies the scene's changes to the render lists
+void Sync(Scene& scene, RenderformCreator& creator)
+{
+    scene.Update();
+    creator.Update(scene, scene.PullUpdates());
+}
+
+// Checks that the render lists hold exactly the meshes of the scene's nodes, one entry per material in use
+void CheckLists(const Scene& scene, Stores& stores, const RenderformCreator& creator)
+{
+    std::vector<MeshKey> expectedMeshes, meshes;
+    std::vector<CasterKey> expectedCasters, casters;
+    for (const SceneNode& node : scene.GetNodes())
+    {
+        for (const MeshDescription& mesh : stores.models[node.GetModel()]->meshes)
+        {
+            const GLuint matIndex = stores.materials[node.GetMaterials()[mesh.meshIndex]]->matIndex;
+            expectedMeshes.emplace_back(node.GetTransformIndex(), mesh.range.baseVertex, mesh.range.firstIndex, matIndex);
+            expectedCasters.emplace_back(node.GetTransformIndex(), mesh.range.baseVertex, mesh.range.firstIndex);
+        }
+    }
+
+    std::vector<GLuint> matIndices;
+    for (const auto& entry : creator.GetMaterials())
+    {
+        CHECK(!entry.second.empty());
+        matIndices.push_back(entry.first.matIndex);
+        for (const auto& mesh : entry.second)
+            meshes.emplace_back(mesh.transform, mesh.baseVertex, mesh.firstIndex, entry.first.matIndex);
+    }
+    for (const auto& caster : creator.GetShadowCasters())
+        casters.emplace_back(caster.transform, caster.baseVertex, caster.firstIndex);
+
+    std::sort(std::begin(matIndices), std::end(matIndices));
+    CHECK(std::adjacent_find(std::begin(matIndices), std::end(matIndices)) == std::end(matIndices));
+
+    std::sort(std::begin(expectedMeshes), std::end(expectedMeshes));
+    std::sort(std::begin(meshes), std::end(meshes));
+    CHECK(meshes == expectedMeshes);
+
+    std::sort(std::begin(expectedCasters), std::end(expectedCasters));
+    std::sort(std::begin(casters), std::end(casters));
+    CHECK(casters == expectedCasters);
+}
+
+// Checks the culling flags and stats against testing every node against the frustum
+void CheckCulling(const Scene& scene, const RenderformCreator& creator, const glm::mat4& viewProj)
+{
+    const Frustum frustum(viewProj);
+    std::unordered_map<std::uint32_t, bool> visible;
+    std::size_t expectedVisible = 0, expectedTotal = 0;
+    for (const SceneNode& node : scene.GetNodes())
+    {
+        const bool inside = Intersects(frustum, node.GetAABB());
+        visible[node.GetTransformIndex()] = inside;
+        CHECK(node.IsCulled() == !inside);
+
+        const std::size_t meshCount = node.GetModel() == "triple" ? 3 : 1;
+        expectedTotal += meshCount;
+        if (inside)
+            expectedVisible += meshCount;
+    }
+
+    for (const auto& entry : creator.GetMaterials())
+        for (const auto& mesh : entry.second)
+            CHECK(mesh.culled == !visible[mesh.transform]);
+    CHECK(creator.GetCullStats().visible == expectedVisible);
+    CHECK(creator.GetCullStats().total == expectedTotal);
+}
+}
+
+TEST_CASE(RenderformCreatorFixesBackReferencesOfTheSameMaterial)
+{
+    Stores stores;
+
+    // Remove the nodes in every order, each removal moving meshes of the others around within material a
+    std::vector<int> order = { 0, 1, 2 };
+    do
+    {
+        Scene scene;
+        RenderformCreator creator(&stores.models, &stores.materials);
+        const NodeHandle nodes[] = {
+            AddNode(scene, "triple", { "a", "a", "a" }),
+            AddNode(scene, "single", { "a" }),
+            AddNode(scene, "triple", { "a", "b", "a" })
+        };
+        Sync(scene, creator);
+        CheckLists(scene, stores, creator);
+        CHECK(creator.GetMaterials().size() == 2);
+
+        for (int i : order)
+        {
+            scene.DeleteNode(nodes[i]);
+            Sync(scene, creator);
+            CheckLists(scene, stores, creator);
+        }
+        CHECK(creator.GetMaterials().empty());
+        CHECK(creator.GetShadowCasters().empty());
+    }
+    while (std::next_permutation(std::begin(order), std::end(order)));
+}
+
+TEST_CASE(RenderformCreatorEvictsUnusedMaterials)
+{
+    Stores stores;
+    Scene scene;
+    RenderformCreator creator(&stores.models, &stores.materials);
+
+    const NodeHandle a = AddNode(scene, "single", { "a" });
+    const NodeHandle b = AddNode(scene, "single", { "b" });
+    const NodeHandle c = AddNode(scene, "triple", { "c", "c", "a" });
+    Sync(scene, creator);
+    CHECK(creator.GetMaterials().size() == 3);
+
+    // Material c takes the place of b, the meshes of c must follow it
+    scene.DeleteNode(b);
+    Sync(scene, creator);
+    CheckLists(scene, stores, creator);
+    CHECK(creator.GetMaterials().size() == 2);
+
+    // Material a is still used by c
+    scene.DeleteNode(a);
+    Sync(scene, creator);
+    CheckLists(scene, stores, creator);
+    CHECK(creator.GetMaterials().size() == 2);
+
+    // An evicted material comes back with its next mesh
+    const NodeHandle d = AddNode(scene, "single", { "b" });
+    Sync(scene, creator);
+    CheckLists(scene, stores, creator);
+    CHECK(creator.GetMaterials().size() == 3);
+
+    scene.DeleteNode(c);
+    Sync(scene, creator);
+    CheckLists(scene, stores, creator);
+    CHECK(creator.GetMaterials().size() == 1);
+
+    scene.DeleteNode(d);
+    Sync(scene, creator);
+    CHECK(creator.GetMaterials().empty());
+}
+
+TEST_CASE(RenderformCreatorSkipsNodesDeletedBeforeTheirAddition)
+{
+    Stores stores;
+    Scene scene;
+    RenderformCreator creator(&stores.models, &stores.materials);
+
+    const NodeHandle kept = AddNode(scene, "single", { "a" });
+    scene.DeleteNode(AddNode(scene, "triple", { "b", "b", "b" }));
+    Sync(scene, creator);
+    CheckLists(scene, stores, creator);
+    CHECK(creator.GetMaterials().size() == 1);
+
+    scene.DeleteNode(kept);
+    Sync(scene, creator);
+    CHECK(creator.GetMaterials().empty());
+}
+
+TEST_CASE(RenderformCreatorFollowsDefragmentation)
+{
+    Stores stores;
+    stores.models.Load("spare", MakeModel(2));
+    Scene scene;
+    RenderformCreator creator(&stores.models, &stores.materials);
+
+    AddNode(scene, "triple", { "a", "b", "c" });
+    AddNode(scene, "spare", { "b", "b" });
+    AddNode(scene, "triple", { "c", "c", "c" });
+    Sync(scene, creator);
+
+    // Packing the geometry moves every mesh loaded after the unloaded model
+    const GLuint firstIndex = stores.models["triple"]->meshes[0].range.firstIndex;
+    stores.models.Unload("single");
+    stores.models.Defragment();
+    CHECK(stores.models["triple"]->meshes[0].range.firstIndex != firstIndex);
+
+    Sync(scene, creator);
+    CheckLists(scene, stores, creator);
+}
+
+TEST_CASE(RenderformCreatorStress)
+{
+    const std::size_t NodeCount = 100000;
+    const char* materials[] = { "a", "b", "c", "d", "e", "f", "g", "h" };
+
+    Stores stores;
+    Scene scene;
+    RenderformCreator creator(&stores.models, &stores.materials);
+    JobSystem jobs;
+    jobs.Init(3);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+    std::uniform_int_distribution<std::size_t> material(0, 7);
+    std::vector<NodeHandle> nodes;
+    auto addNodes = [&](std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            NodeHandle node = (rng() % 4 == 0)
+                ? AddNode(scene, "triple", { materials[material(rng)], materials[material(rng)], materials[material(rng)] })
+                : AddNode(scene, "single", { materials[material(rng)] });
+            scene.Move(node, glm::vec3(position(rng), position(rng), position(rng)));
+            nodes.push_back(node);
+        }
+    };
+
+    const glm::mat4 viewProj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 150.0f)
+        * glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // Add everything at once and cull
+    addNodes(NodeCount);
+    scene.Update(&jobs);
+    creator.Update(scene, scene.PullUpdates());
+    CheckLists(scene, stores, creator);
+    creator.Cull(scene, viewProj, viewProj, &jobs);
+    CheckCulling(scene, creator, viewProj);
+
+    // Remove half of the nodes in random order along with adding new ones, then cull again
+    std::shuffle(std::begin(nodes), std::end(nodes), rng);
+    for (std::size_t i = 0; i < NodeCount / 2; ++i)
+        scene.DeleteNode(nodes[i]);
+    nodes.erase(std::begin(nodes), std::begin(nodes) + NodeCount / 2);
+    addNodes(NodeCount / 5);
+    scene.Update(&jobs);
+    creator.Update(scene, scene.PullUpdates());
+    CheckLists(scene, stores, creator);
+    creator.Cull(scene, viewProj, viewProj, &jobs);
+    CheckCulling(scene, creator, viewProj);
+
+    // Remove everything
+    for (NodeHandle node : nodes)
+        scene.DeleteNode(node);
+    scene.Update(&jobs);
+    creator.Update(scene, scene.PullUpdates());
+    CHECK(creator.GetMaterials().empty());
+    CHECK(creator.GetShadowCasters().empty());
+
+    jobs.Shutdown();
+}
@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "Test.hpp"
+#include "../src/Graphics/Scene/SceneNode.hpp"
+#include "../src/Util/SlotMap.hpp"
+#include "../src/Util/Timer.hpp"
+
+namespace
+{
+using IntMap = SlotMap<int>;
+
+std::uint32_t IndexOf(SlotHandle handle)
+{
+    return handle & IntMap::IndexMask;
+}
+
+// Formats a random uuid the way the scene files spell them
+std::string RandomUuid(std::mt19937& rng)
+{
+    char uuid[37];
+    std::snprintf(uuid, sizeof(uuid), "%08x-%04x-%04x-%04x-%04x%08x",
+        static_cast<unsigned>(rng()), static_cast<unsigned>(rng() & 0xFFFF), static_cast<unsigned>(rng() & 0xFFFF),
+        static_cast<unsigned>(rng() & 0xFFFF), static_cast<unsigned>(rng() & 0xFFFF), static_cast<unsigned>(rng()));
+    return uuid;
+}
+
+// Reports a benchmark value under a name suffixed with the node count
+void ReportAt(const char* name, std::size_t nodes, double value, const char* unit)
+{
+    const std::string label = std::string(name) + " @" + std::to_string(nodes);
+    Test::Report(label.c_str(), value, unit);
+}
+}
+
+TEST_CASE(SlotMapReusesFreedSlotsOldestFirst)
+{
+    IntMap map;
+    const SlotHandle a = map.Emplace(0);
+    const SlotHandle b = map.Emplace(1);
+    const SlotHandle c = map.Emplace(2);
+    const SlotHandle d = map.Emplace(3);
+
+    map.Erase(c);
+    map.Erase(a);
+    map.Erase(d);
+    CHECK(IndexOf(map.Emplace(4)) == IndexOf(c));
+    CHECK(IndexOf(map.Emplace(5)) == IndexOf(a));
+    CHECK(IndexOf(map.Emplace(6)) == IndexOf(d));
+    CHECK(map.Capacity() == 4);
+
+    // The old handles stay stale, the untouched one stays valid
+    CHECK(!map.Contains(a) && !map.Contains(c) && !map.Contains(d));
+    CHECK(map.Get(b) != nullptr && *map.Get(b) == 1);
+}
+
+TEST_CASE(SlotMapRetiresExhaustedSlots)
+{
+    IntMap map;
+
+    // Cycle a single element until its slot runs out of generations
+    std::vector<SlotHandle> handles;
+    SlotHandle h = map.Emplace(0);
+    while (IndexOf(h) == 0)
+    {
+        handles.push_back(h);
+        map.Erase(h);
+        h = map.Emplace(static_cast<int>(handles.size()));
+    }
+
+    CHECK(handles.size() == IntMap::GenerationMask + 1);
+    CHECK(map.Capacity() == 2);
+    CHECK(map.Size() == 1);
+    for (SlotHandle stale : handles)
+        CHECK(!map.Contains(stale));
+    CHECK(std::set<SlotHandle>(std::begin(handles), std::end(handles)).size() == handles.size());
+    CHECK(std::find(std::begin(handles), std::end(handles), NullSlotHandle) == std::end(handles));
+}
+
+TEST_CASE(SlotMapStaleHandlesNeverResolve)
+{
+    IntMap map;
+    std::mt19937 rng(3);
+    std::vector<SlotHandle> live, erased;
+
+    // Heavy churn on a small map, so every slot goes through many generations
+    for (int i = 0; i < 64; ++i)
+        live.push_back(map.Emplace(i));
+    for (int i = 0; i < 200000; ++i)
+    {
+        const std::size_t victim = rng() % live.size();
+        CHECK(map.Erase(live[victim]));
+        erased.push_back(live[victim]);
+        live[victim] = map.Emplace(i);
+    }
+
+    std::size_t resolved = 0;
+    for (SlotHandle stale : erased)
+        resolved += map.Contains(stale);
+    CHECK(resolved == 0);
+    for (SlotHandle handle : live)
+        CHECK(map.Contains(handle));
+    CHECK(map.Size() == live.size());
+}
+
+BENCHMARK(SlotMapHandleStability)
+{
+    // Random erase and emplace pairs over a steady population, with a few free slots to spare
+    const std::size_t Live = 10000;
+    const std::size_t Spare = 2500;
+    const std::size_t Operations = 2000000;
+
+    IntMap map;
+    std::mt19937 rng(5);
+    std::vector<SlotHandle> live;
+    for (std::size_t i = 0; i < Live + Spare; ++i)
+        live.push_back(map.Emplace(static_cast<int>(i)));
+    for (std::size_t i = Live; i < Live + Spare; ++i)
+        map.Erase(live[i]);
+    live.resize(Live);
+
+    // Erasures between a slot being freed and reused, the window in which a stale handle is caught
+    std::vector<std::size_t> erasedAt(map.Capacity(), 0);
+    std::size_t minReuseDistance = std::numeric_limits<std::size_t>::max();
+
+    const long long start = MonotonicTimeNs();
+    for (std::size_t i = 1; i <= Operations; ++i)
+    {
+        const std::size_t victim = rng() % Live;
+        map.Erase(live[victim]);
+        if (IndexOf(live[victim]) < erasedAt.size())
+            erasedAt[IndexOf(live[victim])] = i;
+
+        live[victim] = map.Emplace(static_cast<int>(i));
+        const std::uint32_t index = IndexOf(live[victim]);
+        if (index < erasedAt.size() && erasedAt[index] != 0)
+            minReuseDistance = std::min(minReuseDistance, i - erasedAt[index]);
+    }
+    const long long elapsed = MonotonicTimeNs() - start;
+
+    Test::Report("erase + emplace", static_cast<double>(elapsed) / Operations, "ns");
+    Test::Report("min reuse distance", static_cast<double>(minReuseDistance), "erasures");
+    Test::Report("slots", static_cast<double>(map.Capacity()), "slots");
+}
+
+BENCHMARK(SlotMapSceneNodeAccess)
+{
+    // The node bank against the uuid keyed map of owned nodes it replaced
+    using NodeBank = SlotMap<SceneNode>;
+    using NodeMap  = std::map<std::string, std::unique_ptr<SceneNode>>;
+    const std::size_t Lookups = 1000000;
+    const std::size_t IteratedNodes = 10000000;
+
+    for (std::size_t nodes : { 10000u, 100000u, 1000000u })
+    {
+        std::mt19937 rng(7);
+        const std::vector<std::string> materials = { "material" };
+
+        NodeBank bank;
+        NodeMap map;
+        std::vector<SlotHandle> handles;
+        std::vector<std::string> uuids;
+        for (std::size_t i = 0; i < nodes; ++i)
+        {
+            const std::string uuid = RandomUuid(rng);
+            const SlotHandle handle = bank.Emplace("model", materials, uuid, Category::Normal, AABB());
+            bank.Get(handle)->SetTransformIndex(static_cast<std::uint32_t>(i));
+            auto it = map.emplace(uuid, std::make_unique<SceneNode>("model", materials, uuid, Category::Normal, AABB()));
+            it.first->second->SetTransformIndex(static_cast<std::uint32_t>(i));
+            handles.push_back(handle);
+            uuids.push_back(uuid);
+        }
+
+        // Full passes over all the nodes, as the per frame scene walks do
+        const std::size_t passes = std::max<std::size_t>(1, IteratedNodes / nodes);
+        std::uint64_t bankSum = 0, mapSum = 0;
+        long long start = MonotonicTimeNs();
+        for (std::size_t p = 0; p < passes; ++p)
+            for (const SceneNode& node : bank)
+                bankSum += node.GetTransformIndex();
+        long long bankNs = MonotonicTimeNs() - start;
+        start = MonotonicTimeNs();
+        for (std::size_t p = 0; p < passes; ++p)
+            for (const auto& entry : map)
+                mapSum += entry.second->GetTransformIndex();
+        long long mapNs = MonotonicTimeNs() - start;
+        CHECK(bankSum == mapSum);
+        ReportAt("iterate slot map", nodes, static_cast<double>(bankNs) / (passes * nodes), "ns/node");
+        ReportAt("iterate uuid map", nodes, static_cast<double>(mapNs) / (passes * nodes), "ns/node");
+
+        // Resolution of random nodes, by handle and by uuid
+        std::vector<std::size_t> order(Lookups);
+        for (std::size_t& i : order)
+            i = rng() % nodes;
+        bankSum = mapSum = 0;
+        start = MonotonicTimeNs();
+        for (std::size_t i : order)
+            bankSum += bank.Get(handles[i])->GetTransformIndex();
+        bankNs = MonotonicTimeNs() - start;
+        start = MonotonicTimeNs();
+        for (std::size_t i : order)
+            mapSum += map.find(uuids[i])->second->GetTransformIndex();
+        mapNs = MonotonicTimeNs() - start;
+        CHECK(bankSum == mapSum);
+        ReportAt("lookup slot map", nodes, static_cast<double>(bankNs) / Lookups, "ns/lookup");
+        ReportAt("lookup uuid map", nodes, static_cast<double>(mapNs) / Lookups, "ns/lookup");
+    }
+}
@@ -0,0 +1,80 @@
+/*********************************************************************************************************************/
+/*                                                  /===-_---~~~~~~~~~------____                                     */
+/*                                                 |===-~___                _,-'                                     */
+/*                  -==\\                         `//~\\   ~~~~`---.___.-~~                                          */
+/*              ______-==|                         | |  \\           _-~`                                            */
+/*        __--~~~  ,-/-==\\                        | |   `\        ,'                                                */
+/*     _-~       /'    |  \\                      / /      \      /                                                  */
+/*   .'        /       |   \\                   /' /        \   /'                                                   */
+/*  /  ____  /         |    \`\.__/-~~ ~ \ _ _/'  /          \/'                                                     */
+/* /-'~    ~~~~~---__  |     ~-/~         ( )   /'        _--~`                                                      */
+/*                   \_|      /        _)   ;  ),   __--~~                                                           */
+/*                     '~~--_/      _-~/-  / \   '-~ \                                                               */
+/*                    {\__--_/}    / \\_>- )<__\      \                                                              */
+/*                    /'   (_/  _-~  | |__>--<__|      |                                                             */
+/*                   |0  0 _/) )-~     | |__>--<__|     |                                                            */
+/*                   / /~ ,_/       / /__>---<__/      |                                                             */
+/*                  o o _//        /-~_>---<__-~      /                                                              */
+/*                  (^(~          /~_>---<__-      _-~                                                               */
+/*                 ,/|           /__>--<__/     _-~                                                                  */
+/*              ,//('(          |__>--<__|     /                  .----_                                             */
+/*             ( ( '))          |__>--<__|    |                 /' _---_~\                                           */
+/*          `-)) )) (           |__>--<__|    |               /'  /     ~\`\                                         */
+/*         ,/,'//( (             \__>--<__\    \            /'  //        ||                                         */
+/*       ,( ( ((, ))              ~-__>--<_~-_  ~--____---~' _/'/        /'                                          */
+/*     `~/  )` ) ,/|                 ~-_~>--<_/-__       __-~ _/                                                     */
+/*   ._-~//( )/ )) `                    ~~-'_/_/ /~~~~~~~__--~                                                       */
+/*    ;'( ')/ ,)(                              ~~~~~~~~~~                                                            */
+/*   ' ') '( (/                                                                                                      */
+/*     '   '  `                                                                                                      */
+/*********************************************************************************************************************/
+#ifndef _TEST_HPP_
+#define _TEST_HPP_
+
+#include <vector>
+
+namespace Test
+{
+// A registered test or benchmark
+struct Case
+{
+    const char* name;
+    void (*fn)();
+};
+
+// The registered tests, run by default
+std::vector<Case>& Tests();
+
+// The registered benchmarks, run with --bench
+std::vector<Case>& Benchmarks();
+
+// Registers a case at static initialization
+struct Registrar
+{
+    Registrar(std::vector<Case>& cases, const char* name, void (*fn)());
+};
+
+// Records a failed check of the running test
+void Fail(const char* file, int line, const char* expr);
+
+// Prints a benchmark result line
+void Report(const char* name, double value, const char* unit);
+}
+
+// Defines and registers a test
+#define TEST_CASE(name) \
+    static void name(); \
+    static Test::Registrar name##Registrar(Test::Tests(), #name, &name); \
+    static void name()
+
+// Defines and registers a benchmark
+#define BENCHMARK(name) \
+    static void name(); \
+    static Test::Registrar name##Registrar(Test::Benchmarks(), #name, &name); \
+    static void name()
+
+// Fails the running test without stopping it when expr is false
+#define CHECK(expr) \
+    do { if (!(expr)) Test::Fail(__FILE__, __LINE__, #expr); } while (0)
+
+#endif // ! _TEST_HPP_